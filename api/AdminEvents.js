@@ -39,13 +39,13 @@ class AdminEvents {
       timestamp: new Date(),
     };
 
-    const clients = Array.from(this.events.connectedClients.values()).filter(
-      client => client.userType === 'admin' && client.userId !== adminUserId
-    );
-
-    clients.forEach(client => {
-      client.socket.emit('admin:action:performed', eventData);
-    });
+    const adminSocketIds = this.events.clientsByType.get('admin') || [];
+    for (const socketId of adminSocketIds) {
+      const client = this.events.connectedClients.get(socketId);
+      if (client && client.userId !== adminUserId) {
+        client.socket.emit('admin:action:performed', eventData);
+      }
+    }
 
     if (
       ['user_deleted', 'user_promoted', 'user_demoted', 'module_force_disconnect'].includes(action)
@@ -9,6 +9,17 @@
  */
 
 const Logger = require('../utils/logger');
+const UserEventLog = require('../utils/UserEventLog');
+
+/**
+ * Cadence d'émission des statistiques simples aux administrateurs
+ * debounceMs regroupe les rafales, minIntervalMs plafonne le débit d'émission
+ * @constant {Object}
+ */
+const STATS_EMIT = {
+  debounceMs: 200,
+  minIntervalMs: 1000,
+};
 
 /**
  * Gestionnaire central des événements WebSocket
@@ -33,6 +44,48 @@ class EventsManager {
      */
     this.connectedClients = new Map();
 
+    /**
+     * Index secondaire des sockets par utilisateur
+     * @type {Map<string, Set<string>>} String(userId) -> Set<socketId>
+     */
+    this.clientsByUser = new Map();
+
+    /**
+     * Index secondaire des sockets par type d'utilisateur
+     * @type {Map<string, Set<string>>} userType -> Set<socketId>
+     */
+    this.clientsByType = new Map();
+
+    /**
+     * Index secondaire des sockets par page courante
+     * @type {Map<string, Set<string>>} page -> Set<socketId>
+     */
+    this.clientsByPage = new Map();
+
+    /**
+     * Compteur de modules ESP32 connectés (fourni par ModuleEvents)
+     * @type {Function} () => {connected, online}
+     */
+    this.moduleCounter = () => ({ connected: 0, online: 0 });
+
+    /**
+     * Timer de la prochaine émission de statistiques (null si aucune programmée)
+     * @type {NodeJS.Timeout|null}
+     */
+    this.statsTimer = null;
+
+    /**
+     * Horodatage et contenu de la dernière émission de statistiques
+     * @type {Object}
+     */
+    this.lastStatsEmit = { at: 0, users: -1, modules: -1 };
+
+    /**
+     * Journal séquencé des événements émis à chaque utilisateur (reprise après reconnexion)
+     * @type {UserEventLog}
+     */
+    this.eventLog = new UserEventLog();
+
     /**
      * Logger pour les opérations
      * @type {Logger}
@@ -52,9 +105,12 @@ class EventsManager {
    * @param {string} [page='unknown'] - Page actuelle (modules, admin, dashboard)
    */
   registerClient(socket, userId, userType = 'user', page = 'unknown') {
-    const existingClients = Array.from(this.connectedClients.values()).filter(
-      client => client.userId === userId
-    );
+    // Un même socket peut se ré-authentifier : retirer d'abord ses anciennes entrées d'index
+    if (this.connectedClients.has(socket.id)) {
+      this._removeClient(socket.id);
+    }
+
+    const existingClients = this.getUserClients(userId);
 
     if (existingClients.length > 0) {
       Logger.activity.warn(
@@ -71,7 +127,7 @@ class EventsManager {
             newSocketId: socket.id,
           });
           existingClient.socket.disconnect();
-          this.connectedClients.delete(existingClient.socket.id);
+          this._removeClient(existingClient.socket.id);
         }
       });
     }
@@ -83,10 +139,56 @@ class EventsManager {
       page,
       connectedAt: new Date(),
     });
+    this._indexAdd(this.clientsByUser, String(userId), socket.id);
+    this._indexAdd(this.clientsByType, userType, socket.id);
+    this._indexAdd(this.clientsByPage, page, socket.id);
 
     Logger.activity.debug(
       `Client registered: ${socket.id} (User ${userId}, Type: ${userType}, Page: ${page})`
     );
+
+    this._resumeEvents(socket, userId);
+  }
+
+  /**
+   * Reprend le flux d'événements d'un client qui se reconnecte
+   * La position présentée dans la poignée de main (auth.eventResume) permet de renvoyer
+   * uniquement les événements manqués ; sinon le client recharge un instantané complet.
+   * Le rejeu est réservé aux sessions express vérifiées : un userId simplement déclaré par
+   * le client (client:authenticate) ne donne pas accès à l'historique de cet utilisateur.
+   * Exécuté dans la même itération que l'enregistrement : aucun événement en direct ne
+   * peut s'intercaler avant la fin du rattrapage.
+   * @param {Socket} socket - Client Socket.io
+   * @param {number} userId - Identifiant de l'utilisateur
+   * @private
+   */
+  _resumeEvents(socket, userId) {
+    if (socket.eventResumeMode) return;
+
+    const verified =
+      socket.userData?.sessionVerified && String(socket.userData.userId) === String(userId);
+    const resume = verified ? socket.handshake?.auth?.eventResume : null;
+    const missed = resume ? this.eventLog.since(userId, resume.epoch, resume.seq) : null;
+
+    if (missed) {
+      for (const entry of missed) {
+        socket.emit(entry.event, { ...entry.data, eventSeq: entry.seq });
+      }
+    }
+
+    socket.eventResumeMode = missed ? 'delta' : 'snapshot';
+    socket.emit('events:resume', {
+      ...this.eventLog.position(userId),
+      mode: socket.eventResumeMode,
+      replayed: missed ? missed.length : 0,
+    });
+
+    if (resume) {
+      Logger.activity.debug(
+        `Event resume for user ${userId}: ${socket.eventResumeMode}` +
+          (missed ? ` (${missed.length} replayed)` : '')
+      );
+    }
   }
 
   /**
@@ -97,8 +199,118 @@ class EventsManager {
     const client = this.connectedClients.get(socketId);
     if (client) {
       Logger.activity.debug(`Client désenregistré : ${socketId} (Utilisateur ${client.userId})`);
-      this.connectedClients.delete(socketId);
+      this._removeClient(socketId);
+    }
+  }
+
+  /**
+   * Met à jour la page courante d'un client et son index
+   * @param {string} socketId - Identifiant du socket
+   * @param {string} page - Nouvelle page (modules, admin, dashboard)
+   * @returns {string|null} Ancienne page ou null si client inconnu
+   */
+  setClientPage(socketId, page) {
+    const client = this.connectedClients.get(socketId);
+    if (!client) return null;
+
+    const oldPage = client.page;
+    if (oldPage !== page) {
+      this._indexRemove(this.clientsByPage, oldPage, socketId);
+      this._indexAdd(this.clientsByPage, page, socketId);
+      client.page = page;
+    }
+    return oldPage;
+  }
+
+  /**
+   * Récupère les clients connectés d'un utilisateur via l'index
+   * @param {number|string} userId - Identifiant de l'utilisateur
+   * @returns {Object[]} Clients de l'utilisateur
+   */
+  getUserClients(userId) {
+    return this._resolve(this.clientsByUser.get(String(userId)));
+  }
+
+  /**
+   * Retire un client de la table principale et de tous les index
+   * @param {string} socketId - Identifiant du socket
+   * @private
+   */
+  _removeClient(socketId) {
+    const client = this.connectedClients.get(socketId);
+    if (!client) return;
+
+    this._indexRemove(this.clientsByUser, String(client.userId), socketId);
+    this._indexRemove(this.clientsByType, client.userType, socketId);
+    this._indexRemove(this.clientsByPage, client.page, socketId);
+    this.connectedClients.delete(socketId);
+  }
+
+  /**
+   * Ajoute un socket à une entrée d'index
+   * @param {Map<string, Set<string>>} index - Index cible
+   * @param {string} key - Clé d'index
+   * @param {string} socketId - Identifiant du socket
+   * @private
+   */
+  _indexAdd(index, key, socketId) {
+    let bucket = index.get(key);
+    if (!bucket) {
+      bucket = new Set();
+      index.set(key, bucket);
+    }
+    bucket.add(socketId);
+  }
+
+  /**
+   * Retire un socket d'une entrée d'index (supprime l'entrée si vide)
+   * @param {Map<string, Set<string>>} index - Index cible
+   * @param {string} key - Clé d'index
+   * @param {string} socketId - Identifiant du socket
+   * @private
+   */
+  _indexRemove(index, key, socketId) {
+    const bucket = index.get(key);
+    if (!bucket) return;
+    bucket.delete(socketId);
+    if (bucket.size === 0) index.delete(key);
+  }
+
+  /**
+   * Convertit un ensemble de socketIds en clients enregistrés
+   * @param {Set<string>|undefined} socketIds - Sockets issus d'un index
+   * @returns {Object[]} Clients correspondants
+   * @private
+   */
+  _resolve(socketIds) {
+    const clients = [];
+    if (!socketIds) return clients;
+    for (const socketId of socketIds) {
+      const client = this.connectedClients.get(socketId);
+      if (client) clients.push(client);
+    }
+    return clients;
+  }
+
+  /**
+   * Émet un événement vers les sockets d'une entrée d'index
+   * @param {Set<string>|undefined} socketIds - Sockets issus d'un index
+   * @param {string} event - Nom de l'événement
+   * @param {Object} data - Données à envoyer
+   * @returns {number} Nombre de clients atteints
+   * @private
+   */
+  _emitToSet(socketIds, event, data) {
+    if (!socketIds) return 0;
+    let count = 0;
+    for (const socketId of socketIds) {
+      const client = this.connectedClients.get(socketId);
+      if (client) {
+        client.socket.emit(event, data);
+        count++;
+      }
     }
+    return count;
   }
 
   // ========================================================================
@@ -122,41 +334,36 @@ class EventsManager {
    * @param {Object} data - Données à envoyer
    */
   emitToUser(userId, event, data) {
-    const clients = Array.from(this.connectedClients.values()).filter(
-      client => client.userId === userId
-    );
-
-    clients.forEach(client => {
-      client.socket.emit(event, data);
-    });
+    const count = this._emitToSet(this.clientsByUser.get(String(userId)), event, data);
 
-    if (clients.length > 0) {
-      Logger.system.debug(
-        `Émission '${event}' vers utilisateur ${userId} (${clients.length} clients)`
-      );
+    if (count > 0) {
+      Logger.system.debug(`Émission '${event}' vers utilisateur ${userId} (${count} clients)`);
     }
   }
 
+  /**
+   * Émet un événement séquencé à un utilisateur
+   * L'événement est conservé dans le journal de l'utilisateur et porte sa séquence
+   * (eventSeq) pour être rejoué aux clients qui se reconnectent après l'avoir manqué
+   * @param {number} userId - Identifiant de l'utilisateur
+   * @param {string} event - Nom de l'événement
+   * @param {Object} data - Données à envoyer
+   */
+  emitSequencedToUser(userId, event, data) {
+    const eventSeq = this.eventLog.append(userId, event, data);
+    this.emitToUser(userId, event, { ...data, eventSeq });
+  }
+
   /**
    * Émet un événement à tous les administrateurs
    * @param {string} event - Nom de l'événement
    * @param {Object} data - Données à envoyer
    */
   emitToAdmins(event, data) {
-    const adminClients = Array.from(this.connectedClients.values()).filter(
-      client => client.userType === 'admin'
-    );
-
-    adminClients.forEach(client => {
-      client.socket.emit(event, data);
-    });
+    const count = this._emitToSet(this.clientsByType.get('admin'), event, data);
 
-    if (adminClients.length > 0) {
-      if (event.includes('telemetry') || event.includes('last_seen')) {
-        Logger.system.debug(`Émission '${event}' vers ${adminClients.length} admin(s)`);
-      } else {
-        Logger.system.debug(`Émission '${event}' vers ${adminClients.length} admin(s)`);
-      }
+    if (count > 0) {
+      Logger.system.debug(`Émission '${event}' vers ${count} admin(s)`);
     }
   }
 
@@ -167,18 +374,10 @@ class EventsManager {
    * @param {Object} data - Données à envoyer
    */
   emitToPage(page, event, data) {
-    const pageClients = Array.from(this.connectedClients.values()).filter(
-      client => client.page === page
-    );
-
-    pageClients.forEach(client => {
-      client.socket.emit(event, data);
-    });
+    const count = this._emitToSet(this.clientsByPage.get(page), event, data);
 
-    if (pageClients.length > 0) {
-      Logger.system.debug(
-        `Émission '${event}' vers page '${page}' (${pageClients.length} clients)`
-      );
+    if (count > 0) {
+      Logger.system.debug(`Émission '${event}' vers page '${page}' (${count} clients)`);
     }
   }
 
@@ -186,6 +385,70 @@ class EventsManager {
   // STATISTIQUES
   // ========================================================================
 
+  /**
+   * Définit la source du nombre de modules connectés
+   * @param {Function} counter - () => {connected, online}
+   */
+  setModuleCounter(counter) {
+    this.moduleCounter = counter;
+  }
+
+  /**
+   * Récupère les statistiques simples en O(1) depuis les agrégats maintenus
+   * @returns {Object} {users: {online}, modules: {online}, timestamp}
+   */
+  getSimpleStats() {
+    return {
+      users: { online: this.clientsByUser.size },
+      modules: { online: this.moduleCounter().connected },
+      timestamp: new Date(),
+    };
+  }
+
+  /**
+   * Programme l'émission des statistiques simples aux administrateurs
+   * Un seul timer à la fois : les appels en rafale sont regroupés et le débit est plafonné
+   * @returns {void}
+   */
+  scheduleStatsEmit() {
+    if (this.statsTimer) return;
+
+    const wait = Math.max(
+      STATS_EMIT.debounceMs,
+      this.lastStatsEmit.at + STATS_EMIT.minIntervalMs - Date.now()
+    );
+    this.statsTimer = setTimeout(() => this._emitStats(), wait);
+  }
+
+  /**
+   * Émet les statistiques simples aux administrateurs si elles ont changé
+   * @private
+   */
+  _emitStats() {
+    this.statsTimer = null;
+
+    try {
+      const simpleStats = this.getSimpleStats();
+      const users = simpleStats.users.online;
+      const modules = simpleStats.modules.online;
+
+      if (users === this.lastStatsEmit.users && modules === this.lastStatsEmit.modules) {
+        return;
+      }
+      this.lastStatsEmit = { at: Date.now(), users, modules };
+
+      this.emitToAdmins('simple_stats_update', simpleStats);
+      Logger.system.statsIfChanged(`📊 Connected - ${users} user(s), ${modules} ESP module(s)`, {
+        users,
+        modules,
+        clients: this.connectedClients.size,
+        esp: this.moduleCounter().online,
+      });
+    } catch (error) {
+      Logger.system.error('Erreur émission stats :', error);
+    }
+  }
+
   /**
    * Récupère les statistiques de connexion
    * @returns {Object} Statistiques détaillées des connexions
@@ -197,23 +460,20 @@ class EventsManager {
   getStats() {
     const clientsByPage = {};
     const clientsByType = {};
-    const uniqueUsers = new Set();
-
-    this.connectedClients.forEach(client => {
-      if (!clientsByPage[client.page]) clientsByPage[client.page] = 0;
-      clientsByPage[client.page]++;
 
-      if (!clientsByType[client.userType]) clientsByType[client.userType] = 0;
-      clientsByType[client.userType]++;
-
-      uniqueUsers.add(client.userId);
+    this.clientsByPage.forEach((socketIds, page) => {
+      clientsByPage[page] = socketIds.size;
+    });
+    this.clientsByType.forEach((socketIds, userType) => {
+      clientsByType[userType] = socketIds.size;
     });
 
     return {
       total: this.connectedClients.size,
-      uniqueUsers: uniqueUsers.size,
+      uniqueUsers: this.clientsByUser.size,
       byPage: clientsByPage,
       byType: clientsByType,
+      eventLog: this.eventLog.getStats(),
     };
   }
 }
@@ -232,6 +492,7 @@ class EventsManager {
  *
  * // Émettre des événements ciblés
  * events.emitToUser(123, 'notification', { message: 'Hello!' });
+ * events.emitSequencedToUser(123, 'user:module:online', { moduleId: 'MC-0001-ST' });
  * events.emitToAdmins('system:alert', { level: 'warning', message: 'Alerte' });
  * events.emitToPage('modules', 'module:update', moduleData);
  */
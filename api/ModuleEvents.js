@@ -9,6 +9,40 @@
  */
 
 const Logger = require('../utils/logger');
+const BoundedCache = require('../utils/BoundedCache');
+const TelemetrySummary = require('../utils/TelemetrySummary');
+
+/**
+ * Limites du cache d'état des modules
+ * Les modules en ligne n'expirent pas et ne sont jamais évincés ; les états hors ligne sont
+ * oubliés après offlineTtlMs, ou évincés les premiers quand une limite est atteinte
+ * @constant {Object}
+ */
+const MODULE_STATE_CACHE = {
+  maxEntries: 10000,
+  maxBytes: 16 * 1024 * 1024,
+  offlineTtlMs: 60 * 60 * 1000,
+  pruneIntervalMs: 5 * 60 * 1000,
+};
+
+/**
+ * Paramètres du digest de dernière activité
+ * Un module n'apparaît dans un digest que si son lastSeen a changé de tranche (bucketMs)
+ * @constant {Object}
+ */
+const LAST_SEEN_DIGEST = {
+  intervalMs: 5000,
+  bucketMs: 10000,
+};
+
+/**
+ * Conservation des derniers résumés de télémétrie par module
+ * @constant {Object}
+ */
+const TELEMETRY_SUMMARY_CACHE = {
+  maxEntries: 10000,
+  ttlMs: 60 * 60 * 1000,
+};
 
 /**
  * Gestionnaire d'événements pour les modules IoT MicroCoaster
@@ -34,10 +68,56 @@ class ModuleEvents {
     this.Logger = Logger;
 
     /**
-     * États actuels de tous les modules
-     * @type {Map<string, Object>} moduleId -> {online, lastSeen, moduleInfo}
+     * États actuels des modules (cache borné, états hors ligne expirés)
+     * @type {BoundedCache} moduleId -> {online, lastSeen, moduleInfo}
+     */
+    this.moduleStates = new BoundedCache({
+      name: 'moduleStates',
+      maxEntries: MODULE_STATE_CACHE.maxEntries,
+      maxBytes: MODULE_STATE_CACHE.maxBytes,
+      isPinned: state => state.online,
+      onEvict: (moduleId, state) => {
+        if (state.online) this.onlineCount--;
+      },
+    }).startPruning(MODULE_STATE_CACHE.pruneIntervalMs);
+
+    /**
+     * Nombre de modules en ligne, maintenu à chaque transition d'état
+     * @type {number}
+     */
+    this.onlineCount = 0;
+
+    /**
+     * Dernier résumé statistique de télémétrie reçu de chaque module
+     * @type {BoundedCache} moduleId -> {intervalMs, metrics: {name -> résumé}, receivedAt}
      */
-    this.moduleStates = new Map();
+    this.telemetrySummaries = new BoundedCache({
+      name: 'telemetrySummaries',
+      maxEntries: TELEMETRY_SUMMARY_CACHE.maxEntries,
+      ttlMs: TELEMETRY_SUMMARY_CACHE.ttlMs,
+    });
+
+    /**
+     * Dernières activités en attente du prochain digest
+     * @type {Map<string, Object>} moduleId -> {lastSeen, userId}
+     */
+    this.pendingLastSeen = new Map();
+
+    /**
+     * Dernière tranche de lastSeen diffusée par module
+     * @type {BoundedCache} moduleId -> bucket
+     */
+    this.lastSeenBuckets = new BoundedCache({
+      name: 'lastSeenBuckets',
+      maxEntries: MODULE_STATE_CACHE.maxEntries,
+      ttlMs: MODULE_STATE_CACHE.offlineTtlMs,
+    });
+
+    /**
+     * Timer du prochain digest (null si aucun digest programmé)
+     * @type {NodeJS.Timeout|null}
+     */
+    this.lastSeenDigestTimer = null;
 
     /**
      * Connexions ESP32 actives
@@ -50,6 +130,11 @@ class ModuleEvents {
      * @type {Map<string, Object>} socket.id -> {moduleId, userId, ...}
      */
     this.modulesBySocket = new Map();
+
+    this.events.setModuleCounter(() => ({
+      connected: this.connectedESPs.size,
+      online: this.onlineCount,
+    }));
   }
 
   /**
@@ -65,15 +150,20 @@ class ModuleEvents {
     const wasOnline = previousState?.online || false;
     const currentTime = new Date();
 
-    this.moduleStates.set(moduleId, {
-      ...previousState,
-      online: true,
-      lastSeen: currentTime,
-      moduleInfo,
-    });
+    this.moduleStates.set(
+      moduleId,
+      {
+        ...previousState,
+        online: true,
+        lastSeen: currentTime,
+        moduleInfo,
+      },
+      0
+    );
 
     // Notifier uniquement si le module n'était pas déjà en ligne (changement d'état)
     if (!wasOnline) {
+      this.onlineCount++;
       Logger.modules.info(`[ModuleEvents] Module ${moduleId} maintenant EN LIGNE`);
 
       // Préparer les données d'événement
@@ -81,7 +171,6 @@ class ModuleEvents {
         moduleId,
         online: true,
         lastSeen: currentTime,
-        lastSeenFormatted: currentTime.toLocaleString('fr-FR'),
         ...moduleInfo,
       };
 
@@ -91,7 +180,8 @@ class ModuleEvents {
 
       // Notifier le propriétaire du module si défini
       if (moduleInfo.userId) {
-        this.events.emitToUser(moduleInfo.userId, 'user:module:online', eventData);
+        this.events.emitSequencedToUser(moduleInfo.userId, 'user:module:online', eventData);
+        this.emitUserStatsDelta(moduleInfo.userId, { onlineModules: 1, offlineModules: -1 });
       }
 
       // Mettre à jour les statistiques pour les admins
@@ -113,22 +203,26 @@ class ModuleEvents {
     const wasOnline = previousState?.online || false;
     const currentTime = new Date();
 
-    this.moduleStates.set(moduleId, {
-      ...previousState,
-      online: false,
-      lastSeen: currentTime,
-      moduleInfo,
-    });
+    this.moduleStates.set(
+      moduleId,
+      {
+        ...previousState,
+        online: false,
+        lastSeen: currentTime,
+        moduleInfo,
+      },
+      MODULE_STATE_CACHE.offlineTtlMs
+    );
 
     // Notifier uniquement si le module était en ligne (changement d'état)
     if (wasOnline) {
+      this.onlineCount--;
       Logger.modules.info(`[ModuleEvents] Module ${moduleId} maintenant HORS LIGNE`);
 
       const eventData = {
         moduleId,
         online: false,
         lastSeen: currentTime,
-        lastSeenFormatted: currentTime.toLocaleString('fr-FR'),
         ...moduleInfo,
       };
 
@@ -136,7 +230,8 @@ class ModuleEvents {
       this.events.emitToAdmins('rt_module_offline', eventData);
 
       if (moduleInfo.userId) {
-        this.events.emitToUser(moduleInfo.userId, 'user:module:offline', eventData);
+        this.events.emitSequencedToUser(moduleInfo.userId, 'user:module:offline', eventData);
+        this.emitUserStatsDelta(moduleInfo.userId, { onlineModules: -1, offlineModules: 1 });
       }
 
       this.emitStatsToAdmins();
@@ -145,6 +240,23 @@ class ModuleEvents {
     this.emitLastSeenUpdate(moduleId, currentTime, moduleInfo);
   }
 
+  /**
+   * Pousse une variation des statistiques du dashboard au propriétaire d'un module
+   * Émis uniquement sur changement de présence ou d'état : le coût serveur suit les
+   * changements, pas le nombre d'onglets ouverts. resync demande un rechargement
+   * conditionnel (ETag) quand la variation exacte n'est pas connue ici.
+   * @param {number} userId - ID de l'utilisateur propriétaire
+   * @param {Object} delta - Variations {totalModules, onlineModules, offlineModules, moduleTypes}
+   * @param {boolean} [delta.resync] - Statistiques à recharger via /dashboard/stats
+   * @returns {void}
+   */
+  emitUserStatsDelta(userId, delta) {
+    this.events.emitSequencedToUser(userId, 'user:stats:delta', {
+      ...delta,
+      timestamp: new Date(),
+    });
+  }
+
   // ================================================================================
   // GESTION DU CYCLE DE VIE DES MODULES
   // ================================================================================
@@ -167,7 +279,12 @@ class ModuleEvents {
     };
 
     if (moduleData.userId) {
-      this.events.emitToUser(moduleData.userId, 'user:module:added', eventData);
+      this.events.emitSequencedToUser(moduleData.userId, 'user:module:added', eventData);
+      this.emitUserStatsDelta(moduleData.userId, {
+        totalModules: 1,
+        offlineModules: 1,
+        moduleTypes: { [moduleData.type || 'Unknown']: 1 },
+      });
     }
 
     this.events.emitToAdmins('rt_module_added', eventData);
@@ -190,11 +307,16 @@ class ModuleEvents {
     };
 
     // Nettoyer le cache d'état du module
+    if (this.moduleStates.get(moduleData.module_id)?.online) this.onlineCount--;
     this.moduleStates.delete(moduleData.module_id);
+    this.lastSeenBuckets.delete(moduleData.module_id);
+    this.pendingLastSeen.delete(moduleData.module_id);
+    this.telemetrySummaries.delete(moduleData.module_id);
 
-    // Notifier le propriétaire du module
+    // Notifier le propriétaire du module ; type et statut retenus par les stats inconnus ici
     if (moduleData.userId) {
-      this.events.emitToUser(moduleData.userId, 'user:module:removed', eventData);
+      this.events.emitSequencedToUser(moduleData.userId, 'user:module:removed', eventData);
+      this.emitUserStatsDelta(moduleData.userId, { resync: true });
     }
 
     // Notifier tous les administrateurs
@@ -221,9 +343,10 @@ class ModuleEvents {
       timestamp: new Date(),
     };
 
-    // Notifier le propriétaire du module
+    // Notifier le propriétaire du module (un changement de type déplace les compteurs par type)
     if (moduleData.userId) {
-      this.events.emitToUser(moduleData.userId, 'user:module:updated', eventData);
+      this.events.emitSequencedToUser(moduleData.userId, 'user:module:updated', eventData);
+      this.emitUserStatsDelta(moduleData.userId, { resync: true });
     }
 
     // Notifier tous les administrateurs
@@ -251,12 +374,13 @@ class ModuleEvents {
     if (state) {
       state.telemetry = telemetryData;
       state.lastSeen = currentTime;
+      // Réinsertion pour recalculer la taille estimée et rafraîchir la position LRU
+      this.moduleStates.set(moduleId, state, state.online ? 0 : MODULE_STATE_CACHE.offlineTtlMs);
     }
     const eventData = {
       moduleId,
       telemetry: telemetryData,
       lastSeen: currentTime,
-      lastSeenFormatted: currentTime.toLocaleString('fr-FR'),
       timestamp: currentTime,
     };
 
@@ -266,6 +390,61 @@ class ModuleEvents {
     this.emitLastSeenUpdate(moduleId, currentTime, moduleInfo);
   }
 
+  /**
+   * Enregistre le résumé statistique d'un intervalle de télémétrie
+   * @param {string} moduleId - Identifiant unique du module
+   * @param {Object} summary - Résumé filaire {intervalMs, <métrique>: {n, min, max, sum, sq, h}}
+   * @returns {Object|null} Statistiques lisibles par métrique, ou null si résumé absent/invalide
+   */
+  recordTelemetrySummary(moduleId, summary) {
+    if (!summary || typeof summary !== 'object') return null;
+
+    const metrics = {};
+    const described = {};
+    for (const [name, wire] of Object.entries(summary)) {
+      const decoded = TelemetrySummary.fromWire(wire);
+      if (decoded) {
+        metrics[name] = decoded;
+        described[name] = TelemetrySummary.describe(decoded);
+      }
+    }
+
+    if (Object.keys(metrics).length === 0) return null;
+
+    this.telemetrySummaries.set(moduleId, {
+      intervalMs: Number(summary.intervalMs) || 0,
+      metrics,
+      receivedAt: Date.now(),
+    });
+    return described;
+  }
+
+  /**
+   * Agrège les derniers résumés de télémétrie de tous les modules
+   * Chaque fusion est de coût constant (compteurs et histogramme de taille fixe)
+   * @returns {Object} {modules, metrics: {name -> {count, min, max, mean, stddev, p50, p90, p99}}}
+   */
+  getFleetTelemetry() {
+    const merged = {};
+    let modules = 0;
+
+    for (const entry of this.telemetrySummaries.values()) {
+      modules++;
+      for (const [name, summary] of Object.entries(entry.metrics)) {
+        merged[name] = TelemetrySummary.mergeSummary(
+          merged[name] || TelemetrySummary.createSummary(),
+          summary
+        );
+      }
+    }
+
+    const metrics = {};
+    for (const [name, summary] of Object.entries(merged)) {
+      metrics[name] = TelemetrySummary.describe(summary);
+    }
+    return { modules, metrics };
+  }
+
   // ================================================================================
   // SUIVI DES COMMANDES
   // ================================================================================
@@ -284,7 +463,7 @@ class ModuleEvents {
       timestamp: new Date(),
     };
 
-    this.events.emitToUser(userId, 'user:command:sent', eventData);
+    this.events.emitSequencedToUser(userId, 'user:command:sent', eventData);
     this.events.emitToAdmins('admin:command:sent', eventData);
   }
 
@@ -410,12 +589,14 @@ class ModuleEvents {
    * @returns {number} returns.connectedModules - Nombre de modules connectés
    * @returns {number} returns.totalStates - Nombre total d'états en cache
    * @returns {number} returns.onlineModules - Nombre de modules en ligne
+   * @returns {Object} returns.stateCache - Métriques du cache d'états (taille, évictions...)
    */
   getConnectionStats() {
     return {
       connectedModules: this.connectedESPs.size,
       totalStates: this.moduleStates.size,
-      onlineModules: Array.from(this.moduleStates.values()).filter(state => state.online).length,
+      onlineModules: this.onlineCount,
+      stateCache: this.moduleStates.getStats(),
     };
   }
 
@@ -445,59 +626,75 @@ class ModuleEvents {
   }
 
   /**
-   * Émet une mise à jour du "dernière activité" d'un module
+   * Enregistre une mise à jour de "dernière activité" pour le prochain digest
+   * Les mises à jour restant dans la même tranche que la dernière diffusion sont ignorées
    * @param {string} moduleId - Identifiant unique du module
    * @param {Date} lastSeen - Horodatage de la dernière activité
    * @param {Object} [moduleInfo={}] - Informations supplémentaires du module
    */
   emitLastSeenUpdate(moduleId, lastSeen, moduleInfo = {}) {
-    const eventData = {
-      moduleId,
-      lastSeen,
-      lastSeenFormatted: lastSeen.toLocaleString('fr-FR'),
-      timestamp: lastSeen,
-      ...moduleInfo,
-    };
+    const lastSeenMs = lastSeen.getTime();
+    const bucket = Math.floor(lastSeenMs / LAST_SEEN_DIGEST.bucketMs);
+
+    if (!this.pendingLastSeen.has(moduleId) && this.lastSeenBuckets.get(moduleId) === bucket) {
+      return;
+    }
 
-    this.events.emitToAdmins('rt_module_last_seen_updated', eventData);
+    this.pendingLastSeen.set(moduleId, { lastSeen: lastSeenMs, userId: moduleInfo.userId });
 
-    if (moduleInfo.userId) {
-      this.events.emitToUser(moduleInfo.userId, 'user:module:last_seen_updated', eventData);
+    if (!this.lastSeenDigestTimer) {
+      this.lastSeenDigestTimer = setTimeout(
+        () => this.flushLastSeenDigest(),
+        LAST_SEEN_DIGEST.intervalMs
+      );
     }
-    Logger.esp.debug(`LastSeen updated for module ${moduleId}`, {
-      moduleId,
-      lastSeen: lastSeen.toISOString(),
-      lastSeenFormatted: lastSeen.toLocaleString('fr-FR'),
-      ...moduleInfo,
+  }
+
+  /**
+   * Diffuse le digest des dernières activités en attente
+   * Les admins reçoivent tout le digest, chaque propriétaire uniquement ses modules.
+   * Les dates sont envoyées en ms epoch : le formatage est fait côté client.
+   * @returns {number} Nombre de modules diffusés
+   */
+  flushLastSeenDigest() {
+    this.lastSeenDigestTimer = null;
+    if (this.pendingLastSeen.size === 0) return 0;
+
+    const modules = [];
+    const modulesByUser = new Map();
+
+    for (const [moduleId, { lastSeen, userId }] of this.pendingLastSeen) {
+      const entry = { moduleId, lastSeen };
+      modules.push(entry);
+      this.lastSeenBuckets.set(moduleId, Math.floor(lastSeen / LAST_SEEN_DIGEST.bucketMs));
+
+      if (userId) {
+        if (!modulesByUser.has(userId)) modulesByUser.set(userId, []);
+        modulesByUser.get(userId).push(entry);
+      }
+    }
+    this.pendingLastSeen.clear();
+
+    const timestamp = Date.now();
+    this.events.emitToAdmins('rt_modules_last_seen_digest', { modules, timestamp });
+    modulesByUser.forEach((userModules, userId) => {
+      this.events.emitToUser(userId, 'user:modules:last_seen_digest', {
+        modules: userModules,
+        timestamp,
+      });
     });
+
+    Logger.esp.debug(`LastSeen digest: ${modules.length} module(s)`);
+    return modules.length;
   }
 
   /**
-   * Émet les statistiques mises à jour aux administrateurs
-   * @description Utilise la même logique que le gestionnaire request_stats
+   * Demande l'émission des statistiques mises à jour aux administrateurs
+   * @description Passe par l'émetteur unique et temporisé d'EventsManager
    * @private
    */
   emitStatsToAdmins() {
-    setTimeout(() => {
-      try {
-        const clientStats = this.events.getStats();
-        const moduleStats = this.getConnectionStats();
-
-        // Format simple et direct, comme le gestionnaire request_stats
-        const simpleStats = {
-          users: { online: clientStats.uniqueUsers },
-          modules: { online: moduleStats.connectedModules },
-          timestamp: new Date(),
-        };
-
-        this.events.emitToAdmins('simple_stats_update', simpleStats);
-        Logger.system.debug(
-          `[ModuleEvents] Stats mises à jour émises: ${clientStats.uniqueUsers} utilisateurs, ${moduleStats.connectedModules} modules`
-        );
-      } catch (error) {
-        Logger.modules.error('[ModuleEvents] Erreur émission stats :', error);
-      }
-    }, 200); // Délai pour éviter les appels trop fréquents
+    this.events.scheduleStatsEmit();
   }
 
   // ================================================================================
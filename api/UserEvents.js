@@ -160,31 +160,10 @@ class UserEvents {
   }
 
   /**
-   * Emit updated stats to admins
+   * Request a stats update for admins (debounced by EventsManager)
    */
   emitStatsToAdmins() {
-    setTimeout(() => {
-      try {
-        const clientStats = this.events.getStats();
-        const realTimeAPI = this.events.io?.app?.locals?.realTimeAPI;
-        const moduleStats = realTimeAPI?.modules
-          ? realTimeAPI.modules.getConnectionStats()
-          : { connectedModules: 0 };
-
-        const simpleStats = {
-          users: { online: clientStats.uniqueUsers },
-          modules: { online: moduleStats.connectedModules },
-          timestamp: new Date(),
-        };
-
-        this.events.emitToAdmins('simple_stats_update', simpleStats);
-        Logger.system.debug(
-          `[UserEvents] Stats updated: ${simpleStats.users.online} users, ${simpleStats.modules.online} modules`
-        );
-      } catch (error) {
-        Logger.system.error('[UserEvents] Stats emission error:', error);
-      }
-    }, 300);
+    this.events.scheduleStatsEmit();
   }
 }
 
@@ -108,8 +108,7 @@ class RealTimeAPI {
         );
       } else {
         // Client déjà enregistré - mettre à jour la page seulement
-        const oldPage = existingClient.page;
-        existingClient.page = page;
+        const oldPage = this.events.setClientPage(socket.id, page);
         if (oldPage !== page) {
           Logger.activity.debug(`📄 ${this.getUserName(socket)} navigated: ${oldPage} → ${page}`);
         }
@@ -120,7 +119,10 @@ class RealTimeAPI {
         timestamp: new Date(),
       });
 
-      this._sendInitialState(socket, page);
+      // Reprise par delta : les événements manqués ont déjà été rejoués à l'enregistrement
+      if (socket.eventResumeMode !== 'delta') {
+        this._sendInitialState(socket, page);
+      }
     } catch (error) {
       Logger.activity.error('Error authenticating client:', error);
       socket.emit('client:auth:error', { message: 'Authentication failed' });
@@ -166,7 +168,7 @@ class RealTimeAPI {
   _handlePageChange(socket, data) {
     const client = this.events.connectedClients.get(socket.id);
     if (client) {
-      client.page = data.page || 'unknown';
+      this.events.setClientPage(socket.id, data.page || 'unknown');
       Logger.activity.info(`Client ${socket.id} changed to page: ${client.page}`);
       this._sendInitialState(socket, client.page);
     }
@@ -376,6 +378,7 @@ class RealTimeAPI {
    * @returns {Object} Statistiques complètes des événements, modules et utilisateurs
    * @returns {Object} returns.events - Statistiques des événements
    * @returns {Object} returns.modules - Statistiques des connexions modules
+   * @returns {Object} returns.telemetry - Résumés de télémétrie agrégés sur la flotte
    * @returns {Object} returns.users - Statistiques des utilisateurs connectés
    * @returns {boolean} returns.initialized - État d'initialisation
    */
@@ -383,6 +386,7 @@ class RealTimeAPI {
     return {
       events: this.events.getStats(),
       modules: this.modules.getConnectionStats(),
+      telemetry: this.modules.getFleetTelemetry(),
       users: this.users.getConnectedUsersStats(),
       initialized: this.initialized,
     };
@@ -29,6 +29,7 @@ const AppLogger = require('./utils/logger');
 // TEMPORARY FIX: Expose Logger globally to prevent Express error
 global.Logger = AppLogger;
 const databaseManager = require('./bdd/DatabaseManager');
+const SessionStore = require('./bdd/SessionStore');
 const RealTimeAPI = require('./api');
 const websocketHandler = require('./websocket/handlers');
 const ESP32WebSocketServer = require('./websocket/esp-server');
@@ -90,7 +91,15 @@ app.use(cookieParser());
 app.use(express.json());
 app.use(express.urlencoded({ extended: true }));
 
+// Store en base : sessions partagées entre processus et conservées au redémarrage
+const sessionStore = new SessionStore(databaseManager, {
+  cacheMaxEntries: parseInt(process.env.SESSION_CACHE_MAX_ENTRIES) || 5000,
+  cacheTtlMs: parseInt(process.env.SESSION_CACHE_TTL) || 2000,
+  defaultMaxAgeMs: parseInt(process.env.COOKIE_MAX_AGE) || 24 * 60 * 60 * 1000,
+});
+
 const sessionMiddleware = session({
+  store: sessionStore,
   secret: process.env.SESSION_SECRET,
   resave: false,
   saveUninitialized: false,
@@ -166,7 +175,13 @@ process.on('unhandledRejection', (reason, promise) => {
 async function startServer() {
   try {
     await databaseManager.initialize();
-    await databaseManager.initializeDatabase();
+
+    // Remise à zéro explicite, jamais sous le superviseur : l'autre processus sert encore
+    const resetRequested = process.env.DB_RESET_ON_START === 'true';
+    if (resetRequested && process.send) {
+      AppLogger.app.warn('⚠️ DB_RESET_ON_START ignored under the deployment supervisor');
+    }
+    await databaseManager.initializeDatabase({ reset: resetRequested && !process.send });
 
     const realTimeAPI = new RealTimeAPI(io, databaseManager);
     realTimeAPI.initialize();
@@ -178,6 +193,7 @@ async function startServer() {
     AppLogger.app.info('🔄 Real-time Events API initialized');
 
     databaseManager.startModuleStatusCleanup(1, 5);
+    databaseManager.startSessionCleanup(sessionStore, 15);
 
     const PORT = process.env.PORT || 3000;
     server.listen(PORT, () => {
@@ -199,6 +215,7 @@ async function startServer() {
           app.locals.socketWSBridge = socketWSBridge;
 
           AppLogger.app.info('✅ ESP32 WebSocket Server initialized successfully');
+          attachSupervisor(esp32Server, PORT);
         } catch (error) {
           AppLogger.app.error('❌ ESP32 initialization failed:', error);
         }
@@ -210,6 +227,65 @@ async function startServer() {
   }
 }
 
+// ============================================================================
+// DEPLOYMENT HANDOVER
+// ============================================================================
+
+/**
+ * Grace period for close frames before the outgoing process exits
+ * @constant {number}
+ */
+const HANDOVER_EXIT_DELAY_MS = 500;
+
+/**
+ * Connect this process to the deployment supervisor (supervisor.js), when present
+ * The outgoing process exports then releases its ESP32 sessions; the incoming process
+ * imports them before the modules reconnect
+ * @function attachSupervisor
+ * @param {ESP32WebSocketServer} esp32Server - ESP32 server of this process
+ * @param {number|string} port - Listening port, reopened if the handover is aborted
+ * @returns {void}
+ */
+function attachSupervisor(esp32Server, port) {
+  if (!process.send) return;
+
+  process.on('message', async message => {
+    switch (message?.type) {
+      case 'handover:prepare':
+        // Plus de nouvelles connexions : le superviseur les dirige vers le nouveau processus
+        server.close();
+        await esp32Server.drainCommands();
+        process.send({ type: 'handover:sessions', sessions: esp32Server.exportSessions() });
+        break;
+
+      case 'handover:import':
+        esp32Server.importSessions(message.sessions);
+        process.send({ type: 'handover:imported' });
+        break;
+
+      case 'handover:abort':
+        AppLogger.app.warn('⚠️ Handover aborted - resuming service');
+        esp32Server.draining = false;
+        if (!server.listening) server.listen(port);
+        break;
+
+      case 'handover:release':
+        esp32Server.releaseSessions();
+        io.disconnectSockets(true);
+        setTimeout(async () => {
+          await databaseManager.close().catch(error => AppLogger.app.error(error));
+          process.exit(0);
+        }, HANDOVER_EXIT_DELAY_MS);
+        break;
+
+      default:
+        break;
+    }
+  });
+
+  process.send({ type: 'handover:ready' });
+}
+
 startServer();
 
 module.exports = { app, server, io };
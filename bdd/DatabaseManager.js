@@ -15,6 +15,7 @@ const Logger = require('../utils/logger');
 
 const UserDAO = require('./UserDAO');
 const ModuleDAO = require('./ModuleDAO');
+const SessionDAO = require('./SessionDAO');
 
 /**
  * Gestionnaire principal de la base de données
@@ -28,8 +29,11 @@ class DatabaseManager {
    */
   constructor() {
     this.pool = null;
+    this.connectionLimit = 0;
+    this.poolInFlight = 0;
     this.userDAO = null;
     this.moduleDAO = null;
+    this.sessionDAO = null;
     this.isInitialized = false;
   }
 
@@ -53,12 +57,14 @@ class DatabaseManager {
       };
 
       // Créer le pool de connexions
+      this.connectionLimit = parseInt(process.env.DB_CONNECTION_LIMIT) || 10;
       this.pool = mysql.createPool({
         ...dbConfig,
         waitForConnections: true,
-        connectionLimit: parseInt(process.env.DB_CONNECTION_LIMIT) || 10,
+        connectionLimit: this.connectionLimit,
         queueLimit: 0,
       });
+      this.trackPoolUsage();
 
       // Tester la connexion
       await this.testConnection();
@@ -66,6 +72,7 @@ class DatabaseManager {
       // Initialiser les DAO
       this.userDAO = new UserDAO(this.pool);
       this.moduleDAO = new ModuleDAO(this.pool);
+      this.sessionDAO = new SessionDAO(this.pool);
 
       this.isInitialized = true;
       Logger.app.info('✅ Database Manager initialized successfully');
@@ -77,6 +84,48 @@ class DatabaseManager {
     }
   }
 
+  /**
+   * Compte les requêtes qui occupent ou attendent une connexion, via l'API publique du pool
+   * Au-delà de connectionLimit, les suivantes sont en file d'attente
+   */
+  trackPoolUsage() {
+    for (const method of ['execute', 'query']) {
+      const run = this.pool[method].bind(this.pool);
+      this.pool[method] = async (...args) => {
+        this.poolInFlight++;
+        try {
+          return await run(...args);
+        } finally {
+          this.poolInFlight--;
+        }
+      };
+    }
+
+    // Connexion empruntée : comptée jusqu'à sa libération
+    const acquire = this.pool.getConnection.bind(this.pool);
+    this.pool.getConnection = async () => {
+      this.poolInFlight++;
+      let connection;
+      try {
+        connection = await acquire();
+      } catch (error) {
+        this.poolInFlight--;
+        throw error;
+      }
+
+      const release = connection.release.bind(connection);
+      let released = false;
+      connection.release = () => {
+        if (!released) {
+          released = true;
+          this.poolInFlight--;
+        }
+        return release();
+      };
+      return connection;
+    };
+  }
+
   /**
    * Teste la connexion à la base de données
    * Exécute une requête de test pour vérifier la connexion
@@ -134,23 +183,31 @@ class DatabaseManager {
   }
 
   /**
-   * Initialise la base de données avec les tables et données par défaut
-   */
-  /**
-   * Initialise la base de données en créant les tables
-   * Exécute les scripts SQL d'initialisation et de données par défaut
+   * Initialise la base de données en créant les tables manquantes
+   * Sans remise à zéro, les tables et données existantes sont conservées : les données par
+   * défaut ne sont insérées que dans une base vide
+   * @param {Object} [options={}] - Options d'initialisation
+   * @param {boolean} [options.reset=false] - Supprime les tables avant de les recréer (destructif)
    * @returns {Promise<void>}
    * @throws {Error} En cas d'échec d'initialisation
    */
-  async initializeDatabase() {
+  async initializeDatabase({ reset = false } = {}) {
     try {
       Logger.app.info('🔄 Initializing database...');
 
-      // Créer les tables
+      if (reset) {
+        Logger.app.warn('⚠️ Database reset requested - dropping users and modules');
+        await this.executeSQLFile('drop_tables.sql');
+      }
+
+      // Créer les tables manquantes
       await this.executeSQLFile('create_tables.sql');
 
-      // Insérer les données par défaut
-      await this.executeSQLFile('default_data.sql');
+      // Insérer les données par défaut dans une base vide uniquement
+      const [rows] = await this.pool.execute('SELECT COUNT(*) AS count FROM users');
+      if (rows[0].count === 0) {
+        await this.executeSQLFile('default_data.sql');
+      }
 
       Logger.app.info('✅ Database initialized successfully');
       return true;
@@ -187,6 +244,29 @@ class DatabaseManager {
     );
   }
 
+  /**
+   * Démarre la purge périodique des sessions web expirées
+   * @param {SessionStore} sessionStore - Store de sessions à purger
+   * @param {number} [intervalMinutes=15] - Intervalle en minutes
+   */
+  startSessionCleanup(sessionStore, intervalMinutes = 15) {
+    if (!this.sessionDAO) {
+      Logger.app.error('❌ SessionDAO not initialized');
+      return;
+    }
+
+    setInterval(
+      () => {
+        sessionStore.purgeExpired().catch(error => {
+          Logger.system.error('❌ Error during session cleanup:', error);
+        });
+      },
+      intervalMinutes * 60 * 1000
+    );
+
+    Logger.system.info(`🧹 Session cleanup started (every ${intervalMinutes}min)`);
+  }
+
   /**
    * Obtient des statistiques globales
    * @returns {Object} Statistiques globales
@@ -226,6 +306,23 @@ class DatabaseManager {
     }
   }
 
+  /**
+   * Récupère l'occupation du pool de connexions MySQL (lecture sans requête)
+   * Déduite des requêtes comptées par trackPoolUsage(), sans champ interne de mysql2
+   * @returns {Object} Occupation du pool
+   * @returns {number} returns.total - Taille du pool (connectionLimit)
+   * @returns {number} returns.free - Connexions disponibles
+   * @returns {number} returns.queued - Requêtes en attente d'une connexion
+   */
+  getPoolStats() {
+    const inUse = Math.min(this.poolInFlight, this.connectionLimit);
+    return {
+      total: this.connectionLimit,
+      free: this.connectionLimit - inUse,
+      queued: this.poolInFlight - inUse,
+    };
+  }
+
   /**
    * Ferme proprement les connexions
    */
@@ -260,6 +357,13 @@ class DatabaseManager {
     }
     return this.moduleDAO;
   }
+
+  get sessions() {
+    if (!this.sessionDAO) {
+      throw new Error('Database Manager not initialized');
+    }
+    return this.sessionDAO;
+  }
 }
 
 // Export d'une instance singleton
@@ -296,7 +400,7 @@ const cleanupModuleStatus = maxAgeMinutes => databaseManager.modules.cleanupStat
 /**
  * Fonctions de compatibilité - Base de données
  */
-const initializeDatabase = async () => databaseManager.initializeDatabase();
+const initializeDatabase = async options => databaseManager.initializeDatabase(options);
 const testConnection = async () => databaseManager.testConnection();
 
 // Export direct de l'instance pour faciliter l'utilisation dans les routes
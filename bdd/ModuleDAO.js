@@ -8,8 +8,58 @@
  * @description DAO pour la gestion complète des modules IoT et leurs statuts
  */
 
+const crypto = require('crypto');
 const BaseDAO = require('./BaseDAO');
 const Logger = require('../utils/logger');
+const BoundedCache = require('../utils/BoundedCache');
+
+/**
+ * Limites du cache de statuts : au-delà du TTL, le statut retombe à 'offline'
+ * et la dernière activité reste disponible via la colonne last_seen
+ * @constant {Object}
+ */
+const STATUS_CACHE = {
+  maxEntries: 10000,
+  maxBytes: 8 * 1024 * 1024,
+  ttlMs: 60 * 60 * 1000,
+};
+
+/**
+ * Limites des instantanés de modules par utilisateur : la liste (hors statuts) est lue une
+ * fois en base puis servie depuis la mémoire ; le TTL borne le décalage des champs joints
+ * (nom et email du propriétaire) qui ne passent pas par ce DAO. Les écritures d'un autre
+ * processus sont détectées au plus tard après revalidateMs par une empreinte lue en base
+ * @constant {Object}
+ */
+const SNAPSHOT_CACHE = {
+  maxEntries: 10000,
+  maxBytes: 16 * 1024 * 1024,
+  ttlMs: 10 * 60 * 1000,
+  revalidateMs: 5000,
+};
+
+/**
+ * Colonnes exclues de l'empreinte d'un instantané : activité, pas contenu de la liste
+ * @constant {Set<string>}
+ */
+const SNAPSHOT_VOLATILE_COLUMNS = new Set(['status', 'last_seen', 'updated_at']);
+
+/**
+ * Taille maximum d'une page lue par curseur (listes d'administration en flux)
+ * @constant {number}
+ */
+const PAGE_LIMIT_MAX = 1000;
+
+/**
+ * Filtres texte des listes par curseur : champ de filtre -> colonne SQL (LIKE)
+ * @constant {Object}
+ */
+const PAGE_TEXT_FILTERS = {
+  module_id: 'm.module_id',
+  name: 'm.name',
+  type: 'm.type',
+  user_name: 'u.name',
+};
 
 /**
  * DAO pour la gestion des modules
@@ -24,39 +74,132 @@ class ModuleDAO extends BaseDAO {
    */
   constructor(pool) {
     super(pool);
-    // Cache en mémoire pour les statuts des modules
-    this.moduleStatusCache = new Map(); // moduleId -> { status, lastSeen, userId }
+    // Cache en mémoire borné pour les statuts des modules
+    this.moduleStatusCache = new BoundedCache({
+      name: 'moduleStatus',
+      ...STATUS_CACHE,
+    }); // moduleId -> { status, lastSeen, userId }
+
+    // Instantanés des modules par utilisateur (lignes SQL sans statut)
+    this.userSnapshots = new BoundedCache({
+      name: 'userModuleSnapshot',
+      ...SNAPSHOT_CACHE,
+    }); // userId -> { rows, version, stamp, checkedAt }
   }
 
   /**
    * Récupère les modules d'un utilisateur
+   * Servis depuis l'instantané mémoire ; chaque appel renvoie des objets neufs
    * @param {number} userId - ID de l'utilisateur
    * @returns {Array} Liste des modules de l'utilisateur
    */
   async findByUserId(userId) {
+    const { modules } = await this.getUserModulesView(userId);
+    return modules;
+  }
+
+  /**
+   * Récupère les modules d'un utilisateur avec l'ETag de leur état courant
+   * La base n'est lue qu'au premier appel (ou après invalidation) ; les statuts viennent
+   * du cache alimenté par le serveur ESP32
+   * @param {number} userId - ID de l'utilisateur
+   * @returns {Promise<Object>} {modules, etag}
+   */
+  async getUserModulesView(userId) {
     try {
-      // Utiliser la méthode execute directement avec une requête SQL spécifique
-      const modules = await this.execute(
-        `SELECT m.*, u.name as user_name, u.email as user_email 
-         FROM modules m 
-         LEFT JOIN users u ON m.user_id = u.id 
-         WHERE m.user_id = ? 
-         ORDER BY m.created_at DESC`,
-        [userId]
-      );
+      const snapshot = await this.getUserSnapshot(userId);
 
-      // Ajouter les statuts depuis le cache
-      return modules.map(module => ({
-        ...module,
-        status: this.getModuleStatus(module),
-        lastSeen: this.getLastSeen(module.module_id),
+      const modules = snapshot.rows.map(row => ({
+        ...row,
+        status: this.getModuleStatus(row),
+        lastSeen: this.getLastSeen(row.module_id),
       }));
+
+      // Contenu de la liste (version) et statuts, identiques d'un processus à l'autre ; lastSeen
+      // est exclu, il est poussé par le digest temps réel
+      const statuses = modules.map(module => (module.status === 'online' ? '1' : '0')).join('');
+      const digest = crypto.createHash('sha1').update(statuses).digest('base64url').slice(0, 12);
+
+      return { modules, etag: `W/"m${userId}-${snapshot.version}-${digest}"` };
     } catch (error) {
       Logger.modules.error('Erreur lors de la récupération des modules utilisateur:', error);
       throw error;
     }
   }
 
+  /**
+   * Récupère l'instantané des modules d'un utilisateur, chargé en base si absent
+   * Passé revalidateMs, l'empreinte en base est relue : une écriture d'un autre processus
+   * recharge l'instantané
+   * @param {number} userId - ID de l'utilisateur
+   * @returns {Promise<Object>} {rows, version, stamp, checkedAt}
+   * @private
+   */
+  async getUserSnapshot(userId) {
+    const key = String(userId);
+    const cached = this.userSnapshots.get(key);
+    if (cached && Date.now() - cached.checkedAt < SNAPSHOT_CACHE.revalidateMs) return cached;
+
+    const stamp = await this.getUserSnapshotStamp(userId);
+    if (cached && cached.stamp === stamp) {
+      cached.checkedAt = Date.now();
+      return cached;
+    }
+
+    const rows = await this.execute(
+      `SELECT m.*, u.name as user_name, u.email as user_email 
+       FROM modules m 
+       LEFT JOIN users u ON m.user_id = u.id 
+       WHERE m.user_id = ? 
+       ORDER BY m.created_at DESC`,
+      [userId]
+    );
+
+    // Version dérivée du contenu : le même ETag désigne les mêmes lignes dans tout processus
+    const content = rows.map(row =>
+      Object.entries(row).filter(([column]) => !SNAPSHOT_VOLATILE_COLUMNS.has(column))
+    );
+    const version = crypto
+      .createHash('sha1')
+      .update(JSON.stringify(content))
+      .digest('base64url')
+      .slice(0, 16);
+
+    const snapshot = { rows, version, stamp, checkedAt: Date.now() };
+    this.userSnapshots.set(key, snapshot);
+    return snapshot;
+  }
+
+  /**
+   * Empreinte des modules d'un utilisateur en base (nombre de lignes et somme de contrôle
+   * des colonnes affichées), sans last_seen que chaque connexion de module réécrit
+   * @param {number} userId - ID de l'utilisateur
+   * @returns {Promise<string>} Empreinte comparable à celle de l'instantané
+   * @private
+   */
+  async getUserSnapshotStamp(userId) {
+    const [row] = await this.execute(
+      `SELECT COUNT(*) AS count,
+         COALESCE(SUM(CRC32(CONCAT_WS('|', id, module_id, module_code, name, type, claimed))), 0)
+           AS checksum
+       FROM modules
+       WHERE user_id = ?`,
+      [userId]
+    );
+    return `${row.count}-${row.checksum}`;
+  }
+
+  /**
+   * Invalide l'instantané des modules d'un utilisateur après une écriture
+   * (claim, ajout, libération, renommage) ; le prochain accès relit la base
+   * @param {number|null} userId - ID de l'utilisateur
+   * @returns {void}
+   */
+  invalidateUserSnapshot(userId) {
+    if (userId === null || userId === undefined) return;
+    this.userSnapshots.delete(String(userId));
+  }
+
   /**
    * Récupère tous les modules avec options de filtrage et pagination
    * @param {Object} options - Options de requête
@@ -190,6 +333,65 @@ class ModuleDAO extends BaseDAO {
     }
   }
 
+  /**
+   * Récupère une page de modules par curseur (clé id décroissante)
+   * Le coût d'une page ne dépend pas de sa position, contrairement à OFFSET ; le filtre de
+   * statut s'applique après lecture (statuts en mémoire), une page peut donc être incomplète
+   * @param {Object} [options={}] - Options de lecture
+   * @param {number|null} [options.cursor=null] - id du dernier module de la page précédente
+   * @param {number} [options.limit=500] - Taille de la page (max PAGE_LIMIT_MAX)
+   * @param {Object} [options.filters={}] - module_id, name, type, user_name (LIKE), status
+   * @returns {Promise<Object>} {modules, nextCursor} (nextCursor null en fin de liste)
+   */
+  async findPage({ cursor = null, limit = 500, filters = {} } = {}) {
+    try {
+      const limitInt = Math.min(Math.max(parseInt(limit, 10) || 500, 1), PAGE_LIMIT_MAX);
+      const conditions = [];
+      const params = [];
+
+      if (cursor !== null && cursor !== undefined) {
+        conditions.push('m.id < ?');
+        params.push(parseInt(cursor, 10));
+      }
+
+      for (const [field, column] of Object.entries(PAGE_TEXT_FILTERS)) {
+        const value = typeof filters[field] === 'string' ? filters[field].trim() : '';
+        if (value !== '') {
+          conditions.push(`${column} LIKE ?`);
+          params.push(`%${value}%`);
+        }
+      }
+
+      const where = conditions.length > 0 ? `WHERE ${conditions.join(' AND ')}` : '';
+      const rows = await this.execute(
+        `SELECT m.id, m.module_id, m.name, m.type, m.user_id, m.created_at, u.name as user_name
+         FROM modules m
+         LEFT JOIN users u ON m.user_id = u.id
+         ${where}
+         ORDER BY m.id DESC
+         ${this.buildLimitClause(limitInt, 0)}`,
+        params
+      );
+
+      let modules = rows.map(module => ({
+        ...module,
+        status: this.getModuleStatus(module),
+        lastSeen: this.getLastSeen(module.module_id),
+      }));
+      if (filters.status === 'online' || filters.status === 'offline') {
+        modules = modules.filter(module => module.status === filters.status);
+      }
+
+      return {
+        modules,
+        nextCursor: rows.length === limitInt ? rows[rows.length - 1].id : null,
+      };
+    } catch (error) {
+      Logger.modules.error('Erreur lors de la lecture paginée des modules:', error);
+      throw error;
+    }
+  }
+
   /**
    * Récupère les modules disponibles (non réclamés)
    * @returns {Array} Liste des modules disponibles
@@ -262,6 +464,7 @@ class ModuleDAO extends BaseDAO {
         'UPDATE modules SET user_id = ? WHERE module_id = ? AND user_id IS NULL',
         [userId, moduleId]
       );
+      this.invalidateUserSnapshot(userId);
 
       return result.affectedRows > 0;
     } catch (error) {
@@ -297,8 +500,9 @@ class ModuleDAO extends BaseDAO {
         [moduleId, userId]
       );
 
-      // Nettoyer le cache de statut
+      // Nettoyer le cache de statut et l'instantané du propriétaire
       this.moduleStatusCache.delete(moduleId);
+      this.invalidateUserSnapshot(userId);
 
       return result.affectedRows > 0;
     } catch (error) {
@@ -375,6 +579,12 @@ class ModuleDAO extends BaseDAO {
         );
       }
 
+      // Retirer définitivement les statuts expirés pour borner l'empreinte mémoire
+      const expired = this.moduleStatusCache.prune();
+      if (expired > 0) {
+        Logger.system.debug(`🧹 ${expired} statuts de modules expirés retirés du cache`);
+      }
+
       return cleanedCount;
     } catch (error) {
       Logger.system.error('Erreur lors du nettoyage des statuts:', error);
@@ -474,6 +684,8 @@ class ModuleDAO extends BaseDAO {
         unclaimed: Math.max(0, dbTotal - claimed),
         byType: byType,
         inCache: this.moduleStatusCache.size,
+        cache: this.moduleStatusCache.getStats(),
+        snapshots: this.userSnapshots.getStats(),
       };
     } catch (error) {
       Logger.system.error("Erreur lors de l'obtention des statistiques:", error);
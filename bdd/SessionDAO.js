@@ -0,0 +1,140 @@
+/**
+ * DAO sessions - Persistance des sessions web
+ *
+ * DAO pour le stockage partagé des sessions express-session en base MySQL,
+ * permettant à plusieurs processus Node de servir les mêmes utilisateurs.
+ *
+ * @module SessionDAO
+ * @description DAO pour la lecture, l'écriture et l'expiration des sessions web
+ */
+
+const BaseDAO = require('./BaseDAO');
+const Logger = require('../utils/logger');
+
+/**
+ * DAO pour la gestion des sessions
+ * Hérite de BaseDAO ; les dates d'expiration sont stockées en millisecondes epoch
+ * @class SessionDAO
+ * @extends BaseDAO
+ */
+class SessionDAO extends BaseDAO {
+  /**
+   * Crée une instance de SessionDAO
+   * @param {mysql.Pool} pool - Pool de connexions MySQL
+   */
+  constructor(pool) {
+    super(pool);
+  }
+
+  /**
+   * Récupère une session non expirée
+   * @param {string} sid - Identifiant de session
+   * @returns {Object|null} { data, expires } ou null si absente ou expirée
+   */
+  async findById(sid) {
+    try {
+      const row = await this.findOne(
+        'SELECT data, expires FROM sessions WHERE sid = ? AND expires > ? LIMIT 1',
+        [sid, Date.now()]
+      );
+
+      if (!row) return null;
+
+      return {
+        data: JSON.parse(row.data),
+        expires: Number(row.expires),
+      };
+    } catch (error) {
+      Logger.app.error('Erreur lors de la lecture de session:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Crée ou remplace une session
+   * @param {string} sid - Identifiant de session
+   * @param {Object} data - Contenu de la session
+   * @param {number} expires - Expiration en ms epoch
+   * @returns {boolean} Succès de l'opération
+   */
+  async upsert(sid, data, expires) {
+    try {
+      await this.insert(
+        `INSERT INTO sessions (sid, data, expires) VALUES (?, ?, ?)
+         ON DUPLICATE KEY UPDATE data = VALUES(data), expires = VALUES(expires)`,
+        [sid, JSON.stringify(data), expires]
+      );
+      return true;
+    } catch (error) {
+      Logger.app.error("Erreur lors de l'enregistrement de session:", error);
+      throw error;
+    }
+  }
+
+  /**
+   * Prolonge l'expiration d'une session sans réécrire son contenu
+   * @param {string} sid - Identifiant de session
+   * @param {number} expires - Nouvelle expiration en ms epoch
+   * @returns {boolean} True si la session existait
+   */
+  async touch(sid, expires) {
+    try {
+      const result = await this.update('UPDATE sessions SET expires = ? WHERE sid = ?', [
+        expires,
+        sid,
+      ]);
+      return result.affectedRows > 0;
+    } catch (error) {
+      Logger.app.error('Erreur lors de la prolongation de session:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Supprime une session
+   * @param {string} sid - Identifiant de session
+   * @returns {boolean} True si une session a été supprimée
+   */
+  async destroy(sid) {
+    try {
+      const result = await this.delete('DELETE FROM sessions WHERE sid = ?', [sid]);
+      return result.affectedRows > 0;
+    } catch (error) {
+      Logger.app.error('Erreur lors de la suppression de session:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Supprime toutes les sessions expirées
+   * @returns {number} Nombre de sessions supprimées
+   */
+  async purgeExpired() {
+    try {
+      const result = await this.delete('DELETE FROM sessions WHERE expires <= ?', [Date.now()]);
+      return result.affectedRows;
+    } catch (error) {
+      Logger.system.error('Erreur lors de la purge des sessions expirées:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Compte les sessions actives
+   * @returns {number} Nombre de sessions non expirées
+   */
+  async count() {
+    try {
+      const result = await this.findOne(
+        'SELECT COUNT(*) as total FROM sessions WHERE expires > ?',
+        [Date.now()]
+      );
+      return result ? result.total : 0;
+    } catch (error) {
+      Logger.app.error('Erreur lors du comptage des sessions:', error);
+      throw error;
+    }
+  }
+}
+
+module.exports = SessionDAO;
@@ -0,0 +1,187 @@
+/**
+ * Store de sessions partagé - express-session sur MySQL
+ *
+ * Store express-session persistant en base, partageable entre plusieurs
+ * processus Node (Express et Socket.IO), avec cache LRU local borné.
+ *
+ * @module SessionStore
+ * @description Store de sessions MySQL avec cache mémoire borné et expiration
+ */
+
+const session = require('express-session');
+const BoundedCache = require('../utils/BoundedCache');
+const Logger = require('../utils/logger');
+
+/**
+ * Store express-session adossé au SessionDAO
+ * La base reste la source de vérité ; le cache local ne conserve que les sessions
+ * récemment lues, pour une durée courte afin de limiter les incohérences entre processus.
+ * @class SessionStore
+ * @extends session.Store
+ */
+class SessionStore extends session.Store {
+  /**
+   * Crée une instance du store
+   * @param {DatabaseManager} databaseManager - Gestionnaire de base de données (DAO résolu à l'usage)
+   * @param {Object} [options={}] - Options de configuration
+   * @param {number} [options.cacheMaxEntries=5000] - Nombre maximum de sessions en cache local
+   * @param {number} [options.cacheTtlMs=2000] - Durée de validité du cache local en ms (0 = désactivé)
+   * @param {number} [options.touchAfterMs=60000] - Délai minimum entre deux prolongations en base
+   * @param {number} [options.defaultMaxAgeMs=86400000] - Durée de vie si le cookie n'en définit pas
+   */
+  constructor(databaseManager, options = {}) {
+    super();
+    this.db = databaseManager;
+    this.cacheTtlMs = options.cacheTtlMs ?? 2000;
+    this.touchAfterMs = options.touchAfterMs ?? 60000;
+    this.defaultMaxAgeMs = options.defaultMaxAgeMs || 24 * 60 * 60 * 1000;
+
+    /**
+     * Cache local des sessions récemment lues (sérialisées pour éviter tout partage de référence)
+     * @type {BoundedCache} sid -> {json, expires}
+     */
+    this.cache = new BoundedCache({
+      name: 'sessions',
+      maxEntries: options.cacheMaxEntries || 5000,
+      ttlMs: this.cacheTtlMs,
+    });
+
+    /**
+     * Dernière expiration écrite en base par ce processus
+     * @type {BoundedCache} sid -> expires (ms epoch)
+     */
+    this.persistedExpiry = new BoundedCache({
+      name: 'sessionExpiry',
+      maxEntries: options.cacheMaxEntries || 5000,
+    });
+  }
+
+  /**
+   * Calcule l'expiration d'une session depuis son cookie
+   * @param {Object} sess - Session express-session
+   * @returns {number} Expiration en ms epoch
+   * @private
+   */
+  _expiresOf(sess) {
+    const cookieExpires = sess?.cookie?.expires;
+    if (cookieExpires) {
+      return new Date(cookieExpires).getTime();
+    }
+    return Date.now() + this.defaultMaxAgeMs;
+  }
+
+  /**
+   * Met en cache une session si le cache local est actif
+   * @param {string} sid - Identifiant de session
+   * @param {Object} record - {data, expires}
+   * @private
+   */
+  _remember(sid, record) {
+    if (this.cacheTtlMs > 0) {
+      this.cache.set(sid, { json: JSON.stringify(record.data), expires: record.expires });
+    }
+  }
+
+  /**
+   * Récupère une session
+   * @param {string} sid - Identifiant de session
+   * @param {Function} callback - callback(error, session|null)
+   */
+  get(sid, callback) {
+    const cached = this.cache.get(sid);
+    if (cached && cached.expires > Date.now()) {
+      return callback(null, JSON.parse(cached.json));
+    }
+
+    this.db.sessions
+      .findById(sid)
+      .then(record => {
+        if (record) this._remember(sid, record);
+        callback(null, record ? record.data : null);
+      })
+      .catch(error => callback(error));
+  }
+
+  /**
+   * Crée ou remplace une session
+   * @param {string} sid - Identifiant de session
+   * @param {Object} sess - Contenu de la session
+   * @param {Function} [callback] - callback(error)
+   */
+  set(sid, sess, callback = () => {}) {
+    const record = { data: sess, expires: this._expiresOf(sess) };
+
+    this.db.sessions
+      .upsert(sid, sess, record.expires)
+      .then(() => {
+        this._remember(sid, record);
+        this.persistedExpiry.set(sid, record.expires);
+        callback(null);
+      })
+      .catch(error => callback(error));
+  }
+
+  /**
+   * Prolonge une session active (écriture en base limitée par touchAfterMs)
+   * @param {string} sid - Identifiant de session
+   * @param {Object} sess - Session courante
+   * @param {Function} [callback] - callback(error)
+   */
+  touch(sid, sess, callback = () => {}) {
+    const expires = this._expiresOf(sess);
+    const lastPersisted = this.persistedExpiry.get(sid);
+
+    if (lastPersisted && expires - lastPersisted < this.touchAfterMs) {
+      return callback(null);
+    }
+
+    this.db.sessions
+      .touch(sid, expires)
+      .then(() => {
+        this.persistedExpiry.set(sid, expires);
+        callback(null);
+      })
+      .catch(error => callback(error));
+  }
+
+  /**
+   * Supprime une session
+   * @param {string} sid - Identifiant de session
+   * @param {Function} [callback] - callback(error)
+   */
+  destroy(sid, callback = () => {}) {
+    this.cache.delete(sid);
+    this.persistedExpiry.delete(sid);
+
+    this.db.sessions
+      .destroy(sid)
+      .then(() => callback(null))
+      .catch(error => callback(error));
+  }
+
+  /**
+   * Compte les sessions actives
+   * @param {Function} callback - callback(error, count)
+   */
+  length(callback) {
+    this.db.sessions
+      .count()
+      .then(total => callback(null, total))
+      .catch(error => callback(error));
+  }
+
+  /**
+   * Purge les sessions expirées en base et dans le cache local
+   * @returns {Promise<number>} Nombre de sessions supprimées en base
+   */
+  async purgeExpired() {
+    this.cache.prune();
+    const removed = await this.db.sessions.purgeExpired();
+    if (removed > 0) {
+      Logger.system.info(`🧹 ${removed} session(s) expirée(s) supprimée(s)`);
+    }
+    return removed;
+  }
+}
+
+module.exports = SessionStore;
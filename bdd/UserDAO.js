@@ -12,6 +12,12 @@ const BaseDAO = require('./BaseDAO');
 const bcrypt = require('bcrypt');
 const Logger = require('../utils/logger');
 
+/**
+ * Taille maximum d'une page lue par curseur (listes d'administration en flux)
+ * @constant {number}
+ */
+const PAGE_LIMIT_MAX = 1000;
+
 /**
  * DAO pour la gestion des utilisateurs
  * Hérite de BaseDAO et ajoute des fonctionnalités spécifiques aux utilisateurs
@@ -272,6 +278,69 @@ class UserDAO extends BaseDAO {
     }
   }
 
+  /**
+   * Récupère une page d'utilisateurs par curseur (clé id décroissante)
+   * Le nombre de modules est une sous-requête par ligne : pas de GROUP BY/HAVING, chaque
+   * page est donc complète et le curseur reste exact même filtré sur ce nombre
+   * @param {Object} [options={}] - Options de lecture
+   * @param {number|null} [options.cursor=null] - id du dernier utilisateur de la page précédente
+   * @param {number} [options.limit=500] - Taille de la page (max PAGE_LIMIT_MAX)
+   * @param {Object} [options.filters={}] - name, email (LIKE), role (admin/user), module_count
+   * @returns {Promise<Object>} {users, nextCursor} (nextCursor null en fin de liste)
+   */
+  async findPage({ cursor = null, limit = 500, filters = {} } = {}) {
+    try {
+      const limitInt = Math.min(Math.max(parseInt(limit, 10) || 500, 1), PAGE_LIMIT_MAX);
+      const moduleCount = '(SELECT COUNT(*) FROM modules m WHERE m.user_id = u.id)';
+      const conditions = [];
+      const params = [];
+
+      if (cursor !== null && cursor !== undefined) {
+        conditions.push('u.id < ?');
+        params.push(parseInt(cursor, 10));
+      }
+
+      for (const field of ['name', 'email']) {
+        const value = typeof filters[field] === 'string' ? filters[field].trim() : '';
+        if (value !== '') {
+          conditions.push(`u.${field} LIKE ?`);
+          params.push(`%${value}%`);
+        }
+      }
+
+      if (filters.role === 'admin') {
+        conditions.push('u.is_admin = 1');
+      } else if (filters.role === 'user') {
+        conditions.push('u.is_admin = 0');
+      }
+
+      const count = parseInt(filters.module_count, 10);
+      if (!isNaN(count)) {
+        conditions.push(`${moduleCount} = ?`);
+        params.push(count);
+      }
+
+      const where = conditions.length > 0 ? `WHERE ${conditions.join(' AND ')}` : '';
+      const users = await this.execute(
+        `SELECT u.id, u.email, u.name, u.is_admin, u.last_login, u.created_at,
+                ${moduleCount} as module_count
+         FROM users u
+         ${where}
+         ORDER BY u.id DESC
+         ${this.buildLimitClause(limitInt, 0)}`,
+        params
+      );
+
+      return {
+        users,
+        nextCursor: users.length === limitInt ? users[users.length - 1].id : null,
+      };
+    } catch (error) {
+      Logger.app.error('Erreur lors de la lecture paginée des utilisateurs:', error);
+      throw error;
+    }
+  }
+
   /**
    * Met à jour le profil d'un utilisateur
    * @param {number} userId - ID de l'utilisateur
@@ -81,6 +81,14 @@ module.exports = [
         // Variables spécifiques au projet (définies ailleurs)
         urlImg: 'readonly',
         preload: 'readonly',
+
+        // API navigateur des listes d'administration en flux
+        AbortController: 'readonly',
+        URLSearchParams: 'readonly',
+        TextDecoder: 'readonly',
+
+        // Horloge de clignotement partagée de la page modules
+        performance: 'readonly',
       },
     },
   },
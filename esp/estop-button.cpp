@@ -0,0 +1,383 @@
+/*
+ * MicroCoaster - Emergency Stop ESP32
+ * Bouton d'arrêt d'urgence : chaîne de sécurité et diffusion LAN de l'arrêt
+ */
+
+#include <Arduino.h>
+#include <soc/gpio_reg.h>
+
+#define MC_TAG "[ESTOP BUTTON]"
+const char MODULE_NAME[] = "Emergency Stop";
+const char MODULE_TYPE[] = "estop-button";
+
+#ifndef MC_NATIVE_BENCH
+// Configuration module
+const char MODULE_ID[] = "MC-0001-ES";
+const char MODULE_PASSWORD[] = "NDBxGxb0WKcLsfAC1B8Jw0arFazstDti";
+#endif
+
+// Plan mémoire propre au module (le reste est fixé par module_core.h)
+const size_t JSON_TX_BYTES = 7168;                 // Tampon du message JSON envoyé
+const size_t JSON_TX_POOL_BYTES = 8192;            // Zone du document JSON envoyé
+const size_t STATIC_RAM_BUDGET_BYTES = 28 * 1024;  // Budget RAM statique du firmware
+const size_t TELEMETRY_SUMMARIES = 4;              // rssi, heap, loopUs, stopUs
+const uint8_t TIMELINE_MODULE_KIND = 1;            // estop-button
+const unsigned long LOOP_IDLE_MS = 10;             // Pause de loop() au repos (rapport d'arrêt à ~10 ms)
+
+// Paramètres d'une commande en file (aucun pour le bouton)
+struct CommandParams {
+};
+
+#include "module_core.h"
+#include "estop_link.h"
+
+const uint32_t FIRMWARE_CAPABILITIES = CORE_CAPABILITIES;
+
+// Pins hardware
+const int ESTOP_PIN = 33;                          // Contact NF vers GND : ouvert (HIGH) = arrêt demandé
+const int SAFETY_RELAY_PIN = 26;                   // Chaîne de sécurité du manège (HIGH = autorisée)
+const int STATUS_LED_PIN = 2;
+
+static_assert(SAFETY_RELAY_PIN < 32, "Relais coupé par GPIO_OUT_W1TC_REG (GPIO 0 à 31)");
+
+// Diffusion de l'arrêt - tâche dédiée réveillée par l'interruption du bouton
+const uint8_t STOP_FRAME_REPEATS = 3;              // Diffusion sans acquittement MAC : trame répétée
+const uint32_t STOP_REPEAT_MS = 2;                 // Intervalle entre deux répétitions
+const uint32_t ACK_WINDOW_MS = 50;                 // Attente des acquittements avant le rapport
+const uint8_t ACK_MAX = 16;                        // Modules suivis par déclenchement
+const int STOP_TASK_PRIORITY = configMAX_PRIORITIES - 1;
+const uint32_t STOP_TASK_STACK = 4096;
+const int STOP_TASK_CORE = 1;                      // Cœur applicatif : préempte loop() immédiatement
+
+// Verrou du bouton - posé par l'interruption ou la commande activate, levé par reset
+struct ButtonState {
+  volatile bool latched;
+  volatile bool reported;        // Rapport du déclenchement envoyé (ou sans objet)
+  volatile bool fromCommand;     // Déclenché par le serveur ou une timeline
+  volatile uint32_t triggerUs;   // esp_timer au front du bouton
+  volatile uint32_t sequence;    // Numéro du dernier déclenchement
+};
+
+// Acquittement d'un module pour le déclenchement courant
+struct StopAck {
+  char moduleId[STOP_ID_MAX];
+  uint32_t latencyUs;            // Front du bouton -> acquittement reçu (majore l'arrêt du module)
+  uint16_t handleUs;             // Réception -> sorties coupées, mesuré par le module
+};
+
+// Verrouillé au démarrage : la chaîne de sécurité n'est rétablie que par un réarmement explicite
+ButtonState button = { true, true, false, 0, 0 };
+StopAck acks[ACK_MAX];
+volatile uint8_t ackCount = 0;
+uint32_t bootId = 0;                               // Tiré au démarrage, distingue les redémarrages
+uint32_t worstLatencyUs = 0;                       // Pire latence mesurée depuis le démarrage
+TaskHandle_t stopTask = nullptr;
+portMUX_TYPE stopMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Latence d'arrêt (pire module par déclenchement), remontée avec les autres résumés
+MetricSummary stopSummary = {};
+
+// Une timeline peut déclencher l'arrêt, jamais le lever : le réarmement reste un geste opérateur
+// (commande reset, bouton relâché). L'ancien opcode 0x11 est refusé au chargement du programme.
+const uint8_t OP_ESTOP_ACTIVATE = 0x10;
+
+#ifndef MC_NATIVE_BENCH
+static_assert(sizeof(MODULE_ID) <= STOP_ID_MAX, "MODULE_ID trop long pour la trame d'arrêt");
+#endif
+static_assert(CORE_STATIC_BYTES + sizeof(acks) <= STATIC_RAM_BUDGET_BYTES, "Budget RAM statique dépassé");
+
+// Déclarations des fonctions
+void setupButton();
+void onButtonEdge();
+void latchButton(uint32_t nowUs, bool fromCommand);
+void triggerStop();
+const char* releaseStop();
+void stopTaskMain(void* arg);
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+void onAckFrame(const esp_now_recv_info_t* info, const uint8_t* data, int length);
+#else
+void onAckFrame(const uint8_t* sender, const uint8_t* data, int length);
+#endif
+void checkStopReport();
+void sendStopReport(const char* state, long worstUs = -1);
+
+// Chaîne de sécurité ouverte dès le démarrage, interruption du bouton et tâche de diffusion
+void setupHardware() {
+  setupButton();
+}
+
+// Rapport d'arrêt : l'arrêt lui-même ne dépend ni de loop() ni du serveur
+void serviceOutputs() {
+  digitalWrite(STATUS_LED_PIN, button.latched ? HIGH : LOW);
+  checkStopReport();
+}
+
+bool outputsBusy() {
+  return false;
+}
+
+void parseCommandParams(CommandParams& params, JsonVariantConst data) {
+}
+
+void executeCommand(const QueuedCommand& queued) {
+  const char* command = queued.name;
+  const char* status = "success";
+
+  // Traitement des commandes - le déclenchement logiciel suit le même chemin que le bouton
+  if (!strcmp(command, "activate") || !strcmp(command, "estop")) {
+    Serial.println(MC_TAG " 🛑 Arrêt d'urgence demandé par le serveur");
+    triggerStop();
+
+  } else if (!strcmp(command, "deactivate") || !strcmp(command, "reset")) {
+    status = releaseStop();
+    Serial.printf(MC_TAG " 🔓 Réarmement: %s\n", status);
+
+  } else if (!strcmp(command, "timeline_play")) {
+    startTimeline(queued);
+    return;
+
+  } else if (!strcmp(command, "timeline_stop")) {
+    if (timeline.playing) {
+      timeline.playing = false;
+      sendTimelineStatus("stopped");
+    }
+    Serial.println(MC_TAG " ⏹️ Timeline arrêtée");
+
+  } else if (!strcmp(command, "get_state")) {
+    // Pas de changement d'état, juste retourner l'état
+    Serial.printf(MC_TAG " 📍 Verrou: %s\n", button.latched ? "actif" : "levé");
+
+  } else {
+    Serial.printf(MC_TAG " ❌ Commande inconnue: %s\n", command);
+    status = "unknown_command";
+  }
+
+  // Envoyer la réponse de commande (WebSocket natif)
+  sendCommandResponse(command, queued.id, status);
+}
+
+// ============================================================================
+// BOUTON ET DIFFUSION DE L'ARRÊT
+// ============================================================================
+
+void setupButton() {
+  // Chaîne de sécurité ouverte tant que le bouton n'a pas été réarmé
+  digitalWrite(SAFETY_RELAY_PIN, LOW);
+  pinMode(SAFETY_RELAY_PIN, OUTPUT);
+  pinMode(STATUS_LED_PIN, OUTPUT);
+  pinMode(ESTOP_PIN, INPUT_PULLUP);
+
+  bootId = esp_random();
+  xTaskCreatePinnedToCore(stopTaskMain, "estop", STOP_TASK_STACK, nullptr, STOP_TASK_PRIORITY, &stopTask,
+                          STOP_TASK_CORE);
+  attachInterrupt(digitalPinToInterrupt(ESTOP_PIN), onButtonEdge, RISING);
+
+  Serial.printf(MC_TAG " 🔒 Verrouillé au démarrage - réarmement requis (bouton %s)\n",
+                digitalRead(ESTOP_PIN) == HIGH ? "enfoncé" : "relâché");
+}
+
+// Front montant du contact : verrou et coupure de la chaîne de sécurité dans l'interruption,
+// puis réveil de la tâche de diffusion
+void IRAM_ATTR onButtonEdge() {
+  uint32_t nowUs = (uint32_t)esp_timer_get_time();
+
+  portENTER_CRITICAL_ISR(&stopMux);
+  bool fresh = !button.latched;
+  if (fresh) latchButton(nowUs, false);
+  portEXIT_CRITICAL_ISR(&stopMux);
+  if (!fresh) return;
+
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(stopTask, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+// Appelé sous stopMux ; écriture directe du registre GPIO (sûre en interruption)
+void IRAM_ATTR latchButton(uint32_t nowUs, bool fromCommand) {
+  REG_WRITE(GPIO_OUT_W1TC_REG, 1UL << SAFETY_RELAY_PIN);
+  button.latched = true;
+  button.reported = false;
+  button.fromCommand = fromCommand;
+  button.triggerUs = nowUs;
+  button.sequence = button.sequence + 1;
+  ackCount = 0;
+}
+
+// Déclenchement logiciel (commande ou pas de timeline) : même verrou, même diffusion
+void triggerStop() {
+  uint32_t nowUs = (uint32_t)esp_timer_get_time();
+
+  portENTER_CRITICAL(&stopMux);
+  bool fresh = !button.latched;
+  if (fresh) latchButton(nowUs, true);
+  portEXIT_CRITICAL(&stopMux);
+
+  if (fresh) xTaskNotifyGive(stopTask);
+}
+
+// Réarmement : bouton relâché (contact refermé) uniquement, puis chaîne de sécurité rétablie.
+// Les modules restent verrouillés jusqu'à leur propre estop_reset (envoyé par le serveur).
+const char* releaseStop() {
+  if (digitalRead(ESTOP_PIN) == HIGH) return "button_pressed";
+
+  portENTER_CRITICAL(&stopMux);
+  button.latched = false;
+  button.reported = true;
+  portEXIT_CRITICAL(&stopMux);
+
+  digitalWrite(SAFETY_RELAY_PIN, HIGH);
+  sendStopReport("released");
+  return "success";
+}
+
+// Tâche de priorité maximale : signe et diffuse la trame dès le réveil par l'interruption
+void stopTaskMain(void* arg) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    StopFrame frame = {};
+    memcpy(frame.magic, "MCES", 4);
+    frame.version = STOP_FRAME_VERSION;
+    frame.type = STOP_FRAME_TRIGGER;
+    frame.bootId = bootId;
+    frame.sequence = button.sequence;
+    strlcpy(frame.moduleId, MODULE_ID, sizeof(frame.moduleId));
+
+    uint8_t mac[32];
+    stopFrameMac(frame, mac);
+    memcpy(frame.mac, mac, STOP_MAC_BYTES);
+
+    // Diffusion sans acquittement MAC : la trame est répétée, les modules ignorent les doublons
+    for (uint8_t i = 0; i < STOP_FRAME_REPEATS; i++) {
+      esp_now_send(BROADCAST_MAC, reinterpret_cast<const uint8_t*>(&frame), sizeof(frame));
+      if (i + 1 < STOP_FRAME_REPEATS) vTaskDelay(pdMS_TO_TICKS(STOP_REPEAT_MS));
+    }
+  }
+}
+
+// Diffusion des trames d'arrêt et réception des acquittements
+void setupStopListener() {
+  if (!startStopLink(onAckFrame)) {
+    Serial.println(MC_TAG " ⚠️ ESP-NOW indisponible - arrêt par la chaîne de sécurité et le serveur uniquement");
+  }
+}
+
+// Exécuté dans la tâche WiFi : enregistre l'acquittement d'un module pour le déclenchement courant
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+void onAckFrame(const esp_now_recv_info_t* info, const uint8_t* data, int length) {
+#else
+void onAckFrame(const uint8_t* sender, const uint8_t* data, int length) {
+#endif
+  uint32_t receivedUs = (uint32_t)esp_timer_get_time();
+  if (length != sizeof(StopFrame) || !button.latched) return;
+
+  StopFrame frame;
+  memcpy(&frame, data, sizeof(frame));
+  if (memcmp(frame.magic, "MCES", 4) != 0 || frame.version != STOP_FRAME_VERSION) return;
+  if (frame.type != STOP_FRAME_ACK || frame.bootId != bootId || frame.sequence != button.sequence) return;
+  if (!verifyStopFrame(frame)) return;
+
+  // Un acquittement par module et par déclenchement
+  uint8_t count = ackCount;
+  for (uint8_t i = 0; i < count; i++) {
+    if (!strncmp(acks[i].moduleId, frame.moduleId, STOP_ID_MAX)) return;
+  }
+  if (count >= ACK_MAX) return;
+
+  memcpy(acks[count].moduleId, frame.moduleId, STOP_ID_MAX);
+  acks[count].moduleId[STOP_ID_MAX - 1] = '\0';
+  acks[count].latencyUs = receivedUs - button.triggerUs;
+  acks[count].handleUs = frame.handleUs;
+  ackCount = count + 1;
+}
+
+// Après la fenêtre d'acquittement : pire latence de bout en bout et rapport au serveur
+void checkStopReport() {
+  if (!button.latched || button.reported) return;
+  if ((uint32_t)esp_timer_get_time() - button.triggerUs < ACK_WINDOW_MS * 1000) return;
+  button.reported = true;
+
+  uint32_t worstUs = 0;
+  for (uint8_t i = 0; i < ackCount; i++) {
+    worstUs = max(worstUs, acks[i].latencyUs);
+  }
+  if (ackCount > 0) {
+    recordSample(stopSummary, (int32_t)worstUs);
+    if (worstUs > worstLatencyUs) worstLatencyUs = worstUs;
+  }
+
+  Serial.printf(MC_TAG " 🛑 Arrêt #%lu diffusé - %u acquittement(s), pire latence %lu µs\n",
+                (unsigned long)button.sequence, ackCount, (unsigned long)worstUs);
+  sendStopReport("triggered", worstUs);
+}
+
+// Événement d'arrêt pour le serveur : acquittements reçus (latence par module) et pire cas
+void sendStopReport(const char* state, long worstUs) {
+  if (!isAuthenticated) return;
+
+  JsonDocument doc(&txAllocator);
+  doc["type"] = "estop_event";
+  stampState(doc);
+  doc["moduleId"] = MODULE_ID;
+  doc["password"] = MODULE_PASSWORD;
+  doc["state"] = state;
+  doc["sequence"] = button.sequence;
+  doc["source"] = button.fromCommand ? "command" : "button";
+
+  if (worstUs >= 0) {
+    doc["worstUs"] = worstUs;
+    doc["worstEverUs"] = worstLatencyUs;
+    JsonArray list = doc["acks"].to<JsonArray>();
+    for (uint8_t i = 0; i < ackCount; i++) {
+      JsonObject ack = list.add<JsonObject>();
+      ack["moduleId"] = acks[i].moduleId;
+      ack["latencyUs"] = acks[i].latencyUs;
+      ack["handleUs"] = acks[i].handleUs;
+    }
+  }
+
+  sendDocument(doc);
+
+  Serial.printf(MC_TAG " 📤 Événement d'arrêt: %s\n", state);
+}
+
+// ============================================================================
+// TIMELINES COMPILÉES
+// ============================================================================
+
+// Taille des opérandes par opcode (-1 : opcode non pris en charge par ce module)
+int8_t timelineOperandBytes(uint8_t opcode) {
+  switch (opcode) {
+    case OP_ESTOP_ACTIVATE: return 1;  // force_stop
+    default:                return -1;
+  }
+}
+
+// force_stop est ignoré : un arrêt d'urgence est toujours complet
+void executeTimelineStep(uint8_t opcode, uint16_t durationMs, const uint8_t* operands) {
+  if (opcode == OP_ESTOP_ACTIVATE) {
+    triggerStop();
+  }
+}
+
+// ============================================================================
+// MESSAGES D'ÉTAT
+// ============================================================================
+
+void writeModuleState(JsonDocument& doc, StateReport report) {
+  doc["estop"] = button.latched;
+  if (report == REPORT_RESPONSE) doc["sequence"] = button.sequence;
+  if (report == REPORT_TELEMETRY) doc["worstStopUs"] = worstLatencyUs;
+}
+
+void writeModuleSummaries(JsonObject summary) {
+  if (!summary.isNull()) writeSummary(summary["stopUs"].to<JsonObject>(), stopSummary);
+  resetSummary(stopSummary);
+}
+
+void onSessionChanged(bool authenticated) {
+}
+
+void printModuleMemory() {
+  Serial.printf(MC_TAG "    Acquittements     : %zu octets (%u modules)\n", sizeof(acks), ACK_MAX);
+}
@@ -0,0 +1,118 @@
+/*
+ * MicroCoaster - Verrou d'arrêt d'urgence des modules
+ * Réception de la trame LAN du bouton, coupure immédiate des sorties et acquittement.
+ * Inclus après esp/module_core.h et esp/estop_link.h ; le module fournit cutOutputs().
+ */
+
+#pragma once
+
+// Verrou d'arrêt d'urgence - posé par la trame LAN ou la commande estop, levé par estop_reset.
+// La tâche WiFi ne fait que poser le verrou et couper les sorties ; file, timeline et état des
+// effets restent à loop(), qui reprend la coupure dans checkEstop().
+struct EstopState {
+  volatile bool latched;
+  volatile bool pending;         // Arrêt à traiter par loop()
+  uint32_t bootId;               // Dernière trame acceptée (anti-rejeu)
+  uint32_t sequence;
+  uint32_t handleUs;             // Réception -> sorties coupées
+  uint32_t commandId;            // Commande estop à acquitter par checkEstop() (0 = trame LAN)
+};
+
+EstopState estop = {};
+portMUX_TYPE estopMux = portMUX_INITIALIZER_UNLOCKED;   // latched / pending entre tâche WiFi et loop()
+
+void cutOutputs();                                 // Sorties du module à l'arrêt, sans attente
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+void onStopFrame(const esp_now_recv_info_t* info, const uint8_t* data, int length);
+#else
+void onStopFrame(const uint8_t* sender, const uint8_t* data, int length);
+#endif
+void sendStopAck(const StopFrame& trigger);
+void emergencyStop(uint32_t commandId = 0);
+void checkEstop();
+bool releaseEstop();
+
+void setupStopListener() {
+  if (!startStopLink(onStopFrame)) {
+    Serial.println(MC_TAG " ⚠️ ESP-NOW indisponible - arrêt d'urgence par le serveur uniquement");
+  }
+}
+
+// Exécuté dans la tâche WiFi, prioritaire sur loop() : vérification, coupure, acquittement
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+void onStopFrame(const esp_now_recv_info_t* info, const uint8_t* data, int length) {
+#else
+void onStopFrame(const uint8_t* sender, const uint8_t* data, int length) {
+#endif
+  uint32_t receivedUs = (uint32_t)esp_timer_get_time();
+  if (length != sizeof(StopFrame)) return;
+
+  StopFrame frame;
+  memcpy(&frame, data, sizeof(frame));
+  if (memcmp(frame.magic, "MCES", 4) != 0 || frame.version != STOP_FRAME_VERSION) return;
+  if (frame.type != STOP_FRAME_TRIGGER || !verifyStopFrame(frame)) return;
+
+  // Répétition d'une trame déjà traitée ; un autre bootId est accepté (rejouer un arrêt reste sûr)
+  if (frame.bootId == estop.bootId && frame.sequence <= estop.sequence) return;
+  estop.bootId = frame.bootId;
+  estop.sequence = frame.sequence;
+
+  emergencyStop();
+  estop.handleUs = (uint32_t)esp_timer_get_time() - receivedUs;
+  sendStopAck(frame);
+}
+
+// Acquittement diffusé : le bouton en déduit la latence de bout en bout de ce module
+void sendStopAck(const StopFrame& trigger) {
+  StopFrame ack = trigger;
+  ack.type = STOP_FRAME_ACK;
+  ack.handleUs = (uint16_t)min(estop.handleUs, (uint32_t)UINT16_MAX);
+  memset(ack.moduleId, 0, sizeof(ack.moduleId));
+  strlcpy(ack.moduleId, MODULE_ID, sizeof(ack.moduleId));
+
+  uint8_t mac[32];
+  stopFrameMac(ack, mac);
+  memcpy(ack.mac, mac, STOP_MAC_BYTES);
+  esp_now_send(BROADCAST_MAC, reinterpret_cast<const uint8_t*>(&ack), sizeof(ack));
+}
+
+// Coupure immédiate, appelée depuis la tâche WiFi ou par la commande estop (commandId)
+void emergencyStop(uint32_t commandId) {
+  portENTER_CRITICAL(&estopMux);
+  estop.latched = true;
+  estop.pending = true;
+  if (commandId) estop.commandId = commandId;
+  portEXIT_CRITICAL(&estopMux);
+  cutOutputs();
+}
+
+// Suite d'un arrêt dans loop() : sorties coupées à nouveau (une commande ou un pas de timeline
+// en cours pendant l'arrêt a pu les réécrire), file vidée, timeline arrêtée, serveur prévenu
+void checkEstop() {
+  portENTER_CRITICAL(&estopMux);
+  bool pending = estop.pending;
+  uint32_t commandId = estop.commandId;
+  estop.pending = false;
+  estop.commandId = 0;
+  portEXIT_CRITICAL(&estopMux);
+  if (!pending) return;
+
+  cutOutputs();
+  clearCommandQueue("estop_latched");
+  Serial.printf(MC_TAG " 🛑 Arrêt d'urgence #%lu - sorties coupées en %lu µs\n", (unsigned long)estop.sequence,
+                (unsigned long)estop.handleUs);
+  if (timeline.playing) {
+    timeline.playing = false;
+    sendTimelineStatus("stopped", "estop");
+  }
+  sendCommandResponse("estop", commandId, "latched");
+}
+
+// Levée du verrou (estop_reset) ; refusée si un arrêt reçu entre-temps n'a pas encore été traité
+bool releaseEstop() {
+  portENTER_CRITICAL(&estopMux);
+  bool released = !estop.pending;
+  if (released) estop.latched = false;
+  portEXIT_CRITICAL(&estopMux);
+  return released;
+}
@@ -0,0 +1,101 @@
+/*
+ * MicroCoaster - Trame d'arrêt d'urgence LAN
+ * Format signé diffusé en ESP-NOW par le bouton (esp/estop-button.cpp) et acquitté par les
+ * modules (esp/estop_latch.h). Inclus après esp/module_core.h.
+ *
+ * Clé du manège : 32 octets en NVS (espace "mc-estop", clé "rideKey"), identiques sur tous
+ * les modules du manège et jamais dans les sources. Provisionnement : copier la clé dans
+ * esp/ride_key.h (ignoré par git) sous la forme
+ *   const uint8_t RIDE_KEY_PROVISION[32] = { 0x.., ... };
+ * puis flasher une fois ; le module l'écrit en NVS au démarrage. Sans clé, le lien LAN
+ * reste éteint et l'arrêt passe par le serveur uniquement.
+ */
+
+#pragma once
+
+#include <esp_timer.h>
+#include <esp_now.h>
+#include <mbedtls/md.h>
+
+#if __has_include("ride_key.h")
+#include "ride_key.h"
+#define MC_RIDE_KEY_PROVISION
+#endif
+
+const size_t RIDE_KEY_BYTES = 32;                  // Clé HMAC-SHA256 du manège
+const uint8_t STOP_FRAME_VERSION = 1;
+const uint8_t STOP_FRAME_TRIGGER = 1;              // Bouton -> modules
+const uint8_t STOP_FRAME_ACK = 2;                  // Module -> bouton, après coupure des sorties
+const size_t STOP_MAC_BYTES = 16;                  // HMAC-SHA256 tronqué
+const size_t STOP_ID_MAX = 16;
+const uint8_t BROADCAST_MAC[6] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+struct __attribute__((packed)) StopFrame {
+  char magic[4];             // "MCES"
+  uint8_t version;
+  uint8_t type;              // STOP_FRAME_TRIGGER ou STOP_FRAME_ACK
+  uint16_t handleUs;         // ACK : durée réception -> sorties coupées
+  uint32_t bootId;           // Tiré au démarrage du bouton
+  uint32_t sequence;         // Croissant à chaque déclenchement
+  char moduleId[STOP_ID_MAX];  // Émetteur de la trame
+  uint8_t mac[STOP_MAC_BYTES];
+};
+
+uint8_t rideKey[RIDE_KEY_BYTES];                   // Clé HMAC du manège, lue en NVS
+
+static_assert(sizeof(StopFrame) <= 250, "Trame d'arrêt au-delà de la charge utile ESP-NOW");
+#ifdef MC_RIDE_KEY_PROVISION
+static_assert(sizeof(RIDE_KEY_PROVISION) == RIDE_KEY_BYTES, "Clé du manège : 32 octets attendus");
+#endif
+
+// Clé du manège depuis la NVS, réécrite d'abord par ride_key.h s'il est présent et différent
+// (une écriture flash au provisionnement, aucune ensuite) ; false si aucune clé n'est provisionnée
+bool loadRideKey() {
+  nvs.begin("mc-estop", false);
+  size_t length = nvs.getBytes("rideKey", rideKey, sizeof(rideKey));
+#ifdef MC_RIDE_KEY_PROVISION
+  if (length != RIDE_KEY_BYTES || memcmp(rideKey, RIDE_KEY_PROVISION, RIDE_KEY_BYTES) != 0) {
+    memcpy(rideKey, RIDE_KEY_PROVISION, RIDE_KEY_BYTES);
+    length = nvs.putBytes("rideKey", rideKey, RIDE_KEY_BYTES);
+    Serial.println(MC_TAG " 🔑 Clé du manège provisionnée en NVS");
+  }
+#endif
+  nvs.end();
+  return length == RIDE_KEY_BYTES;
+}
+
+// HMAC-SHA256 de la trame hors signature, avec la clé du manège
+void stopFrameMac(const StopFrame& frame, uint8_t* out) {
+  mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256), rideKey, sizeof(rideKey),
+                  reinterpret_cast<const uint8_t*>(&frame), offsetof(StopFrame, mac), out);
+}
+
+bool verifyStopFrame(const StopFrame& frame) {
+  uint8_t expected[32];
+  stopFrameMac(frame, expected);
+
+  // Comparaison en temps constant
+  uint8_t diff = 0;
+  for (size_t i = 0; i < STOP_MAC_BYTES; i++) {
+    diff |= expected[i] ^ frame.mac[i];
+  }
+  return diff == 0;
+}
+
+// Pair de diffusion (canal courant du WiFi station) et réception des trames ; false sans clé
+// du manège ou si ESP-NOW n'a pas pu démarrer
+bool startStopLink(esp_now_recv_cb_t onFrame) {
+  if (!loadRideKey()) {
+    Serial.println(MC_TAG " 🔑 Clé du manège absente de la NVS (voir esp/estop_link.h)");
+    return false;
+  }
+  if (esp_now_init() != ESP_OK) return false;
+
+  esp_now_peer_info_t peer = {};
+  memcpy(peer.peer_addr, BROADCAST_MAC, sizeof(BROADCAST_MAC));
+  peer.channel = 0;
+  peer.encrypt = false;
+  esp_now_add_peer(&peer);
+  esp_now_register_recv_cb(onFrame);
+  return true;
+}
@@ -0,0 +1,559 @@
+/*
+ * MicroCoaster - LED Control ESP32
+ * Éclairage RGB et bande adressable, effets générés par les périphériques
+ */
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+
+#define MC_TAG "[LED CONTROL]"
+const char MODULE_NAME[] = "LED Control";
+const char MODULE_TYPE[] = "led-control";
+
+#ifndef MC_NATIVE_BENCH
+// Configuration module
+const char MODULE_ID[] = "MC-0001-LFX";
+const char MODULE_PASSWORD[] = "Q2vN8kLwT5rYc1HzJp7XmB4dGs9EaU3f";
+#endif
+
+// Plan mémoire propre au module (le reste est fixé par module_core.h)
+const size_t JSON_TX_BYTES = 5632;                 // Tampon du message JSON envoyé
+const size_t JSON_TX_POOL_BYTES = 6656;            // Zone du document JSON envoyé
+const size_t STATIC_RAM_BUDGET_BYTES = 24 * 1024;  // Budget RAM statique du firmware
+const size_t TELEMETRY_SUMMARIES = 3;              // rssi, heap, loopUs
+const uint8_t TIMELINE_MODULE_KIND = 4;            // led-control
+const unsigned long LOOP_IDLE_MS = 100;            // Pause de loop() au repos
+
+struct LedColor {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+};
+
+// Paramètres d'une commande en file
+struct CommandParams {
+  LedColor color;
+  uint8_t brightness;        // 0-100
+  uint32_t fadeMs;
+  uint16_t onMs;             // blink : phases allumée / éteinte
+  uint16_t offMs;
+};
+
+#include "module_core.h"
+#include "estop_link.h"
+#include "estop_latch.h"
+
+const uint32_t FIRMWARE_CAPABILITIES = CORE_CAPABILITIES;
+
+// Pins hardware
+const int LED_R_PIN = 25;
+const int LED_G_PIN = 26;
+const int LED_B_PIN = 27;
+const int STRIP_PIN = 14;                          // Données WS2812
+
+// Sorties RGB - PWM LEDC, les fondus sont exécutés par le matériel (ledc_set_fade_with_time)
+const ledc_mode_t LEDC_MODE = LEDC_LOW_SPEED_MODE;
+const ledc_timer_t LEDC_TIMER = LEDC_TIMER_0;
+const uint8_t LEDC_BITS = 13;
+const uint32_t LEDC_DUTY_MAX = (1UL << LEDC_BITS) - 1;
+const uint32_t LEDC_PWM_HZ = 5000;
+const ledc_channel_t LEDC_CHANNELS[3] = { LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2 };
+const int LEDC_PINS[3] = { LED_R_PIN, LED_G_PIN, LED_B_PIN };
+
+// Bande adressable WS2812 - trames émises par le RMT (timing matériel, CPU libre pendant l'envoi)
+const uint16_t STRIP_PIXELS = 30;
+const uint8_t STRIP_BITS_PER_PIXEL = 24;
+const size_t STRIP_SYMBOLS = STRIP_PIXELS * STRIP_BITS_PER_PIXEL;
+const uint32_t RMT_TICK_NS = 100;                  // Résolution RMT (10 MHz)
+const uint16_t WS_T0H = 4, WS_T0L = 8;             // Bit 0 : 0,4 µs haut / 0,8 µs bas
+const uint16_t WS_T1H = 8, WS_T1L = 4;             // Bit 1 : 0,8 µs haut / 0,4 µs bas
+const uint32_t STRIP_FRAME_US = 20000;             // 50 images/s pendant les fondus
+
+// Effets
+const uint32_t DEFAULT_FADE_MS = 250;              // Fondu par défaut d'allumage / extinction
+const uint32_t FADE_MAX_MS = 10000;
+const uint16_t BLINK_MIN_MS = 20;                  // Phase de clignotement la plus courte
+const uint8_t DEFAULT_BRIGHTNESS = 100;
+
+static_assert(STRIP_SYMBOLS * (WS_T0H + WS_T0L) * RMT_TICK_NS / 1000 + 100 < STRIP_FRAME_US,
+              "Une trame de bande doit être émise avant la suivante");
+
+enum LedEffect : uint8_t { EFFECT_OFF, EFFECT_STEADY, EFFECT_BLINK };
+
+const LedColor ESTOP_COLOR = { 255, 0, 0 };          // Éclairage fixe pendant un arrêt d'urgence
+
+// État lumineux courant (écrit par loop() uniquement ; l'arrêt d'urgence y est reporté par
+// checkEstopLight())
+struct LightState {
+  LedEffect effect;
+  LedColor color;              // Couleur demandée, avant luminosité
+  uint8_t brightness;          // 0-100
+  unsigned long fadeEndsMs;    // millis() de fin du fondu LEDC en cours
+};
+
+// Fondu de la bande - consigne posée sous stripMux par n'importe quelle tâche, images calculées et
+// émises par onStripFrame(), seul à écrire la trame RMT
+struct StripFade {
+  volatile bool active;
+  uint32_t startUs;
+  uint32_t durationUs;         // 0 = couleur émise à l'image suivante
+  LedColor from;
+  LedColor to;
+  LedColor current;            // Dernière image émise
+};
+
+// Clignotement - phases cadencées par esp_timer, écriture directe LEDC, bande confiée à onStripFrame()
+struct BlinkState {
+  volatile bool active;
+  volatile bool done;          // Fin de durée atteinte, signalée à loop()
+  bool phaseOn;
+  uint32_t onUs;
+  uint32_t offUs;
+  uint32_t startUs;
+  uint32_t durationUs;         // 0 = jusqu'à la commande suivante
+  LedColor color;              // Couleur déjà pondérée par la luminosité
+};
+
+LightState light = { EFFECT_OFF, { 255, 255, 255 }, DEFAULT_BRIGHTNESS, 0 };
+StripFade stripFade = {};
+portMUX_TYPE stripMux = portMUX_INITIALIZER_UNLOCKED;
+volatile bool estopLightPending = false;      // Éclairage d'arrêt posé par cutOutputs(), à reporter par loop()
+BlinkState blink = {};
+esp_timer_handle_t stripTimer = nullptr;
+esp_timer_handle_t blinkTimer = nullptr;
+
+// Trame RMT de la bande (un symbole par bit)
+rmt_data_t stripFrame[STRIP_SYMBOLS];
+#if ESP_ARDUINO_VERSION_MAJOR < 3
+rmt_obj_t* stripRmt = nullptr;
+#endif
+
+const uint8_t OP_LED_ON = 0x40;
+const uint8_t OP_LED_OFF = 0x41;
+const uint8_t OP_LED_BLINK = 0x42;
+
+static_assert(CORE_STATIC_BYTES + sizeof(stripFrame) <= STATIC_RAM_BUDGET_BYTES, "Budget RAM statique dépassé");
+
+// Déclarations des fonctions
+void setupLighting();
+void applyLight(LedEffect effect, LedColor color, uint8_t brightness, uint32_t fadeMs);
+void startBlink(LedColor color, uint8_t brightness, uint16_t onMs, uint16_t offMs, uint32_t durationMs);
+void stopBlink();
+void checkBlinkDone();
+void checkEstopLight();
+bool lightBusy();
+LedColor scaleColor(LedColor color, uint8_t brightness);
+void writeLedc(LedColor color, uint32_t fadeMs);
+void writeStrip(LedColor color);
+void startStripFade(LedColor to, uint32_t fadeMs);
+void onStripFrame(void* arg);
+void onBlinkPhase(void* arg);
+LedColor parseColor(const char* text, LedColor fallback);
+uint32_t fadeWithin(uint32_t fadeMs, uint32_t durationMs);
+const char* effectName(LedEffect effect);
+
+// Éclairage éteint, périphériques LEDC / RMT et timers d'effets
+void setupHardware() {
+  setupLighting();
+  applyLight(EFFECT_OFF, light.color, light.brightness, 0);
+}
+
+void serviceOutputs() {
+  checkBlinkDone();
+  checkEstop();
+  checkEstopLight();
+}
+
+// Fondu en cours, ou arrêt reçu hors de loop() pas encore traité par checkEstop()
+bool outputsBusy() {
+  return lightBusy() || estop.pending;
+}
+
+void parseCommandParams(CommandParams& params, JsonVariantConst data) {
+  params.color = parseColor(data["color"] | (const char*)nullptr, light.color);
+  params.brightness = constrain((int)(data["brightness"] | (int)DEFAULT_BRIGHTNESS), 0, 100);
+  params.fadeMs = data["fadeMs"] | DEFAULT_FADE_MS;
+  // Clignotement : onMs / offMs prioritaires, sinon on_time / off_time (secondes, format timeline)
+  float onS = data["on_time"] | 0.5f;
+  float offS = data["off_time"] | 0.5f;
+  params.onMs = data["onMs"] | (uint16_t)(onS * 1000);
+  params.offMs = data["offMs"] | (uint16_t)(offS * 1000);
+}
+
+void executeCommand(const QueuedCommand& queued) {
+  const char* command = queued.name;
+  const char* status = "success";
+
+  // Verrou d'arrêt d'urgence : seules la lecture d'état et la levée du verrou sont acceptées
+  if (estop.latched && strcmp(command, "get_state") && strcmp(command, "estop") && strcmp(command, "estop_reset")) {
+    sendCommandResponse(command, queued.id, "estop_latched");
+    return;
+  }
+
+  // Traitement des commandes - les effets tournent ensuite sur les périphériques
+  if (!strcmp(command, "turn_on")) {
+    applyLight(EFFECT_STEADY, queued.params.color, queued.params.brightness,
+               fadeWithin(queued.params.fadeMs, queued.durationMs));
+    Serial.printf(MC_TAG " 💡 Allumage #%02x%02x%02x à %u%%\n", queued.params.color.r, queued.params.color.g,
+                  queued.params.color.b, queued.params.brightness);
+
+  } else if (!strcmp(command, "turn_off")) {
+    applyLight(EFFECT_OFF, light.color, light.brightness, fadeWithin(queued.params.fadeMs, queued.durationMs));
+    Serial.println(MC_TAG " 🌑 Extinction");
+
+  } else if (!strcmp(command, "blink")) {
+    startBlink(queued.params.color, queued.params.brightness, queued.params.onMs, queued.params.offMs,
+               queued.durationMs);
+    Serial.printf(MC_TAG " ✨ Clignotement %u/%u ms pendant %lu ms\n", queued.params.onMs, queued.params.offMs,
+                  (unsigned long)queued.durationMs);
+
+  } else if (!strcmp(command, "estop")) {
+    // Voie lente (serveur) : même coupure que la trame LAN, signalée par checkEstop()
+    unsigned long startUs = micros();
+    emergencyStop(queued.id);
+    estop.handleUs = micros() - startUs;
+    return;
+
+  } else if (!strcmp(command, "estop_reset")) {
+    if (releaseEstop()) {
+      applyLight(EFFECT_OFF, light.color, light.brightness, 0);
+      Serial.println(MC_TAG " ✅ Verrou d'arrêt d'urgence levé");
+    } else {
+      status = "estop_latched";
+    }
+
+  } else if (!strcmp(command, "timeline_play")) {
+    startTimeline(queued);
+    return;
+
+  } else if (!strcmp(command, "timeline_stop")) {
+    if (timeline.playing) {
+      timeline.playing = false;
+      sendTimelineStatus("stopped");
+    }
+    Serial.println(MC_TAG " ⏹️ Timeline arrêtée");
+
+  } else if (!strcmp(command, "get_state")) {
+    // Pas de changement d'effet, juste retourner l'état
+    Serial.printf(MC_TAG " 📍 Effet actuel: %s\n", effectName(light.effect));
+
+  } else {
+    Serial.printf(MC_TAG " ❌ Commande inconnue: %s\n", command);
+    status = "unknown_command";
+  }
+
+  // Envoyer la réponse de commande (WebSocket natif)
+  sendCommandResponse(command, queued.id, status);
+}
+
+// ============================================================================
+// EFFETS LUMINEUX - LEDC (fondus matériels) et RMT (trames de bande)
+// ============================================================================
+
+void setupLighting() {
+  ledc_timer_config_t timerConfig = {};
+  timerConfig.speed_mode = LEDC_MODE;
+  timerConfig.duty_resolution = (ledc_timer_bit_t)LEDC_BITS;
+  timerConfig.timer_num = LEDC_TIMER;
+  timerConfig.freq_hz = LEDC_PWM_HZ;
+  timerConfig.clk_cfg = LEDC_AUTO_CLK;
+  ledc_timer_config(&timerConfig);
+
+  for (uint8_t i = 0; i < 3; i++) {
+    ledc_channel_config_t channelConfig = {};
+    channelConfig.gpio_num = LEDC_PINS[i];
+    channelConfig.speed_mode = LEDC_MODE;
+    channelConfig.channel = LEDC_CHANNELS[i];
+    channelConfig.timer_sel = LEDC_TIMER;
+    channelConfig.duty = 0;
+    ledc_channel_config(&channelConfig);
+  }
+  ledc_fade_func_install(0);
+
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  rmtInit(STRIP_PIN, RMT_TX_MODE, RMT_MEM_NUM_BLOCKS_1, 1000000000UL / RMT_TICK_NS);
+#else
+  stripRmt = rmtInit(STRIP_PIN, RMT_TX_MODE, RMT_MEM_64);
+  rmtSetTick(stripRmt, RMT_TICK_NS);
+#endif
+
+  esp_timer_create_args_t stripArgs = {};
+  stripArgs.callback = &onStripFrame;
+  stripArgs.name = "strip";
+  esp_timer_create(&stripArgs, &stripTimer);
+
+  esp_timer_create_args_t blinkArgs = {};
+  blinkArgs.callback = &onBlinkPhase;
+  blinkArgs.name = "blink";
+  esp_timer_create(&blinkArgs, &blinkTimer);
+}
+
+// Allumage / extinction avec fondu : LEDC seul pour le RGB, une image toutes les 20 ms pour la bande
+void applyLight(LedEffect effect, LedColor color, uint8_t brightness, uint32_t fadeMs) {
+  stopBlink();
+
+  light.effect = effect;
+  light.color = color;
+  light.brightness = brightness;
+
+  LedColor target = effect == EFFECT_OFF ? LedColor{ 0, 0, 0 } : scaleColor(color, brightness);
+  writeLedc(target, fadeMs);
+  light.fadeEndsMs = millis() + fadeMs;
+  startStripFade(target, fadeMs);
+}
+
+void startBlink(LedColor color, uint8_t brightness, uint16_t onMs, uint16_t offMs, uint32_t durationMs) {
+  stopBlink();
+
+  light.effect = EFFECT_BLINK;
+  light.color = color;
+  light.brightness = brightness;
+  light.fadeEndsMs = millis();
+
+  blink.color = scaleColor(color, brightness);
+  blink.onUs = (uint32_t)max(onMs, BLINK_MIN_MS) * 1000;
+  blink.offUs = (uint32_t)max(offMs, BLINK_MIN_MS) * 1000;
+  blink.durationUs = durationMs * 1000;
+  blink.startUs = (uint32_t)esp_timer_get_time();
+  blink.phaseOn = true;
+  blink.done = false;
+  blink.active = true;
+
+  writeLedc(blink.color, 0);
+  startStripFade(blink.color, 0);
+  esp_timer_start_once(blinkTimer, blink.onUs);
+}
+
+void stopBlink() {
+  if (!blink.active) return;
+  esp_timer_stop(blinkTimer);
+  blink.active = false;
+}
+
+// Fin de durée d'un clignotement : retour à l'état éteint
+void checkBlinkDone() {
+  if (!blink.done) return;
+  blink.done = false;
+  light.effect = EFFECT_OFF;
+  Serial.println(MC_TAG " ✨ Clignotement terminé");
+}
+
+// Arrêt d'urgence coupé hors de loop() : l'éclairage rouge fixe passe dans l'état lumineux
+void checkEstopLight() {
+  if (!estopLightPending) return;
+  estopLightPending = false;
+  light.effect = EFFECT_STEADY;
+  light.color = ESTOP_COLOR;
+  light.brightness = 100;
+  light.fadeEndsMs = millis();
+}
+
+// Un fondu LEDC ne peut pas être interrompu : les effets suivants attendent sa fin
+bool lightBusy() {
+  return (long)(millis() - light.fadeEndsMs) < 0;
+}
+
+LedColor scaleColor(LedColor color, uint8_t brightness) {
+  brightness = min(brightness, (uint8_t)100);
+  return LedColor{ (uint8_t)(color.r * brightness / 100), (uint8_t)(color.g * brightness / 100),
+                   (uint8_t)(color.b * brightness / 100) };
+}
+
+// Rapport cyclique avec correction gamma 2 ; le fondu est réalisé par le matériel LEDC
+void writeLedc(LedColor color, uint32_t fadeMs) {
+  const uint8_t levels[3] = { color.r, color.g, color.b };
+
+  for (uint8_t i = 0; i < 3; i++) {
+    uint32_t duty = (uint32_t)levels[i] * levels[i] * LEDC_DUTY_MAX / (255UL * 255UL);
+    if (fadeMs > 0) {
+      ledc_set_fade_with_time(LEDC_MODE, LEDC_CHANNELS[i], duty, fadeMs);
+      ledc_fade_start(LEDC_MODE, LEDC_CHANNELS[i], LEDC_FADE_NO_WAIT);
+    } else {
+      ledc_set_duty_and_update(LEDC_MODE, LEDC_CHANNELS[i], duty, 0);
+    }
+  }
+}
+
+// Encode une couleur uniforme (ordre GRB, bit de poids fort en premier) et lance l'émission RMT ;
+// appelé par onStripFrame() uniquement
+void writeStrip(LedColor color) {
+  const uint8_t grb[3] = { color.g, color.r, color.b };
+
+  size_t i = 0;
+  for (uint8_t channel = 0; channel < 3; channel++) {
+    for (int8_t bit = 7; bit >= 0; bit--) {
+      bool one = (grb[channel] >> bit) & 1;
+      stripFrame[i].level0 = 1;
+      stripFrame[i].duration0 = one ? WS_T1H : WS_T0H;
+      stripFrame[i].level1 = 0;
+      stripFrame[i].duration1 = one ? WS_T1L : WS_T0L;
+      i++;
+    }
+  }
+  // Pixels suivants : copie du premier
+  for (uint16_t pixel = 1; pixel < STRIP_PIXELS; pixel++) {
+    memcpy(&stripFrame[pixel * STRIP_BITS_PER_PIXEL], stripFrame, STRIP_BITS_PER_PIXEL * sizeof(rmt_data_t));
+  }
+
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  rmtWriteAsync(STRIP_PIN, stripFrame, STRIP_SYMBOLS);
+#else
+  rmtWrite(stripRmt, stripFrame, STRIP_SYMBOLS);
+#endif
+}
+
+// Nouvelle consigne de bande (fondu, ou couleur immédiate si fadeMs = 0) ; appelable depuis loop(),
+// la tâche WiFi ou la tâche esp_timer, la première image part sans attendre
+void startStripFade(LedColor to, uint32_t fadeMs) {
+  portENTER_CRITICAL(&stripMux);
+  stripFade.from = stripFade.current;
+  stripFade.to = to;
+  stripFade.durationUs = fadeMs * 1000;
+  stripFade.startUs = (uint32_t)esp_timer_get_time();
+  stripFade.active = true;
+  portEXIT_CRITICAL(&stripMux);
+
+  // Timer déjà réarmé par une image en cours : elle reprend la nouvelle consigne à l'échéance
+  esp_timer_stop(stripTimer);
+  esp_timer_start_once(stripTimer, 0);
+}
+
+// Exécuté dans la tâche esp_timer, toutes les STRIP_FRAME_US tant que le fondu dure
+void onStripFrame(void* arg) {
+  portENTER_CRITICAL(&stripMux);
+  if (!stripFade.active) {
+    portEXIT_CRITICAL(&stripMux);
+    return;
+  }
+
+  uint32_t elapsed = (uint32_t)esp_timer_get_time() - stripFade.startUs;
+  bool finished = elapsed >= stripFade.durationUs;
+  LedColor frame = stripFade.to;
+  if (!finished) {
+    // Interpolation linéaire en virgule fixe Q16
+    uint32_t t = (uint32_t)(((uint64_t)elapsed << 16) / stripFade.durationUs);
+    frame = {
+      (uint8_t)(stripFade.from.r + (((int32_t)stripFade.to.r - stripFade.from.r) * (int32_t)t >> 16)),
+      (uint8_t)(stripFade.from.g + (((int32_t)stripFade.to.g - stripFade.from.g) * (int32_t)t >> 16)),
+      (uint8_t)(stripFade.from.b + (((int32_t)stripFade.to.b - stripFade.from.b) * (int32_t)t >> 16)),
+    };
+  }
+  stripFade.current = frame;
+  stripFade.active = !finished;
+  portEXIT_CRITICAL(&stripMux);
+
+  writeStrip(frame);
+  if (!finished) esp_timer_start_once(stripTimer, STRIP_FRAME_US);
+}
+
+// Exécuté dans la tâche esp_timer à chaque changement de phase du clignotement
+void onBlinkPhase(void* arg) {
+  if (!blink.active) return;
+
+  uint32_t elapsed = (uint32_t)esp_timer_get_time() - blink.startUs;
+  if (blink.durationUs > 0 && elapsed >= blink.durationUs) {
+    writeLedc(LedColor{ 0, 0, 0 }, 0);
+    startStripFade(LedColor{ 0, 0, 0 }, 0);
+    blink.active = false;
+    blink.done = true;
+    return;
+  }
+
+  blink.phaseOn = !blink.phaseOn;
+  LedColor color = blink.phaseOn ? blink.color : LedColor{ 0, 0, 0 };
+  writeLedc(color, 0);
+  startStripFade(color, 0);
+  esp_timer_start_once(blinkTimer, blink.phaseOn ? blink.onUs : blink.offUs);
+}
+
+// "#rrggbb" -> couleur (valeur par défaut si absente ou invalide)
+LedColor parseColor(const char* text, LedColor fallback) {
+  if (!text) return fallback;
+  if (*text == '#') text++;
+  if (strlen(text) != 6) return fallback;
+
+  char* end = nullptr;
+  uint32_t rgb = strtoul(text, &end, 16);
+  if (*end != '\0') return fallback;
+  return LedColor{ (uint8_t)(rgb >> 16), (uint8_t)(rgb >> 8), (uint8_t)rgb };
+}
+
+// Un fondu ne dépasse jamais la fenêtre déclarée par la timeline
+uint32_t fadeWithin(uint32_t fadeMs, uint32_t durationMs) {
+  if (fadeMs > FADE_MAX_MS) fadeMs = FADE_MAX_MS;
+  if (durationMs > 0 && fadeMs > durationMs) fadeMs = durationMs;
+  return fadeMs;
+}
+
+// ============================================================================
+// ARRÊT D'URGENCE LAN
+// ============================================================================
+
+// Appelé par emergencyStop() (tâche WiFi) ou checkEstop() : effets arrêtés, éclairage rouge fixe pour
+// signaler l'arrêt. La bande est émise par onStripFrame(), l'état lumineux mis à jour par loop()
+void cutOutputs() {
+  esp_timer_stop(blinkTimer);
+  blink.active = false;
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  // Fondu LEDC en cours interrompu (IDF 5) ; sinon la couleur d'arrêt s'applique à sa fin
+  for (uint8_t i = 0; i < 3; i++) {
+    ledc_fade_stop(LEDC_MODE, LEDC_CHANNELS[i]);
+  }
+#endif
+  writeLedc(ESTOP_COLOR, 0);
+  startStripFade(ESTOP_COLOR, 0);
+  estopLightPending = true;
+}
+
+// ============================================================================
+// TIMELINES COMPILÉES
+// ============================================================================
+
+// Taille des opérandes par opcode (-1 : opcode non pris en charge par ce module)
+int8_t timelineOperandBytes(uint8_t opcode) {
+  switch (opcode) {
+    case OP_LED_ON:    return 4;  // luminosité, r, g, b
+    case OP_LED_OFF:   return 0;
+    case OP_LED_BLINK: return 4;  // phase allumée u16, phase éteinte u16
+    default:           return -1;
+  }
+}
+
+void executeTimelineStep(uint8_t opcode, uint16_t durationMs, const uint8_t* operands) {
+  if (opcode == OP_LED_ON) {
+    LedColor color = { operands[1], operands[2], operands[3] };
+    applyLight(EFFECT_STEADY, color, operands[0], fadeWithin(DEFAULT_FADE_MS, durationMs));
+  } else if (opcode == OP_LED_OFF) {
+    applyLight(EFFECT_OFF, light.color, light.brightness, fadeWithin(DEFAULT_FADE_MS, durationMs));
+  } else if (opcode == OP_LED_BLINK) {
+    startBlink(light.color, light.brightness, readU16(operands), readU16(operands + 2), durationMs);
+  }
+}
+
+// ============================================================================
+// MESSAGES D'ÉTAT
+// ============================================================================
+
+void writeModuleState(JsonDocument& doc, StateReport report) {
+  doc["effect"] = effectName(light.effect);
+  if (report == REPORT_RESPONSE || report == REPORT_TELEMETRY) doc["brightness"] = light.brightness;
+  if (report == REPORT_TELEMETRY) doc["estop"] = estop.latched;
+}
+
+void writeModuleSummaries(JsonObject summary) {
+}
+
+void onSessionChanged(bool authenticated) {
+}
+
+const char* effectName(LedEffect effect) {
+  switch (effect) {
+    case EFFECT_STEADY: return "on";
+    case EFFECT_BLINK:  return "blink";
+    default:            return "off";
+  }
+}
+
+void printModuleMemory() {
+  Serial.printf(MC_TAG "    Trame bande RMT   : %zu octets (%u pixels)\n", sizeof(stripFrame), STRIP_PIXELS);
+}
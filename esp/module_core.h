@@ -0,0 +1,1237 @@
+/*
+ * MicroCoaster - Cœur commun des firmwares ESP32
+ * Connexion et authentification, négociation du protocole, file de commandes, envoi
+ * (regroupement, compression), résumés de télémétrie et timelines compilées.
+ *
+ * Chaque firmware de esp/ inclut ce fichier une seule fois (une unité de compilation par
+ * firmware, un environnement par firmware dans esp/platformio.ini : ne jamais compiler deux
+ * sketches ensemble) et ne garde que son matériel. Avant l'inclusion, il définit :
+ *   MC_TAG, MODULE_NAME, MODULE_TYPE, MODULE_ID / MODULE_PASSWORD (hors banc natif),
+ *   JSON_TX_BYTES, JSON_TX_POOL_BYTES, STATIC_RAM_BUDGET_BYTES, TELEMETRY_SUMMARIES,
+ *   TIMELINE_MODULE_KIND, LOOP_IDLE_MS et struct CommandParams ;
+ * après l'inclusion : FIRMWARE_CAPABILITIES et les crochets déclarés plus bas.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WebSocketsClient.h>
+#include <ArduinoJson.h>
+#include <Preferences.h>
+
+// Configuration WiFi
+const char* ssid = "Freebox-73A72A";
+const char* password = "ChezCatherineetVincent";
+
+#ifdef MC_NATIVE_BENCH
+// Banc natif (sim/native) : serveur et identifiants fournis par l'environnement du processus
+#include "bench_config.h"
+#else
+// Configuration serveur WebSocket natif
+const char* server_host = "192.168.1.23";  // IP du serveur sur le réseau local
+const uint16_t server_port = 3000;
+const char* websocket_path = "/esp32"; // Path WebSocket dédié ESP32
+#endif
+const unsigned long RECONNECT_INTERVAL_MS = 5000;     // Délai de reconnexion normal
+const unsigned long RETRY_AFTER_MAX_MS = 120000;      // Délai maximum imposé par le serveur
+
+// Protocole - version et capacités annoncées au serveur (bits partagés avec websocket/protocol.js)
+const uint8_t PROTOCOL_VERSION = 1;
+const uint32_t CAP_COMMAND_QUEUE     = 1UL << 0;   // File de commandes, deadlineMs, statut expired
+const uint32_t CAP_TELEMETRY_SUMMARY = 1UL << 1;   // Résumés statistiques dans la télémétrie
+const uint32_t CAP_BATCHING          = 1UL << 3;   // Plusieurs messages par trame (enveloppe batch)
+const uint32_t CAP_COMPRESSION       = 1UL << 5;   // Trames compressées par dictionnaire partagé
+const uint32_t CAP_MOTION_PARAMS     = 1UL << 6;   // Paramètres speed / durationMs respectés
+const uint32_t CAP_TIMELINE_BYTECODE = 1UL << 7;   // Programmes de timeline compilés
+const uint32_t CAP_ESTOP_FRAMES      = 1UL << 8;   // Trames d'arrêt d'urgence LAN signées
+const uint32_t CAP_STATE_SEQUENCE    = 1UL << 9;   // Trames d'état numérotées (époque + séquence)
+const uint32_t CAP_SESSION_RESUME    = 1UL << 10;  // Reprise de session par ticket (redémarrage serveur)
+const uint32_t CORE_CAPABILITIES =                 // Portées par ce fichier, communes à tous les modules
+    CAP_COMMAND_QUEUE | CAP_TELEMETRY_SUMMARY | CAP_BATCHING | CAP_COMPRESSION | CAP_TIMELINE_BYTECODE |
+    CAP_ESTOP_FRAMES | CAP_STATE_SEQUENCE | CAP_SESSION_RESUME;
+extern const uint32_t FIRMWARE_CAPABILITIES;       // CORE_CAPABILITIES et capacités propres au module
+
+// ============================================================================
+// PLAN MÉMOIRE - toutes les capacités sont fixées à la compilation
+// Aucun String ni JsonDocument sur le tas : les documents JSON utilisent des
+// zones statiques, le régime établi n'appelle donc jamais malloc côté application.
+// Tampon et zone d'envoi, budget total et nombre de résumés sont fixés par le module.
+// ============================================================================
+const uint8_t COMMAND_QUEUE_SIZE = 8;              // Commandes en attente maximum
+const uint8_t COMMAND_NAME_MAX = 32;               // Taille max d'un nom de commande
+const size_t CREDENTIAL_MAX = 48;                  // Taille max de MODULE_ID / MODULE_PASSWORD
+const size_t SESSION_TICKET_MAX = 48;              // Ticket de reprise remis par le serveur
+const size_t RX_PAYLOAD_MAX = 1024;                // Message serveur maximum accepté
+const size_t JSON_RX_POOL_BYTES = 2048;            // Zone du document JSON reçu
+const size_t TIMELINE_MAX_BYTES = 1024;            // Programme de timeline maximum
+
+// Variables globales
+WebSocketsClient webSocket;
+unsigned long uptimeStart = 0;
+bool isAuthenticated = false;
+uint8_t protocolVersion = 0;        // Version négociée (0 = serveur ancien)
+uint32_t activeCapabilities = 0;    // Intersection des capacités serveur / firmware
+char sessionTicket[SESSION_TICKET_MAX] = ""; // Ticket de reprise (handover), à usage unique
+
+// Numérotation des trames d'état : l'époque est persistée en NVS et incrémentée à chaque
+// démarrage, la séquence croît en RAM dans l'époque et survit aux reconnexions
+Preferences nvs;
+uint32_t stateEpoch = 0;
+uint32_t stateSeq = 0;
+
+// File de commandes - exécutées dans loop(), hors du callback WebSocket
+// Le délai ne court que hors effet en cours : une commande derrière un mouvement plus long que
+// COMMAND_DEADLINE_MS (course lente d'aiguillage, fondu) n'expire pas pour autant
+const unsigned long COMMAND_DEADLINE_MS = 2000;    // Délai d'exécution par défaut
+const unsigned long COMMAND_DEADLINE_MAX_MS = 30000;
+
+struct QueuedCommand {
+  char name[COMMAND_NAME_MAX];
+  uint32_t id;               // Identifiant donné par le serveur, renvoyé dans la réponse (0 = aucun)
+  unsigned long receivedAt;  // millis() à la réception
+  unsigned long deadlineMs;  // Délai au-delà duquel la commande est expirée
+  uint32_t durationMs;       // Fenêtre de durée déclarée (0 = libre)
+  uint32_t programCrc;       // timeline_play : CRC du programme attendu
+  uint32_t startInMs;        // timeline_play : départ relatif à la réception
+  CommandParams params;      // Paramètres propres au module
+};
+
+QueuedCommand commandQueue[COMMAND_QUEUE_SIZE];
+uint8_t commandHead = 0;   // Index de la prochaine commande à exécuter
+uint8_t commandCount = 0;  // Nombre de commandes en attente
+unsigned long outputsBusyAt = 0;   // millis() du dernier effet en cours observé par la file
+
+// Timelines compilées - format partagé avec utils/TimelineCompiler.js (petit-boutiste)
+// en-tête "MCTL" | version | type | nb pas u16 | durée u32, pas : offset u32 | opcode | durée u16
+// | opérandes, puis CRC-32 final. Le programme est validé entièrement au chargement.
+const uint8_t TIMELINE_VERSION = 1;
+const size_t TIMELINE_HEADER_BYTES = 12;
+const size_t TIMELINE_STEP_BYTES = 7;
+const size_t TIMELINE_CRC_BYTES = 4;
+const uint8_t OP_END = 0x00;
+const unsigned long LOOP_TIMELINE_MS = 1;          // Pause de loop() pendant une timeline
+
+struct TimelineState {
+  bool loaded;
+  bool playing;
+  uint16_t length;           // Octets valides dans timelineProgram
+  uint16_t steps;            // Pas (END compris)
+  uint32_t crc;
+  uint16_t pc;               // Offset du prochain pas
+  unsigned long startMs;     // millis() du départ (offsets absolus, pas de dérive)
+  unsigned long maxLateMs;   // Plus grand retard d'un pas sur son offset
+};
+
+uint8_t timelineProgram[TIMELINE_MAX_BYTES];
+TimelineState timeline = {};
+
+// Résumés statistiques de télémétrie - entiers uniquement, fusionnables côté serveur
+// Histogramme log-linéaire (type HDR) : 4 sous-intervalles par puissance de 2
+const uint8_t SUMMARY_SUB_BITS = 2;
+const uint8_t SUMMARY_SUB_BUCKETS = 1 << SUMMARY_SUB_BITS;
+const uint8_t SUMMARY_BUCKETS = (32 - SUMMARY_SUB_BITS + 1) * SUMMARY_SUB_BUCKETS;
+const unsigned long SAMPLE_INTERVAL_MS = 1000;     // Échantillonnage RSSI et heap
+
+struct MetricSummary {
+  uint32_t count;
+  int32_t minValue;
+  int32_t maxValue;
+  int64_t sum;
+  uint64_t sumSquares;
+  bool negated;                        // Histogramme sur l'opposé (valeurs négatives, ex: RSSI)
+  uint16_t buckets[SUMMARY_BUCKETS];
+};
+
+MetricSummary rssiSummary = {};
+MetricSummary heapSummary = {};
+MetricSummary loopSummary = {};
+unsigned long summaryStart = 0;
+
+// Histogramme transmis en texte brut : "[[index,count],...]", au pire une paire par intervalle
+const size_t HISTOGRAM_PAIR_MAX = sizeof("[123,65535],") - 1;
+const size_t HISTOGRAM_TEXT_MAX = SUMMARY_BUCKETS * HISTOGRAM_PAIR_MAX + 3;
+const size_t TELEMETRY_FIXED_MAX = 1024;           // Champs hors histogrammes
+char histogramText[HISTOGRAM_TEXT_MAX];
+
+// Allocateur ArduinoJson sur zone statique (allocation linéaire, remise à zéro
+// quand le dernier bloc du document est libéré)
+class StaticPoolAllocator : public ArduinoJson::Allocator {
+ public:
+  StaticPoolAllocator(uint8_t* pool, size_t capacity) : pool_(pool), capacity_(capacity) {}
+
+  void* allocate(size_t size) override {
+    size_t needed = HEADER + align(size);
+    if (used_ + needed > capacity_) {
+      failures_++;
+      return nullptr;
+    }
+    uint8_t* block = pool_ + used_;
+    *reinterpret_cast<size_t*>(block) = size;
+    used_ += needed;
+    live_++;
+    if (used_ > peak_) peak_ = used_;
+    last_ = block + HEADER;
+    return last_;
+  }
+
+  void deallocate(void* ptr) override {
+    if (!ptr) return;
+    if (ptr == last_) {
+      used_ = static_cast<uint8_t*>(ptr) - HEADER - pool_;
+      last_ = nullptr;
+    }
+    if (--live_ == 0) {
+      used_ = 0;
+      last_ = nullptr;
+    }
+  }
+
+  void* reallocate(void* ptr, size_t newSize) override {
+    if (!ptr) return allocate(newSize);
+    size_t& size = *reinterpret_cast<size_t*>(static_cast<uint8_t*>(ptr) - HEADER);
+
+    // Dernier bloc : redimensionnement sur place
+    if (ptr == last_) {
+      size_t start = static_cast<uint8_t*>(ptr) - pool_;
+      if (start + align(newSize) > capacity_) {
+        failures_++;
+        return nullptr;
+      }
+      used_ = start + align(newSize);
+      size = newSize;
+      if (used_ > peak_) peak_ = used_;
+      return ptr;
+    }
+
+    if (newSize <= size) return ptr;
+
+    // Bloc intermédiaire : copie en fin de zone, l'ancien bloc est abandonné
+    void* moved = allocate(newSize);
+    if (!moved) return nullptr;
+    memcpy(moved, ptr, size);
+    live_--;
+    return moved;
+  }
+
+  size_t peak() const { return peak_; }
+  uint32_t failures() const { return failures_; }
+
+ private:
+  static const size_t HEADER = 8;
+  static size_t align(size_t size) { return (size + 7) & ~static_cast<size_t>(7); }
+
+  uint8_t* pool_;
+  size_t capacity_;
+  size_t used_ = 0;
+  size_t peak_ = 0;
+  uint32_t live_ = 0;
+  uint32_t failures_ = 0;
+  void* last_ = nullptr;
+};
+
+alignas(8) uint8_t jsonRxPool[JSON_RX_POOL_BYTES];
+alignas(8) uint8_t jsonTxPool[JSON_TX_POOL_BYTES];
+StaticPoolAllocator rxAllocator(jsonRxPool, sizeof(jsonRxPool));
+StaticPoolAllocator txAllocator(jsonTxPool, sizeof(jsonTxPool));
+
+// Trame sortante : l'en-tête WebSocket est écrit devant le JSON, sans copie
+uint8_t txFrame[WEBSOCKETS_MAX_HEADER_SIZE + JSON_TX_BYTES];
+
+// Trame reçue compressée, décompressée avant le parse
+uint8_t rxDecoded[RX_PAYLOAD_MAX];
+
+// Trame multi-messages (capacité BATCHING) : les messages d'un tour de boucle sont accumulés
+// dans txFrame derrière le début d'enveloppe, puis envoyés ensemble par flushSendBatch()
+const char BATCH_PREFIX[] = "{\"type\":\"batch\",\"messages\":[";
+const size_t BATCH_PREFIX_LEN = sizeof(BATCH_PREFIX) - 1;
+size_t sendBatchLength = 0;    // Octets accumulés, début d'enveloppe compris
+uint16_t sendBatchCount = 0;   // Messages en attente
+
+// ============================================================================
+// COMPRESSION DES TRAMES (capacité COMPRESSION)
+// Dictionnaire statique identique à celui du serveur (websocket/frame-codec.js) : chaque
+// entrée est remplacée par un code 0x01-0x1E (27 premières, hors \t \n \r) ou par 0x1F
+// suivi de 0x20 + rang. Un JSON sérialisé ne contient jamais ces octets bruts : une trame
+// compressée se reconnaît à son premier octet. L'ordre des entrées fait partie du format.
+// ============================================================================
+const uint8_t FRAME_DICTIONARY_ID = 1;
+const char* const FRAME_DICTIONARY[] = {
+  // Codes sur un octet
+  "{\"type\":\"", "\",\"password\":\"", ",\"moduleId\":\"MC-", ",\"seq\":", ",\"queueDepth\":",
+  "\",\"uptime\":", ",\"position\":\"", ",\"status\":\"", ",\"min\":", ",\"max\":", ",\"sum\":", ",\"sq\":",
+  ",\"h\":[[", "],[", "]]}", "telemetry\",\"epoch\":", "heartbeat\",\"epoch\":",
+  "command_response\",\"epoch\":", ",\"summary\":{\"intervalMs\":", ",\"rssi\":{\"n\":", ",\"heap\":{\"n\":",
+  ",\"loopUs\":{\"n\":", ",\"neg\":1", ",\"estop\":false", "\",\"command\":\"",
+  "command\",\"data\":{\"command\":\"", "},\"timestamp\":\"20",
+  // Codes sur deux octets
+  ",\"wifiRSSI\":", ",\"freeHeap\":", ",\"minFreeHeap\":", ",\"durationMs\":", ",\"requestedMs\":",
+  ",\"codec\":{\"tx\":", ",\"txWire\":", ",\"encodeUs\":", ",\"rx\":", ",\"rxWire\":", ",\"decodeUs\":",
+  "timeline_status\",\"epoch\":", "estop_event\",\"epoch\":", "batch\",\"messages\":[",
+  "ping\",\"timestamp\":", "connected\",\"status\":\"authenticated\",\"initialState\":{\"uptime\":",
+  ",\"protocol\":{\"version\":", ",\"capabilities\":", "resync\",\"missing\":",
+  "retry_later\",\"retryAfterMs\":", "operational\"", "left\"", "right\"", "success\"", "expired\"",
+  "queue_full\"", "estop_latched\"", "no_program\"", "preempted\"", "latched\"", "switch_left\"",
+  "switch_right\"", "get_position\"", "get_state\"", "get_speed\"", "set_speed\"", "gradual_change\"",
+  "turn_on\"", "turn_off\"", "blink\"", "timeline_play\"", "timeline_stop\"", "estop_reset\"", ",\"speed\":",
+  ",\"targetSpeed\":", ",\"deadlineMs\":", ",\"duration\":", ",\"brightness\":", ",\"effect\":\"",
+  ",\"reason\":\"", ",\"steps\":", ",\"crc\":", ",\"lateMs\":", ",\"estop\":true", ",\"stopUs\":{\"n\":",
+  ",\"acks\":[{\"moduleId\":\"MC-", "},{\"moduleId\":\"MC-", ",\"latencyUs\":", ",\"handleUs\":",
+  ",\"sequence\":", ",\"source\":\"", ",\"state\":\"", ",\"duty\":", ",\"tracking\":", ",\"worstUs\":",
+  ",\"worstStopUs\":", ",\"worstEverUs\":"
+};
+const uint8_t FRAME_DICTIONARY_SIZE = sizeof(FRAME_DICTIONARY) / sizeof(FRAME_DICTIONARY[0]);
+const uint8_t FRAME_SHORT_CODES = 27;
+const uint8_t FRAME_SHORT_BYTES[FRAME_SHORT_CODES] = {
+  0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x0B, 0x0C, 0x0E, 0x0F, 0x10, 0x11,
+  0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E
+};
+const uint8_t FRAME_EXTENDED_CODE = 0x1F;
+const uint8_t FRAME_EXTENDED_BASE = 0x20;
+
+// Index construit au démarrage (initFrameCodec) : entrées triées par premier octet puis
+// longueur décroissante, pour ne comparer à chaque position que les candidates possibles
+struct FrameCodecIndex {
+  uint8_t length[FRAME_DICTIONARY_SIZE];
+  uint8_t order[FRAME_DICTIONARY_SIZE];
+  uint8_t first[129];        // Plage de order par premier octet : [first[c], first[c + 1])
+  int8_t shortEntry[32];     // Entrée de chaque code court (-1 : pas un code court)
+};
+FrameCodecIndex frameCodec;
+
+// Coût du codec sur l'intervalle de télémétrie : octets JSON / octets transmis / durée
+struct CodecStats {
+  uint32_t tx, txWire, encodeUs;
+  uint32_t rx, rxWire, decodeUs;
+};
+CodecStats codecStats = {};
+
+// RAM statique du cœur ; chaque module y ajoute ses propres tampons dans son budget
+const size_t CORE_STATIC_BYTES = sizeof(commandQueue) + TELEMETRY_SUMMARIES * sizeof(MetricSummary) +
+                                 sizeof(histogramText) + sizeof(timelineProgram) + sizeof(jsonRxPool) +
+                                 sizeof(jsonTxPool) + sizeof(txFrame) + sizeof(rxDecoded) +
+                                 sizeof(frameCodec) + sizeof(sessionTicket);
+
+// Vérifications du plan mémoire à la compilation
+static_assert(COMMAND_QUEUE_SIZE > 0 && COMMAND_QUEUE_SIZE < UINT8_MAX, "File de commandes hors limites");
+static_assert(SUMMARY_BUCKETS <= UINT8_MAX, "Index d'histogramme sur 8 bits");
+static_assert(sizeof(MODULE_ID) <= CREDENTIAL_MAX && sizeof(MODULE_PASSWORD) <= CREDENTIAL_MAX,
+              "Identifiants du module trop longs");
+static_assert(JSON_RX_POOL_BYTES >= 2 * RX_PAYLOAD_MAX, "Zone JSON reçue trop petite pour RX_PAYLOAD_MAX");
+static_assert(JSON_TX_BYTES >= TELEMETRY_FIXED_MAX + TELEMETRY_SUMMARIES * HISTOGRAM_TEXT_MAX,
+              "Tampon d'envoi trop petit pour une télémétrie complète");
+static_assert(JSON_TX_POOL_BYTES >= JSON_TX_BYTES + 1024,
+              "Zone JSON d'envoi trop petite pour le tampon d'envoi");
+static_assert(BATCH_PREFIX_LEN >= WEBSOCKETS_MAX_HEADER_SIZE,
+              "Un message seul doit pouvoir être envoyé depuis la trame multi-messages");
+static_assert(FRAME_DICTIONARY_SIZE <= FRAME_SHORT_CODES + (0x7F - FRAME_EXTENDED_BASE),
+              "Dictionnaire de trames hors de l'espace des codes");
+static_assert(TIMELINE_MAX_BYTES <= UINT16_MAX, "Offsets de timeline sur 16 bits");
+static_assert(CORE_STATIC_BYTES <= STATIC_RAM_BUDGET_BYTES, "Budget RAM statique dépassé");
+
+// Message d'état pour lequel le module complète les champs qui lui sont propres
+enum StateReport : uint8_t { REPORT_IDENTIFY, REPORT_RESPONSE, REPORT_HEARTBEAT, REPORT_TELEMETRY };
+
+// ============================================================================
+// CROCHETS DU MODULE - définis par chaque firmware après l'inclusion
+// ============================================================================
+void setupHardware();                              // Sorties au repos, périphériques et timers
+void setupStopListener();                          // Réception ESP-NOW (arrêt ou acquittements)
+void serviceOutputs();                             // Début de loop() : fins d'effet, arrêt d'urgence
+bool outputsBusy();                                // Effet en cours : file et timeline attendent sa fin
+void parseCommandParams(CommandParams& params, JsonVariantConst data);
+void executeCommand(const QueuedCommand& queued);
+int8_t timelineOperandBytes(uint8_t opcode);       // -1 : opcode non pris en charge par ce module
+void executeTimelineStep(uint8_t opcode, uint16_t durationMs, const uint8_t* operands);
+void writeModuleState(JsonDocument& doc, StateReport report);
+void writeModuleSummaries(JsonObject summary);     // summary nul si les résumés ne sont pas négociés
+void onSessionChanged(bool authenticated);         // Authentifié, ou session perdue
+void printModuleMemory();
+
+// Déclarations des fonctions
+void connectWiFi();
+void connectSocket();
+void webSocketEvent(WStype_t type, uint8_t * payload, size_t length);
+void authenticateModule();
+void dispatchMessage(JsonVariantConst doc);
+void handleConnected(JsonVariantConst doc);
+void handleCommand(JsonVariantConst doc);
+void processCommandQueue();
+void clearCommandQueue(const char* status = nullptr);
+void handleTimelineProgram(const uint8_t* data, size_t length);
+const char* validateTimeline(const uint8_t* data, size_t length, uint16_t& steps);
+void startTimeline(const QueuedCommand& queued);
+void runTimeline();
+void sendTimelineStatus(const char* status, const char* reason = nullptr);
+uint32_t crc32(const uint8_t* data, size_t length);
+uint16_t readU16(const uint8_t* p);
+uint32_t readU32(const uint8_t* p);
+void handleError(JsonVariantConst doc);
+void loadStateEpoch();
+void stampState(JsonDocument& doc);
+bool sendDocument(JsonDocument& doc);
+void flushSendBatch();
+bool sendFrame(uint8_t* frame, size_t length);
+void initFrameCodec();
+size_t encodeFrame(char* data, size_t length);
+size_t decodeFrame(const uint8_t* in, size_t length, uint8_t* out, size_t capacity);
+void writeCommandResponse(JsonDocument& doc, const char* command, uint32_t commandId, const char* status);
+void sendCommandResponse(const char* command, uint32_t commandId, const char* status, long durationMs = -1,
+                         uint32_t requestedMs = 0);
+void sendHeartbeat();
+void sendTelemetry();
+uint8_t summaryBucket(uint32_t value);
+void recordSample(MetricSummary& summary, int32_t value);
+void resetSummary(MetricSummary& summary);
+void writeSummary(JsonObject target, const MetricSummary& summary);
+void printMemoryPlan();
+
+void setup() {
+  Serial.begin(115200);
+  Serial.printf(MC_TAG " 🚀 ESP32 %s démarrant...\n", MODULE_NAME);
+
+  uptimeStart = millis();
+  rssiSummary.negated = true;
+  summaryStart = uptimeStart;
+  printMemoryPlan();
+  loadStateEpoch();
+  initFrameCodec();
+
+  // Sorties au repos, périphériques et timers du module
+  setupHardware();
+
+  // Connexion WiFi
+  connectWiFi();
+
+  // Trames d'arrêt d'urgence (ESP-NOW, canal du WiFi station)
+  setupStopListener();
+
+  // Connexion Socket.io
+  connectSocket();
+}
+
+void loop() {
+  static unsigned long lastWiFiCheck = 0;
+  static unsigned long lastHeartbeat = 0;
+  static unsigned long lastTelemetry = 0;
+  static unsigned long lastSample = 0;
+  unsigned long now = millis();
+  unsigned long loopStartUs = micros();
+
+  // Fins d'effet, arrêt d'urgence et timeline : indépendants de la connexion
+  serviceOutputs();
+  runTimeline();
+
+  // Monitoring WiFi continu
+  if (now - lastWiFiCheck > 10000) { // Vérifier toutes les 10 secondes
+    lastWiFiCheck = now;
+    Serial.printf(MC_TAG " 📶 WiFi: %d - RSSI: %d dBm\n", WiFi.status(), WiFi.RSSI());
+  }
+
+  // Vérifier la connexion WiFi avant WebSocket
+  if (WiFi.status() == WL_CONNECTED) {
+    webSocket.loop();
+
+    // Exécuter les commandes en attente (reçues pendant webSocket.loop)
+    processCommandQueue();
+
+    // Échantillonner signal et mémoire pour les résumés de télémétrie
+    if (now - lastSample >= SAMPLE_INTERVAL_MS) {
+      recordSample(rssiSummary, WiFi.RSSI());
+      recordSample(heapSummary, (int32_t)ESP.getFreeHeap());
+      lastSample = now;
+    }
+
+    // Envoyer heartbeat si authentifié
+    if (isAuthenticated && now - lastHeartbeat > 30000) { // Toutes les 30 secondes
+      sendHeartbeat();
+      lastHeartbeat = now;
+    }
+
+    // Envoyer télémétrie périodique si authentifié
+    if (isAuthenticated && now - lastTelemetry > 10000) { // Toutes les 10 secondes
+      sendTelemetry();
+      lastTelemetry = now;
+    }
+
+  } else {
+    Serial.println(MC_TAG " ⚠️ WiFi déconnecté - reconnexion...");
+    isAuthenticated = false;
+    connectWiFi();
+    if (WiFi.status() == WL_CONNECTED) {
+      connectSocket();
+    }
+  }
+
+  // Messages émis pendant ce tour : une seule trame si le serveur accepte les regroupements
+  flushSendBatch();
+
+  // Durée de travail de la boucle (hors delay)
+  recordSample(loopSummary, (int32_t)(micros() - loopStartUs));
+
+  delay(timeline.playing ? LOOP_TIMELINE_MS : LOOP_IDLE_MS);
+}
+
+void connectWiFi() {
+  Serial.print(MC_TAG " 🌐 Connexion WiFi à ");
+  Serial.println(ssid);
+
+  // Configuration WiFi pour stabilité
+  WiFi.mode(WIFI_STA);
+  WiFi.setSleep(false); // Désactiver le sleep WiFi
+  WiFi.setAutoReconnect(true);
+  WiFi.persistent(true);
+
+  WiFi.begin(ssid, password);
+
+  int attempts = 0;
+  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
+    delay(500);
+    Serial.print(".");
+    attempts++;
+  }
+
+  if (WiFi.status() == WL_CONNECTED) {
+    Serial.println();
+    Serial.print(MC_TAG " ✅ WiFi connecté - IP: ");
+    Serial.println(WiFi.localIP());
+    Serial.print(MC_TAG " 📶 Signal WiFi: ");
+    Serial.print(WiFi.RSSI());
+    Serial.println(" dBm");
+  } else {
+    Serial.println();
+    Serial.println(MC_TAG " ❌ Échec connexion WiFi");
+    delay(5000); // Attendre avant retry
+  }
+}
+
+void connectSocket() {
+  Serial.println(MC_TAG " 🔗 Connexion WebSocket natif...");
+  Serial.printf(MC_TAG " 📍 Module ID: %s\n", MODULE_ID);
+  Serial.printf(MC_TAG " 🔑 Password: %.8s...\n", MODULE_PASSWORD);
+
+  // Configuration WebSocket natif (Solution A)
+  webSocket.begin(server_host, server_port, websocket_path);
+  webSocket.onEvent(webSocketEvent);
+  webSocket.setReconnectInterval(RECONNECT_INTERVAL_MS);
+  webSocket.enableHeartbeat(15000, 3000, 2);
+
+  Serial.printf(MC_TAG " 🤖 WebSocket: ws://%s:%d%s\n", server_host, server_port, websocket_path);
+  Serial.printf(MC_TAG " ✅ ESP32 %s prêt (Architecture hybride)!\n", MODULE_NAME);
+}
+
+void webSocketEvent(WStype_t type, uint8_t * payload, size_t length) {
+  switch(type) {
+    case WStype_CONNECTED:
+      Serial.println(MC_TAG " 🟢 Connecté au serveur WebSocket");
+      webSocket.setReconnectInterval(RECONNECT_INTERVAL_MS);
+      authenticateModule();
+      break;
+
+    case WStype_DISCONNECTED:
+      Serial.println(MC_TAG " 🔴 Déconnexion du serveur");
+      isAuthenticated = false;
+      sendBatchCount = 0; // Messages en attente perdus avec la connexion
+      sendBatchLength = 0;
+      clearCommandQueue();
+      onSessionChanged(false);
+      break;
+
+    case WStype_TEXT: {
+      // Trame compressée : commence par un code du dictionnaire, jamais par "{"
+      if (length > 0 && payload[0] < 0x20) {
+        unsigned long startUs = micros();
+        size_t decoded = decodeFrame(payload, length, rxDecoded, sizeof(rxDecoded));
+        if (decoded == 0) {
+          Serial.printf(MC_TAG " ⚠️ Trame compressée ignorée - invalide ou plus de %zu octets\n", RX_PAYLOAD_MAX);
+          break;
+        }
+        codecStats.decodeUs += micros() - startUs;
+        codecStats.rx += decoded;
+        codecStats.rxWire += length;
+        payload = rxDecoded;
+        length = decoded;
+      }
+
+      Serial.printf(MC_TAG " 📡 Message reçu: %.*s\n", (int)length, (const char*)payload);
+
+      if (length > RX_PAYLOAD_MAX) {
+        Serial.printf(MC_TAG " ⚠️ Message ignoré - %zu octets (max %zu)\n", length, RX_PAYLOAD_MAX);
+        break;
+      }
+
+      // Parse unique dans la zone statique de réception
+      JsonDocument doc(&rxAllocator);
+      DeserializationError error = deserializeJson(doc, (const char*)payload, length);
+      if (error) {
+        Serial.printf(MC_TAG " ⚠️ JSON invalide: %s\n", error.c_str());
+        break;
+      }
+
+      dispatchMessage(doc);
+      break;
+    }
+
+    case WStype_BIN:
+      // Seule trame binaire du protocole : un programme de timeline compilé
+      if (isAuthenticated && (activeCapabilities & CAP_TIMELINE_BYTECODE)) {
+        handleTimelineProgram(payload, length);
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+// Aiguille un message du serveur selon son type
+void dispatchMessage(JsonVariantConst doc) {
+  const char* msgType = doc["type"] | "";
+
+  if (strcmp(msgType, "batch") == 0) {
+    // Trame multi-messages : chaque message est traité comme s'il était arrivé seul
+    for (JsonVariantConst message : doc["messages"].as<JsonArrayConst>()) {
+      if (strcmp(message["type"] | "", "batch") != 0) dispatchMessage(message);
+    }
+  } else if (strcmp(msgType, "connected") == 0) {
+    handleConnected(doc);
+  } else if (strcmp(msgType, "command") == 0) {
+    handleCommand(doc);
+  } else if (strcmp(msgType, "error") == 0) {
+    handleError(doc);
+  } else if (strcmp(msgType, "resync") == 0) {
+    // Trou dans les séquences reçues par le serveur : renvoyer l'état complet
+    Serial.println(MC_TAG " 🔁 Resynchronisation demandée par le serveur");
+    sendTelemetry();
+  } else if (strcmp(msgType, "retry_later") == 0) {
+    // Serveur surchargé : espacer la prochaine reconnexion selon son indication
+    unsigned long retryAfterMs = doc["retryAfterMs"] | RECONNECT_INTERVAL_MS;
+    retryAfterMs = constrain(retryAfterMs, RECONNECT_INTERVAL_MS, RETRY_AFTER_MAX_MS);
+    webSocket.setReconnectInterval(retryAfterMs);
+    Serial.printf(MC_TAG " 🚦 Serveur surchargé - reconnexion dans %lu ms\n", retryAfterMs);
+  } else if (strcmp(msgType, "handover") == 0) {
+    // Redémarrage du serveur : reprendre la session par ticket, sans réauthentification
+    strlcpy(sessionTicket, doc["ticket"] | "", sizeof(sessionTicket));
+    unsigned long retryAfterMs = doc["retryAfterMs"] | 0UL;
+    retryAfterMs = constrain(retryAfterMs, 0UL, RECONNECT_INTERVAL_MS);
+    webSocket.setReconnectInterval(retryAfterMs);
+    Serial.printf(MC_TAG " 🔀 Redémarrage du serveur - reprise dans %lu ms\n", retryAfterMs);
+  } else {
+    Serial.printf(MC_TAG " ⚠️ Événement non géré: '%s'\n", msgType);
+  }
+}
+
+void authenticateModule() {
+  Serial.println(MC_TAG " 🔐 Authentification WebSocket natif...");
+
+  // Format WebSocket natif pour Solution A
+  JsonDocument authData(&txAllocator);
+  authData["type"] = "module_identify";
+  authData["moduleId"] = MODULE_ID;
+  authData["password"] = MODULE_PASSWORD;
+  authData["moduleType"] = MODULE_TYPE;
+  authData["uptime"] = millis() - uptimeStart;
+  writeModuleState(authData, REPORT_IDENTIFY);
+  authData["protocolVersion"] = PROTOCOL_VERSION;
+  authData["capabilities"] = FIRMWARE_CAPABILITIES;
+  authData["dictionary"] = FRAME_DICTIONARY_ID;
+  // Position courante : les trames perdues pendant la coupure ne sont pas prises pour un trou
+  authData["epoch"] = stateEpoch;
+  authData["seq"] = stateSeq;
+  // Ticket remis par le serveur sortant : le serveur suivant reprend la session sans bcrypt
+  if (sessionTicket[0]) authData["ticket"] = sessionTicket;
+
+  if (sendDocument(authData)) {
+    Serial.printf(MC_TAG " 📤 Authentification envoyée: %s\n", MODULE_ID);
+  }
+}
+
+void handleConnected(JsonVariantConst doc) {
+  Serial.println(MC_TAG " ✅ Module authentifié WebSocket natif");
+
+  // Capacités retenues par le serveur (absentes = serveur ancien, protocole de base)
+  protocolVersion = doc["protocol"]["version"] | 0;
+  activeCapabilities = (doc["protocol"]["capabilities"] | 0UL) & FIRMWARE_CAPABILITIES;
+  Serial.printf(MC_TAG " 🤝 Protocole v%u - capacités 0x%02lx\n", protocolVersion, (unsigned long)activeCapabilities);
+
+  // Session reprise après un redémarrage du serveur : le ticket est consommé
+  bool resumed = doc["resumed"] | false;
+  sessionTicket[0] = '\0';
+  if (resumed) Serial.println(MC_TAG " 🔀 Session reprise sans réauthentification");
+
+  isAuthenticated = true;
+  onSessionChanged(true);
+
+  // Envoyer télémétrie initiale (sans attente après une reprise : commandes servies aussitôt)
+  if (!resumed) delay(1000);
+  sendTelemetry();
+}
+
+void handleCommand(JsonVariantConst doc) {
+  if (!isAuthenticated) {
+    Serial.println(MC_TAG " ⚠️ Commande refusée - non authentifié");
+    return;
+  }
+
+  const char* command = doc["data"]["command"] | "";
+  uint32_t commandId = doc["data"]["id"] | 0UL;
+  Serial.printf(MC_TAG " 🎮 Commande reçue: %s\n", command);
+
+  // File pleine : refuser explicitement plutôt que bloquer
+  if (commandCount >= COMMAND_QUEUE_SIZE) {
+    Serial.printf(MC_TAG " ⚠️ File de commandes pleine - commande rejetée: %s\n", command);
+    sendCommandResponse(command, commandId, "queue_full");
+    return;
+  }
+
+  unsigned long deadlineMs = doc["data"]["deadlineMs"] | COMMAND_DEADLINE_MS;
+  if (deadlineMs == 0 || deadlineMs > COMMAND_DEADLINE_MAX_MS) {
+    deadlineMs = COMMAND_DEADLINE_MAX_MS;
+  }
+
+  QueuedCommand& slot = commandQueue[(commandHead + commandCount) % COMMAND_QUEUE_SIZE];
+  strlcpy(slot.name, command, COMMAND_NAME_MAX);
+  slot.id = commandId;
+  slot.receivedAt = millis();
+  slot.deadlineMs = deadlineMs;
+  // durationMs prioritaire ; "duration" (secondes) est le format des actions de timeline
+  float durationS = doc["data"]["duration"] | 0.0f;
+  slot.durationMs = doc["data"]["durationMs"] | (uint32_t)(durationS * 1000);
+  slot.programCrc = doc["data"]["crc"] | 0UL;
+  slot.startInMs = doc["data"]["startInMs"] | 0UL;
+  parseCommandParams(slot.params, doc["data"]);
+  commandCount++;
+
+  Serial.printf(MC_TAG " 📥 Commande en file (%u/%u)\n", commandCount, COMMAND_QUEUE_SIZE);
+}
+
+void processCommandQueue() {
+  // Les commandes attendent la fin de l'effet en cours, sans que leur deadline coure pendant ce temps
+  if (outputsBusy()) outputsBusyAt = millis();
+
+  while (commandCount > 0 && isAuthenticated && !outputsBusy()) {
+    QueuedCommand& next = commandQueue[commandHead];
+    commandHead = (commandHead + 1) % COMMAND_QUEUE_SIZE;
+    commandCount--;
+
+    // Attente comptée depuis la réception, ou depuis la fin du dernier effet s'il est plus récent
+    unsigned long since = (long)(outputsBusyAt - next.receivedAt) > 0 ? outputsBusyAt : next.receivedAt;
+    unsigned long waited = millis() - since;
+
+    // Commande périmée : ne pas actionner le matériel, signaler l'expiration
+    if (waited > next.deadlineMs) {
+      Serial.printf(MC_TAG " ⌛ Commande expirée: %s (%lu ms en file)\n", next.name, waited);
+      sendCommandResponse(next.name, next.id, "expired");
+      continue;
+    }
+
+    executeCommand(next);
+  }
+}
+
+// status : réponse envoyée pour chaque commande abandonnée (aucune si la session est perdue)
+void clearCommandQueue(const char* status) {
+  if (commandCount > 0) {
+    Serial.printf(MC_TAG " 🗑️ %u commande(s) en file abandonnée(s)\n", commandCount);
+  }
+  for (uint8_t i = 0; status && i < commandCount; i++) {
+    const QueuedCommand& dropped = commandQueue[(commandHead + i) % COMMAND_QUEUE_SIZE];
+    sendCommandResponse(dropped.name, dropped.id, status);
+  }
+  commandHead = 0;
+  commandCount = 0;
+}
+
+void handleError(JsonVariantConst doc) {
+  Serial.println(MC_TAG " ❌ Erreur reçue du serveur");
+
+  isAuthenticated = false;
+  clearCommandQueue();
+  onSessionChanged(false);
+}
+
+// ============================================================================
+// TIMELINES COMPILÉES - les opcodes et leur exécution sont fournis par le module
+// ============================================================================
+
+void handleTimelineProgram(const uint8_t* data, size_t length) {
+  uint16_t steps = 0;
+  const char* reason = validateTimeline(data, length, steps);
+  if (reason) {
+    Serial.printf(MC_TAG " ❌ Timeline rejetée: %s (%zu octets)\n", reason, length);
+    sendTimelineStatus("rejected", reason);
+    return;
+  }
+
+  // Un nouveau programme remplace le précédent, y compris en cours de lecture
+  if (timeline.playing) {
+    timeline.playing = false;
+    sendTimelineStatus("stopped");
+  }
+
+  memcpy(timelineProgram, data, length);
+  timeline.loaded = true;
+  timeline.length = length;
+  timeline.steps = steps;
+  timeline.crc = readU32(data + length - TIMELINE_CRC_BYTES);
+
+  Serial.printf(MC_TAG " 🎬 Timeline chargée: %u pas, %lu ms, CRC %08lx\n", steps,
+                (unsigned long)readU32(data + 8), (unsigned long)timeline.crc);
+  sendTimelineStatus("loaded");
+}
+
+const char* validateTimeline(const uint8_t* data, size_t length, uint16_t& steps) {
+  if (length < TIMELINE_HEADER_BYTES + TIMELINE_STEP_BYTES + TIMELINE_CRC_BYTES || length > TIMELINE_MAX_BYTES) {
+    return "bad_length";
+  }
+  if (memcmp(data, "MCTL", 4) != 0) return "bad_magic";
+  if (data[4] != TIMELINE_VERSION) return "bad_version";
+  if (data[5] != TIMELINE_MODULE_KIND) return "wrong_module";
+
+  size_t codeEnd = length - TIMELINE_CRC_BYTES;
+  if (crc32(data, codeEnd) != readU32(data + codeEnd)) return "bad_crc";
+
+  // Parcours complet : opcodes connus, offsets croissants, END en dernier pas
+  steps = readU16(data + 6);
+  size_t pc = TIMELINE_HEADER_BYTES;
+  uint32_t previousAt = 0;
+  for (uint16_t i = 0; i < steps; i++) {
+    if (pc + TIMELINE_STEP_BYTES > codeEnd) return "bad_program";
+    uint32_t atMs = readU32(data + pc);
+    int8_t operands = data[pc + 4] == OP_END ? 0 : timelineOperandBytes(data[pc + 4]);
+    if (operands < 0) return "unknown_opcode";
+    if (atMs < previousAt) return "bad_program";
+    if ((data[pc + 4] == OP_END) != (i == steps - 1)) return "bad_program";
+    previousAt = atMs;
+    pc += TIMELINE_STEP_BYTES + operands;
+  }
+  return pc == codeEnd ? nullptr : "bad_program";
+}
+
+void startTimeline(const QueuedCommand& queued) {
+  if (!timeline.loaded || (queued.programCrc && queued.programCrc != timeline.crc)) {
+    sendCommandResponse(queued.name, queued.id, "no_program");
+    return;
+  }
+
+  // Départ commun : relatif à la réception, pas à l'exécution depuis la file
+  timeline.startMs = queued.receivedAt + queued.startInMs;
+  timeline.pc = TIMELINE_HEADER_BYTES;
+  timeline.maxLateMs = 0;
+  timeline.playing = true;
+
+  Serial.printf(MC_TAG " ▶️ Timeline démarrée dans %lu ms\n", (unsigned long)queued.startInMs);
+  sendCommandResponse(queued.name, queued.id, "success");
+  sendTimelineStatus("playing");
+}
+
+void runTimeline() {
+  if (!timeline.playing) return;
+
+  unsigned long now = millis();
+  while (timeline.playing) {
+    const uint8_t* step = timelineProgram + timeline.pc;
+    uint32_t atMs = readU32(step);
+    long elapsed = (long)(now - timeline.startMs);
+    if (elapsed < (long)atMs) return;
+
+    uint8_t opcode = step[4];
+    if (opcode == OP_END) {
+      timeline.playing = false;
+      Serial.printf(MC_TAG " ⏹️ Timeline terminée (retard max %lu ms)\n", timeline.maxLateMs);
+      sendTimelineStatus("finished");
+      return;
+    }
+
+    // Effet en cours (fondu, mouvement) : le pas attend sa fin
+    if (outputsBusy()) return;
+
+    unsigned long lateMs = elapsed - atMs;
+    if (lateMs > timeline.maxLateMs) timeline.maxLateMs = lateMs;
+
+    executeTimelineStep(opcode, readU16(step + 5), step + TIMELINE_STEP_BYTES);
+    timeline.pc += TIMELINE_STEP_BYTES + timelineOperandBytes(opcode);
+  }
+}
+
+void sendTimelineStatus(const char* status, const char* reason) {
+  if (!isAuthenticated) return;
+
+  JsonDocument doc(&txAllocator);
+  doc["type"] = "timeline_status";
+  stampState(doc);
+  doc["status"] = status;
+  if (reason) doc["reason"] = reason;
+  doc["crc"] = timeline.crc;
+  doc["steps"] = timeline.steps;
+  doc["lateMs"] = timeline.maxLateMs;
+  sendDocument(doc);
+}
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (uint8_t k = 0; k < 8; k++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+  }
+  return ~crc;
+}
+
+uint16_t readU16(const uint8_t* p) {
+  return (uint16_t)p[0] | ((uint16_t)p[1] << 8);
+}
+
+uint32_t readU32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// ============================================================================
+// ENVOI - numérotation, regroupement et compression des trames
+// ============================================================================
+
+// Époque d'état : une seule écriture flash par démarrage, jamais par trame
+void loadStateEpoch() {
+  nvs.begin("mc-state", false);
+  stateEpoch = nvs.getUInt("epoch", 0) + 1;
+  nvs.putUInt("epoch", stateEpoch);
+  nvs.end();
+  Serial.printf(MC_TAG " 🔢 Époque d'état: %lu\n", (unsigned long)stateEpoch);
+}
+
+// Numérote une trame d'état (si négocié) : le serveur écarte doublons et trames périmées
+void stampState(JsonDocument& doc) {
+  if (!(activeCapabilities & CAP_STATE_SEQUENCE)) return;
+  doc["epoch"] = stateEpoch;
+  doc["seq"] = ++stateSeq;
+}
+
+bool sendDocument(JsonDocument& doc) {
+  char* json = reinterpret_cast<char*>(txFrame + WEBSOCKETS_MAX_HEADER_SIZE);
+
+  if (doc.overflowed()) {
+    Serial.println(MC_TAG " ⚠️ Message hors plan mémoire (zone JSON pleine) - non envoyé");
+    return false;
+  }
+
+  // Regroupement : le message rejoint la trame en attente (virgule et fin d'enveloppe "]}"
+  // réservées) ; un message trop grand pour l'enveloppe part seul
+  if (isAuthenticated && (activeCapabilities & CAP_BATCHING)) {
+    size_t needed = measureJson(doc) + 3;
+    if (BATCH_PREFIX_LEN + needed < JSON_TX_BYTES) {
+      if (sendBatchLength + needed >= JSON_TX_BYTES) flushSendBatch();
+      if (sendBatchCount == 0) {
+        memcpy(json, BATCH_PREFIX, BATCH_PREFIX_LEN);
+        sendBatchLength = BATCH_PREFIX_LEN;
+      } else {
+        json[sendBatchLength++] = ',';
+      }
+      sendBatchLength += serializeJson(doc, json + sendBatchLength, JSON_TX_BYTES - sendBatchLength);
+      sendBatchCount++;
+      return true;
+    }
+  }
+
+  // Envoi immédiat : les messages en attente partent d'abord pour conserver l'ordre
+  flushSendBatch();
+
+  size_t length = serializeJson(doc, json, JSON_TX_BYTES);
+  if (length == 0 || length >= JSON_TX_BYTES - 1) {
+    Serial.println(MC_TAG " ⚠️ Message hors plan mémoire (tampon d'envoi) - non envoyé");
+    return false;
+  }
+
+  return sendFrame(txFrame, length);
+}
+
+// Envoie les messages en attente : un message seul part tel quel, plusieurs dans l'enveloppe batch
+void flushSendBatch() {
+  if (sendBatchCount == 0) return;
+
+  char* json = reinterpret_cast<char*>(txFrame + WEBSOCKETS_MAX_HEADER_SIZE);
+  uint16_t count = sendBatchCount;
+  size_t length = sendBatchLength;
+  sendBatchCount = 0;
+  sendBatchLength = 0;
+
+  bool sent;
+  if (count == 1) {
+    // L'en-tête WebSocket écrase la fin du début d'enveloppe, juste devant le message
+    sent = sendFrame(txFrame + BATCH_PREFIX_LEN, length - BATCH_PREFIX_LEN);
+  } else {
+    json[length++] = ']';
+    json[length++] = '}';
+    sent = sendFrame(txFrame, length);
+  }
+
+  if (!sent) {
+    Serial.printf(MC_TAG " ⚠️ Trame de %u message(s) non envoyée\n", count);
+  }
+}
+
+// Envoie le JSON placé à frame + WEBSOCKETS_MAX_HEADER_SIZE, compressé en place si négocié
+bool sendFrame(uint8_t* frame, size_t length) {
+  if (isAuthenticated && (activeCapabilities & CAP_COMPRESSION)) {
+    unsigned long startUs = micros();
+    size_t encoded = encodeFrame(reinterpret_cast<char*>(frame + WEBSOCKETS_MAX_HEADER_SIZE), length);
+    if (encoded > 0) {
+      codecStats.encodeUs += micros() - startUs;
+      codecStats.tx += length;
+      codecStats.txWire += encoded;
+      length = encoded;
+    }
+  }
+
+  // headerToPayload : l'en-tête est écrit dans l'espace réservé devant le JSON
+  return webSocket.sendTXT(frame, length, true);
+}
+
+void initFrameCodec() {
+  for (uint8_t entry = 0; entry < FRAME_DICTIONARY_SIZE; entry++) {
+    frameCodec.length[entry] = strlen(FRAME_DICTIONARY[entry]);
+
+    // Tri par insertion : premier octet croissant, puis longueur décroissante
+    uint8_t first = FRAME_DICTIONARY[entry][0];
+    uint8_t slot = entry;
+    while (slot > 0) {
+      uint8_t previous = frameCodec.order[slot - 1];
+      uint8_t previousFirst = FRAME_DICTIONARY[previous][0];
+      if (previousFirst < first || (previousFirst == first && frameCodec.length[previous] >= frameCodec.length[entry])) break;
+      frameCodec.order[slot] = previous;
+      slot--;
+    }
+    frameCodec.order[slot] = entry;
+  }
+
+  uint8_t slot = 0;
+  for (uint16_t byte = 0; byte <= 128; byte++) {
+    while (slot < FRAME_DICTIONARY_SIZE && (uint8_t)FRAME_DICTIONARY[frameCodec.order[slot]][0] < byte) slot++;
+    frameCodec.first[byte] = slot;
+  }
+
+  memset(frameCodec.shortEntry, -1, sizeof(frameCodec.shortEntry));
+  for (uint8_t entry = 0; entry < FRAME_SHORT_CODES; entry++) {
+    frameCodec.shortEntry[FRAME_SHORT_BYTES[entry]] = entry;
+  }
+}
+
+// Compresse une trame JSON en place (un code est toujours plus court que son entrée) ;
+// 0 si elle doit partir telle quelle : début différent de l'entrée 0 ou octet de contrôle
+size_t encodeFrame(char* data, size_t length) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+  if (length < frameCodec.length[0] || memcmp(data, FRAME_DICTIONARY[0], frameCodec.length[0]) != 0) return 0;
+  for (size_t i = 0; i < length; i++) {
+    if (bytes[i] < 0x20) return 0;
+  }
+
+  size_t written = 0;
+  for (size_t i = 0; i < length; ) {
+    int16_t match = -1;
+    if (bytes[i] < 128) {
+      for (uint8_t c = frameCodec.first[bytes[i]]; c < frameCodec.first[bytes[i] + 1]; c++) {
+        uint8_t entry = frameCodec.order[c];
+        if (frameCodec.length[entry] <= length - i &&
+            memcmp(data + i, FRAME_DICTIONARY[entry], frameCodec.length[entry]) == 0) {
+          match = entry;
+          break;
+        }
+      }
+    }
+
+    if (match < 0) {
+      data[written++] = data[i++];
+    } else if (match < FRAME_SHORT_CODES) {
+      i += frameCodec.length[match];
+      data[written++] = FRAME_SHORT_BYTES[match];
+    } else {
+      i += frameCodec.length[match];
+      data[written++] = FRAME_EXTENDED_CODE;
+      data[written++] = FRAME_EXTENDED_BASE + (match - FRAME_SHORT_CODES);
+    }
+  }
+  return written;
+}
+
+// Décompresse une trame ; 0 si un code est inconnu ou si le JSON dépasse capacity
+size_t decodeFrame(const uint8_t* in, size_t length, uint8_t* out, size_t capacity) {
+  size_t written = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (in[i] >= 0x20) {
+      if (written >= capacity) return 0;
+      out[written++] = in[i];
+      continue;
+    }
+
+    int16_t entry = -1;
+    if (in[i] == FRAME_EXTENDED_CODE) {
+      if (++i < length && in[i] >= FRAME_EXTENDED_BASE) entry = FRAME_SHORT_CODES + (in[i] - FRAME_EXTENDED_BASE);
+    } else {
+      entry = frameCodec.shortEntry[in[i]];
+    }
+    if (entry < 0 || entry >= FRAME_DICTIONARY_SIZE) return 0;
+
+    if (written + frameCodec.length[entry] > capacity) return 0;
+    memcpy(out + written, FRAME_DICTIONARY[entry], frameCodec.length[entry]);
+    written += frameCodec.length[entry];
+  }
+  return written;
+}
+
+// ============================================================================
+// MESSAGES D'ÉTAT - champs communs, complétés par writeModuleState()
+// ============================================================================
+
+// Réponse de commande sans l'envoyer : le module peut y ajouter ses mesures
+void writeCommandResponse(JsonDocument& doc, const char* command, uint32_t commandId, const char* status) {
+  doc["type"] = "command_response";
+  stampState(doc);
+  doc["moduleId"] = MODULE_ID;
+  doc["password"] = MODULE_PASSWORD;
+  doc["command"] = command;
+  if (commandId) doc["id"] = commandId;                     // Absent : rapport spontané du module
+  doc["status"] = status;
+  writeModuleState(doc, REPORT_RESPONSE);
+  doc["queueDepth"] = commandCount;
+}
+
+void sendCommandResponse(const char* command, uint32_t commandId, const char* status, long durationMs,
+                         uint32_t requestedMs) {
+  if (!isAuthenticated) return;
+
+  JsonDocument doc(&txAllocator);
+  writeCommandResponse(doc, command, commandId, status);
+  if (durationMs >= 0) doc["durationMs"] = durationMs;      // Durée réelle de l'effet
+  if (requestedMs > 0) doc["requestedMs"] = requestedMs;    // Fenêtre demandée
+
+  sendDocument(doc);
+
+  Serial.printf(MC_TAG " 📤 Réponse: %s -> %s\n", command, status);
+}
+
+void sendHeartbeat() {
+  if (!isAuthenticated) return;
+
+  JsonDocument doc(&txAllocator);
+  doc["type"] = "heartbeat";
+  stampState(doc);
+  doc["moduleId"] = MODULE_ID;
+  doc["password"] = MODULE_PASSWORD;
+  doc["uptime"] = millis() - uptimeStart;
+  writeModuleState(doc, REPORT_HEARTBEAT);
+  doc["wifiRSSI"] = WiFi.RSSI();
+  doc["freeHeap"] = ESP.getFreeHeap();
+  doc["minFreeHeap"] = ESP.getMinFreeHeap();
+  doc["queueDepth"] = commandCount;
+
+  sendDocument(doc);
+
+  Serial.println(MC_TAG " 💓 Heartbeat envoyé");
+}
+
+void sendTelemetry() {
+  if (!isAuthenticated) return;
+
+  JsonDocument doc(&txAllocator);
+  doc["type"] = "telemetry";
+  stampState(doc);
+  doc["moduleId"] = MODULE_ID;
+  doc["password"] = MODULE_PASSWORD;
+  doc["uptime"] = millis() - uptimeStart;
+  writeModuleState(doc, REPORT_TELEMETRY);
+  doc["status"] = "operational";
+  doc["queueDepth"] = commandCount;
+
+  // Résumés de l'intervalle écoulé (si négociés), puis remise à zéro
+  JsonObject summary;
+  if (activeCapabilities & CAP_TELEMETRY_SUMMARY) {
+    summary = doc["summary"].to<JsonObject>();
+    summary["intervalMs"] = millis() - summaryStart;
+    writeSummary(summary["rssi"].to<JsonObject>(), rssiSummary);
+    writeSummary(summary["heap"].to<JsonObject>(), heapSummary);
+    writeSummary(summary["loopUs"].to<JsonObject>(), loopSummary);
+  }
+  writeModuleSummaries(summary);
+  resetSummary(rssiSummary);
+  resetSummary(heapSummary);
+  resetSummary(loopSummary);
+  summaryStart = millis();
+
+  // Coût de la compression sur l'intervalle écoulé (si négociée), puis remise à zéro
+  if (activeCapabilities & CAP_COMPRESSION) {
+    JsonObject codec = doc["codec"].to<JsonObject>();
+    codec["tx"] = codecStats.tx;
+    codec["txWire"] = codecStats.txWire;
+    codec["encodeUs"] = codecStats.encodeUs;
+    codec["rx"] = codecStats.rx;
+    codec["rxWire"] = codecStats.rxWire;
+    codec["decodeUs"] = codecStats.decodeUs;
+  }
+  codecStats = {};
+
+  sendDocument(doc);
+
+  Serial.println(MC_TAG " 📊 Télémétrie envoyée");
+}
+
+uint8_t summaryBucket(uint32_t value) {
+  if (value < SUMMARY_SUB_BUCKETS) return value;
+  uint8_t magnitude = 31 - __builtin_clz(value);
+  uint8_t sub = (value >> (magnitude - SUMMARY_SUB_BITS)) & (SUMMARY_SUB_BUCKETS - 1);
+  return (magnitude - SUMMARY_SUB_BITS + 1) * SUMMARY_SUB_BUCKETS + sub;
+}
+
+void recordSample(MetricSummary& summary, int32_t value) {
+  if (summary.count == 0 || value < summary.minValue) summary.minValue = value;
+  if (summary.count == 0 || value > summary.maxValue) summary.maxValue = value;
+  summary.count++;
+  summary.sum += value;
+  summary.sumSquares += (uint64_t)((int64_t)value * value);
+
+  int32_t histogramValue = summary.negated ? -value : value;
+  uint32_t magnitude = histogramValue > 0 ? (uint32_t)histogramValue : 0;
+  uint16_t& bucket = summary.buckets[summaryBucket(magnitude)];
+  if (bucket < UINT16_MAX) bucket++;
+}
+
+void resetSummary(MetricSummary& summary) {
+  bool negated = summary.negated;
+  memset(&summary, 0, sizeof(summary));
+  summary.negated = negated;
+}
+
+void writeSummary(JsonObject target, const MetricSummary& summary) {
+  target["n"] = summary.count;
+  if (summary.count == 0) return;
+
+  target["min"] = summary.minValue;
+  target["max"] = summary.maxValue;
+  target["sum"] = summary.sum;
+  target["sq"] = summary.sumSquares;
+  if (summary.negated) target["neg"] = 1;
+
+  // Histogramme creux écrit en JSON brut : seuls les intervalles non vides sont transmis
+  size_t length = 0;
+  histogramText[length++] = '[';
+  for (uint8_t i = 0; i < SUMMARY_BUCKETS; i++) {
+    if (summary.buckets[i] == 0) continue;
+    length += snprintf(histogramText + length, HISTOGRAM_TEXT_MAX - length, "%s[%u,%u]",
+                       length > 1 ? "," : "", i, summary.buckets[i]);
+  }
+  histogramText[length++] = ']';
+  histogramText[length] = '\0';
+  target["h"] = serialized(histogramText, length);
+}
+
+void printMemoryPlan() {
+  Serial.println(MC_TAG " 🧮 Plan mémoire statique:");
+  Serial.printf(MC_TAG "    File de commandes : %zu octets\n", sizeof(commandQueue));
+  Serial.printf(MC_TAG "    Résumés télémétrie: %zu octets\n", TELEMETRY_SUMMARIES * sizeof(MetricSummary) + sizeof(histogramText));
+  Serial.printf(MC_TAG "    JSON reçu / envoyé: %zu / %zu octets\n", sizeof(jsonRxPool), sizeof(jsonTxPool));
+  Serial.printf(MC_TAG "    Trame d'envoi     : %zu octets\n", sizeof(txFrame));
+  Serial.printf(MC_TAG "    Codec de trames   : %zu octets\n", sizeof(rxDecoded) + sizeof(frameCodec));
+  Serial.printf(MC_TAG "    Programme timeline: %zu octets\n", sizeof(timelineProgram));
+  printModuleMemory();
+  Serial.printf(MC_TAG "    Heap libre        : %lu octets (min %lu)\n", (unsigned long)ESP.getFreeHeap(),
+                (unsigned long)ESP.getMinFreeHeap());
+}
@@ -0,0 +1,469 @@
+/*
+ * MicroCoaster - Speed Control ESP32
+ * Moteur de lancement régulé, rampes de vitesse générées sur le module
+ */
+
+#include <Arduino.h>
+
+#define MC_TAG "[SPEED CONTROL]"
+const char MODULE_NAME[] = "Speed Control";
+const char MODULE_TYPE[] = "speed-control";
+
+#ifndef MC_NATIVE_BENCH
+// Configuration module
+const char MODULE_ID[] = "MC-0001-LT";
+const char MODULE_PASSWORD[] = "W3kP9xNq6TzLc2RvH8mYb5JsD1gFa7Eu";
+#endif
+
+// Plan mémoire propre au module (le reste est fixé par module_core.h)
+const size_t JSON_TX_BYTES = 5632;                 // Tampon du message JSON envoyé
+const size_t JSON_TX_POOL_BYTES = 6656;            // Zone du document JSON envoyé
+const size_t STATIC_RAM_BUDGET_BYTES = 24 * 1024;  // Budget RAM statique du firmware
+const size_t TELEMETRY_SUMMARIES = 3;              // rssi, heap, loopUs
+const uint8_t TIMELINE_MODULE_KIND = 3;            // speed-control
+const unsigned long LOOP_IDLE_MS = 100;            // Pause de loop() au repos
+
+// Paramètres d'une commande en file
+struct CommandParams {
+  uint8_t targetSpeed;       // set_speed : vitesse cible (0-100)
+  int8_t fromSpeed;          // gradual_change : vitesse de départ (-1 = vitesse courante)
+  uint8_t toSpeed;           // gradual_change : vitesse d'arrivée
+};
+
+#include "module_core.h"
+#include "estop_link.h"
+#include "estop_latch.h"
+
+const uint32_t FIRMWARE_CAPABILITIES = CORE_CAPABILITIES | CAP_MOTION_PARAMS;
+
+// Pins hardware
+const int MOTOR_PWM_PIN = 18;                      // Entrée PWM du variateur moteur
+const int TACH_PIN = 19;                           // Capteur de vitesse (une impulsion par dent)
+
+// Moteur de lancement - PWM LEDC, boucle fermée cadencée par timer matériel (esp_timer)
+const uint8_t MOTOR_LEDC_CHANNEL = 0;
+const uint32_t MOTOR_PWM_HZ = 20000;               // Hors de la bande audible
+const uint8_t MOTOR_PWM_BITS = 10;
+const uint32_t MOTOR_DUTY_MAX = (1UL << MOTOR_PWM_BITS) - 1;
+const uint32_t CONTROL_PERIOD_US = 1000;           // Boucle de régulation à 1 kHz
+const uint8_t SPEED_WINDOW_TICKS = 20;             // Vitesse mesurée sur 20 périodes glissantes
+const uint32_t TACH_PULSES_FULL_SPEED = 20000;     // Impulsions par seconde à 100 %
+const int32_t SPEED_SCALE = 1000;                  // Vitesses internes en pour mille
+const int32_t KP_Q16 = 39322;                      // Gain proportionnel 0,6 (Q16)
+const int32_t KI_Q16 = 655;                        // Gain intégral 0,01 par période (Q16)
+const int32_t INTEGRAL_MAX = 100000;               // Borne de l'intégrale (correction max 100 %)
+const uint32_t RAMP_MAX_MS = 60000;                // Rampe la plus longue acceptée
+const uint32_t SETTLE_WINDOW_MS = 500;             // Fenêtre de mesure d'un échelon sans durée
+const uint8_t DEFAULT_TARGET_SPEED = 50;           // Valeurs par défaut de l'éditeur de timelines
+const uint8_t DEFAULT_TO_SPEED = 70;
+const uint32_t DEFAULT_RAMP_MS = 5000;
+
+static_assert((uint64_t)TACH_PULSES_FULL_SPEED * SPEED_WINDOW_TICKS * CONTROL_PERIOD_US / 1000000 >= 100,
+              "Résolution de mesure inférieure à 1 %");
+static_assert(SETTLE_WINDOW_MS * 1000 >= 10 * CONTROL_PERIOD_US, "Au moins 10 périodes de régulation par mesure");
+
+// Rampe en cours - écrite par loop() au démarrage, puis par la boucle de régulation jusqu'à la fin ;
+// active / done / interrupted ne changent que sous rampMux (loop(), tâche esp_timer, tâche WiFi)
+struct SpeedRamp {
+  volatile bool active;
+  volatile bool done;            // Fenêtre de mesure écoulée, signalée à loop()
+  volatile bool interrupted;     // Coupée par un arrêt d'urgence, à signaler par loop()
+  volatile uint32_t elapsedUs;   // Durée au moment de la coupure
+  int16_t from;                  // Consignes en pour mille
+  int16_t to;
+  uint32_t startUs;
+  uint32_t rampUs;               // Durée de la rampe (0 = échelon)
+  uint32_t windowUs;             // Fenêtre de mesure de l'écart (>= rampUs)
+  uint32_t requestedMs;
+  char command[COMMAND_NAME_MAX];
+  uint32_t commandId;
+};
+
+// État de la boucle de régulation (tâche esp_timer)
+struct SpeedControl {
+  volatile int16_t setpoint;     // Consigne courante (‰)
+  volatile int16_t measured;     // Vitesse mesurée (‰)
+  volatile uint16_t duty;        // Rapport cyclique appliqué
+  int32_t integral;
+  uint32_t lastPulses;
+  uint16_t window[SPEED_WINDOW_TICKS];   // Impulsions par période
+  uint32_t windowSum;
+  uint8_t windowIndex;
+};
+
+// Écart consigne / vitesse atteinte pendant la fenêtre d'une rampe (‰)
+struct TrackingError {
+  uint32_t samples;
+  uint64_t sumAbs;
+  uint64_t sumSquares;
+  uint16_t maxAbs;
+  int16_t finalError;
+};
+
+SpeedRamp ramp = {};
+portMUX_TYPE rampMux = portMUX_INITIALIZER_UNLOCKED;
+SpeedControl control = {};
+TrackingError tracking = {};
+volatile uint32_t tachPulses = 0;
+esp_timer_handle_t controlTimer = nullptr;
+
+const uint8_t OP_SET_SPEED = 0x30;
+const uint8_t OP_RAMP_SPEED = 0x31;
+
+static_assert(CORE_STATIC_BYTES + sizeof(control) <= STATIC_RAM_BUDGET_BYTES, "Budget RAM statique dépassé");
+
+// Déclarations des fonctions
+void setupMotor();
+void startRamp(const char* command, uint32_t commandId, int16_t fromPm, int16_t toPm, uint32_t rampMs,
+               uint32_t requestedMs);
+void checkRampDone();
+void checkRampInterrupted();
+void onControlTick(void* arg);
+void IRAM_ATTR onTachPulse();
+void writeMotorDuty(uint32_t duty);
+uint32_t rampWithin(uint32_t rampMs);
+void sendRampResponse(long durationMs);
+
+// Moteur à l'arrêt, capteur de vitesse et boucle de régulation
+void setupHardware() {
+  setupMotor();
+}
+
+// Fin de rampe : indépendante de la connexion (la régulation continue hors ligne)
+void serviceOutputs() {
+  checkRampDone();
+  checkEstop();
+  checkRampInterrupted();
+}
+
+// Une rampe en cours n'est pas attendue : la commande suivante la remplace. Un arrêt reçu
+// hors de loop() bloque tout jusqu'à checkEstop()
+bool outputsBusy() {
+  return estop.pending;
+}
+
+void parseCommandParams(CommandParams& params, JsonVariantConst data) {
+  params.targetSpeed = constrain((int)(data["target_speed"] | (int)DEFAULT_TARGET_SPEED), 0, 100);
+  params.fromSpeed = data["from_speed"].is<int>() ? constrain(data["from_speed"].as<int>(), 0, 100) : -1;
+  params.toSpeed = constrain((int)(data["to_speed"] | (int)DEFAULT_TO_SPEED), 0, 100);
+}
+
+void executeCommand(const QueuedCommand& queued) {
+  const char* command = queued.name;
+  const char* status = "success";
+
+  // Verrou d'arrêt d'urgence : seules la lecture d'état et la levée du verrou sont acceptées
+  if (estop.latched && strcmp(command, "get_speed") && strcmp(command, "estop") && strcmp(command, "estop_reset")) {
+    sendCommandResponse(command, queued.id, "estop_latched");
+    return;
+  }
+
+  // Traitement des commandes - une rampe complète part en une commande, la réponse à sa fin
+  if (!strcmp(command, "set_speed")) {
+    Serial.printf(MC_TAG " ⚡ Vitesse cible %u%%\n", queued.params.targetSpeed);
+    startRamp(command, queued.id, control.setpoint, queued.params.targetSpeed * 10, 0, queued.durationMs);
+    return;
+
+  } else if (!strcmp(command, "gradual_change")) {
+    int16_t fromPm = queued.params.fromSpeed < 0 ? control.setpoint : queued.params.fromSpeed * 10;
+    uint32_t rampMs = rampWithin(queued.durationMs ? queued.durationMs : DEFAULT_RAMP_MS);
+    Serial.printf(MC_TAG " 📈 Rampe %d%% -> %u%% en %lu ms\n", fromPm / 10, queued.params.toSpeed,
+                  (unsigned long)rampMs);
+    startRamp(command, queued.id, fromPm, queued.params.toSpeed * 10, rampMs, queued.durationMs);
+    return;
+
+  } else if (!strcmp(command, "stop")) {
+    Serial.println(MC_TAG " 🛑 Arrêt moteur");
+    startRamp(command, queued.id, 0, 0, 0, 0);
+    return;
+
+  } else if (!strcmp(command, "estop")) {
+    // Voie lente (serveur) : même coupure que la trame LAN, signalée par checkEstop()
+    unsigned long startUs = micros();
+    emergencyStop(queued.id);
+    estop.handleUs = micros() - startUs;
+    return;
+
+  } else if (!strcmp(command, "estop_reset")) {
+    if (releaseEstop()) {
+      Serial.println(MC_TAG " ✅ Verrou d'arrêt d'urgence levé");
+    } else {
+      status = "estop_latched";
+    }
+
+  } else if (!strcmp(command, "timeline_play")) {
+    startTimeline(queued);
+    return;
+
+  } else if (!strcmp(command, "timeline_stop")) {
+    if (timeline.playing) {
+      timeline.playing = false;
+      sendTimelineStatus("stopped");
+    }
+    Serial.println(MC_TAG " ⏹️ Timeline arrêtée");
+
+  } else if (!strcmp(command, "get_speed")) {
+    // Pas de changement de consigne, juste retourner l'état
+    Serial.printf(MC_TAG " 📍 Vitesse: %d‰ (consigne %d‰)\n", control.measured, control.setpoint);
+
+  } else {
+    Serial.printf(MC_TAG " ❌ Commande inconnue: %s\n", command);
+    status = "unknown_command";
+  }
+
+  // Envoyer la réponse de commande (WebSocket natif)
+  sendCommandResponse(command, queued.id, status);
+}
+
+// ============================================================================
+// RÉGULATION DE VITESSE - PWM LEDC, boucle PI à CONTROL_PERIOD_US (esp_timer)
+// ============================================================================
+
+void setupMotor() {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  ledcAttach(MOTOR_PWM_PIN, MOTOR_PWM_HZ, MOTOR_PWM_BITS);
+#else
+  ledcSetup(MOTOR_LEDC_CHANNEL, MOTOR_PWM_HZ, MOTOR_PWM_BITS);
+  ledcAttachPin(MOTOR_PWM_PIN, MOTOR_LEDC_CHANNEL);
+#endif
+  writeMotorDuty(0);
+
+  pinMode(TACH_PIN, INPUT_PULLUP);
+  attachInterrupt(digitalPinToInterrupt(TACH_PIN), onTachPulse, RISING);
+
+  // La boucle tourne en permanence : elle maintient la consigne entre deux rampes
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = &onControlTick;
+  timerArgs.name = "speed";
+  esp_timer_create(&timerArgs, &controlTimer);
+  esp_timer_start_periodic(controlTimer, CONTROL_PERIOD_US);
+}
+
+// Démarre une rampe linéaire fromPm -> toPm ; l'écart est mesuré jusqu'à la fin de la fenêtre déclarée
+void startRamp(const char* command, uint32_t commandId, int16_t fromPm, int16_t toPm, uint32_t rampMs,
+               uint32_t requestedMs) {
+  // Rampe en cours gelée : la boucle de régulation ne peut plus la terminer pendant la préparation
+  portENTER_CRITICAL(&rampMux);
+  bool preempted = ramp.active;
+  ramp.active = false;
+  portEXIT_CRITICAL(&rampMux);
+
+  // Terminée juste avant le gel : sa réponse part avant que command / commandId soient remplacés
+  checkRampDone();
+
+  // Une nouvelle consigne remplace la rampe en cours, signalée comme interrompue
+  if (preempted) {
+    sendCommandResponse(ramp.command, ramp.commandId, "preempted", ((uint32_t)esp_timer_get_time() - ramp.startUs) / 1000,
+                        ramp.requestedMs);
+  }
+
+  uint32_t windowMs = max(max(rampMs, requestedMs), SETTLE_WINDOW_MS);
+
+  ramp.from = constrain(fromPm, 0, SPEED_SCALE);
+  ramp.to = constrain(toPm, 0, SPEED_SCALE);
+  ramp.rampUs = rampMs * 1000;
+  ramp.windowUs = windowMs * 1000;
+  ramp.requestedMs = requestedMs;
+  strlcpy(ramp.command, command, COMMAND_NAME_MAX);
+  ramp.commandId = commandId;
+  memset(&tracking, 0, sizeof(tracking));
+
+  // Publication : la boucle de régulation voit la nouvelle rampe complète ou pas du tout
+  portENTER_CRITICAL(&rampMux);
+  ramp.done = false;
+  ramp.startUs = (uint32_t)esp_timer_get_time();
+  ramp.active = true;
+  portEXIT_CRITICAL(&rampMux);
+}
+
+void checkRampDone() {
+  if (!ramp.done) return;
+  ramp.done = false;
+
+  Serial.printf(MC_TAG " ✅ Rampe terminée: %d‰ (consigne %d‰, écart max %u‰)\n", control.measured,
+                ramp.to, tracking.maxAbs);
+  sendRampResponse(ramp.windowUs / 1000);
+}
+
+// Rampe coupée par un arrêt d'urgence : la commande qui l'a lancée reçoit estop_latched
+void checkRampInterrupted() {
+  if (!ramp.interrupted) return;
+  ramp.interrupted = false;
+
+  unsigned long actualMs = ramp.elapsedUs / 1000;
+  Serial.printf(MC_TAG " ⚠️ Rampe %s interrompue après %lu ms\n", ramp.command, actualMs);
+  sendCommandResponse(ramp.command, ramp.commandId, "estop_latched", actualMs, ramp.requestedMs);
+}
+
+// Exécuté dans la tâche esp_timer à CONTROL_PERIOD_US : mesure, consigne, correction PI
+void onControlTick(void* arg) {
+  // Vitesse mesurée : impulsions sur une fenêtre glissante de SPEED_WINDOW_TICKS périodes
+  uint32_t pulses = tachPulses;
+  uint16_t delta = (uint16_t)min(pulses - control.lastPulses, (uint32_t)UINT16_MAX);
+  control.lastPulses = pulses;
+  control.windowSum = control.windowSum + delta - control.window[control.windowIndex];
+  control.window[control.windowIndex] = delta;
+  control.windowIndex = (control.windowIndex + 1) % SPEED_WINDOW_TICKS;
+  int32_t measured = (int32_t)((uint64_t)control.windowSum * SPEED_SCALE * 1000000 /
+                               ((uint64_t)TACH_PULSES_FULL_SPEED * SPEED_WINDOW_TICKS * CONTROL_PERIOD_US));
+  control.measured = measured;
+
+  // Verrou d'arrêt d'urgence : sortie coupée quelle que soit la consigne
+  if (estop.latched) {
+    control.setpoint = 0;
+    control.integral = 0;
+    writeMotorDuty(0);
+    return;
+  }
+
+  // Consigne : rampe linéaire (offset absolu depuis le départ), puis maintien de la valeur finale
+  int32_t setpoint = control.setpoint;
+  portENTER_CRITICAL(&rampMux);
+  if (ramp.active) {
+    uint32_t elapsed = (uint32_t)esp_timer_get_time() - ramp.startUs;
+    setpoint = elapsed >= ramp.rampUs
+                   ? ramp.to
+                   : ramp.from + (int32_t)(((int64_t)(ramp.to - ramp.from) * elapsed) / ramp.rampUs);
+    control.setpoint = setpoint;
+
+    int32_t error = setpoint - measured;
+    uint32_t absError = (uint32_t)abs(error);
+    tracking.samples++;
+    tracking.sumAbs += absError;
+    tracking.sumSquares += (uint64_t)absError * absError;
+    if (absError > tracking.maxAbs) tracking.maxAbs = absError;
+    tracking.finalError = error;
+
+    if (elapsed >= ramp.windowUs) {
+      ramp.active = false;
+      ramp.done = true;
+    }
+  }
+  portEXIT_CRITICAL(&rampMux);
+
+  // Consigne nulle : sortie coupée, intégrale remise à zéro
+  if (setpoint == 0) {
+    control.integral = 0;
+    writeMotorDuty(0);
+    return;
+  }
+
+  // PI avec anticipation : la consigne donne le rapport cyclique nominal, le PI corrige l'écart
+  int32_t error = setpoint - measured;
+  int32_t output = setpoint + (int32_t)(((int64_t)KP_Q16 * error) >> 16) +
+                   (int32_t)(((int64_t)KI_Q16 * control.integral) >> 16);
+
+  // Anti-emballement : l'intégrale n'avance pas quand la sortie sature dans le sens de l'écart
+  if ((output < SPEED_SCALE || error < 0) && (output > 0 || error > 0)) {
+    control.integral = constrain(control.integral + error, -INTEGRAL_MAX, INTEGRAL_MAX);
+  }
+  output = constrain(output, 0, SPEED_SCALE);
+  writeMotorDuty((uint32_t)output * MOTOR_DUTY_MAX / SPEED_SCALE);
+}
+
+// Une impulsion du capteur de vitesse
+void IRAM_ATTR onTachPulse() {
+  tachPulses = tachPulses + 1;
+}
+
+void writeMotorDuty(uint32_t duty) {
+  control.duty = duty;
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  ledcWrite(MOTOR_PWM_PIN, duty);
+#else
+  ledcWrite(MOTOR_LEDC_CHANNEL, duty);
+#endif
+}
+
+uint32_t rampWithin(uint32_t rampMs) {
+  return rampMs > RAMP_MAX_MS ? RAMP_MAX_MS : rampMs;
+}
+
+// ============================================================================
+// ARRÊT D'URGENCE LAN
+// ============================================================================
+
+// Appelé par emergencyStop() : moteur hors tension, rampe en cours interrompue (signalée par
+// checkRampInterrupted) ; une rampe déjà terminée garde sa réponse success. La boucle de
+// régulation maintient la coupure
+void cutOutputs() {
+  portENTER_CRITICAL(&rampMux);
+  if (ramp.active) {
+    ramp.elapsedUs = (uint32_t)esp_timer_get_time() - ramp.startUs;
+    ramp.interrupted = true;
+  }
+  ramp.active = false;
+  portEXIT_CRITICAL(&rampMux);
+  control.setpoint = 0;
+  writeMotorDuty(0);
+}
+
+// ============================================================================
+// TIMELINES COMPILÉES
+// ============================================================================
+
+// Taille des opérandes par opcode (-1 : opcode non pris en charge par ce module)
+int8_t timelineOperandBytes(uint8_t opcode) {
+  switch (opcode) {
+    case OP_SET_SPEED:  return 1;  // vitesse cible
+    case OP_RAMP_SPEED: return 2;  // vitesse de départ, vitesse d'arrivée
+    default:            return -1;
+  }
+}
+
+// La durée du pas est la fenêtre de mesure ; une rampe s'étale sur toute la fenêtre
+void executeTimelineStep(uint8_t opcode, uint16_t durationMs, const uint8_t* operands) {
+  if (opcode == OP_SET_SPEED) {
+    startRamp("set_speed", 0, control.setpoint, operands[0] * 10, 0, durationMs);
+  } else if (opcode == OP_RAMP_SPEED) {
+    startRamp("gradual_change", 0, operands[0] * 10, operands[1] * 10, durationMs, durationMs);
+  }
+}
+
+// ============================================================================
+// MESSAGES D'ÉTAT
+// ============================================================================
+
+void writeModuleState(JsonDocument& doc, StateReport report) {
+  doc["speed"] = control.measured / 10;
+  if (report == REPORT_RESPONSE || report == REPORT_TELEMETRY) doc["targetSpeed"] = control.setpoint / 10;
+  if (report == REPORT_TELEMETRY) {
+    doc["duty"] = control.duty;
+    doc["estop"] = estop.latched;
+  }
+}
+
+void writeModuleSummaries(JsonObject summary) {
+}
+
+void onSessionChanged(bool authenticated) {
+}
+
+// Réponse de fin de rampe : vitesse atteinte et écart à la consigne sur la fenêtre (‰ de la pleine vitesse)
+void sendRampResponse(long durationMs) {
+  if (!isAuthenticated) return;
+
+  JsonDocument doc(&txAllocator);
+  writeCommandResponse(doc, ramp.command, ramp.commandId, "success");
+  doc["targetSpeed"] = ramp.to / 10;
+  doc["durationMs"] = durationMs;
+  if (ramp.requestedMs > 0) doc["requestedMs"] = ramp.requestedMs;
+
+  JsonObject error = doc["tracking"].to<JsonObject>();
+  error["n"] = tracking.samples;
+  if (tracking.samples > 0) {
+    error["meanPm"] = (uint32_t)(tracking.sumAbs / tracking.samples);
+    error["rmsPm"] = (uint32_t)sqrtf((float)(tracking.sumSquares / tracking.samples));
+    error["maxPm"] = tracking.maxAbs;
+    error["finalPm"] = tracking.finalError;
+  }
+
+  sendDocument(doc);
+
+  Serial.printf(MC_TAG " 📤 Réponse: %s -> success\n", ramp.command);
+}
+
+void printModuleMemory() {
+  Serial.printf(MC_TAG "    Régulation vitesse: %zu octets (%lu Hz)\n", sizeof(control) + sizeof(ramp) + sizeof(tracking),
+                (unsigned long)(1000000 / CONTROL_PERIOD_US));
+}
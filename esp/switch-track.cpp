@@ -4,347 +4,398 @@
  */
 
 #include <Arduino.h>
-#include <WiFi.h>
-#include <WebSocketsClient.h>
-#include <ArduinoJson.h>
 
-// Configuration WiFi
-const char* ssid = "Freebox-73A72A";
-const char* password = "ChezCatherineetVincent";
-
-// Configuration serveur WebSocket natif
-const char* server_host = "192.168.1.23";  // IP du serveur sur le réseau local
-const uint16_t server_port = 3000;
-const char* websocket_path = "/esp32"; // Path WebSocket dédié ESP32
+#define MC_TAG "[SWITCH TRACK]"
+const char MODULE_NAME[] = "Switch Track";
+const char MODULE_TYPE[] = "switch-track";
 
+#ifndef MC_NATIVE_BENCH
 // Configuration module
-const String MODULE_ID = "MC-0001-ST";
-const String MODULE_PASSWORD = "F674iaRftVsHGKOA8hq3TI93HQHUaYqZ";
+const char MODULE_ID[] = "MC-0001-ST";
+const char MODULE_PASSWORD[] = "F674iaRftVsHGKOA8hq3TI93HQHUaYqZ";
+#endif
+
+// Plan mémoire propre au module (le reste est fixé par module_core.h)
+const size_t JSON_TX_BYTES = 5632;                 // Tampon du message JSON envoyé
+const size_t JSON_TX_POOL_BYTES = 6656;            // Zone du document JSON envoyé
+const size_t STATIC_RAM_BUDGET_BYTES = 24 * 1024;  // Budget RAM statique du firmware
+const size_t TELEMETRY_SUMMARIES = 3;              // rssi, heap, loopUs
+const uint8_t TIMELINE_MODULE_KIND = 2;            // switch-track
+const unsigned long LOOP_IDLE_MS = 100;            // Pause de loop() au repos
+
+// Paramètres d'une commande en file
+struct CommandParams {
+  uint8_t speed;             // Vitesse demandée (1-100)
+};
 
-// Variables globales
-WebSocketsClient webSocket;
-String currentPosition = "left"; // Position initiale
-unsigned long uptimeStart = 0;
-bool isAuthenticated = false;
+#include "module_core.h"
+#include "estop_link.h"
+#include "estop_latch.h"
+
+const uint32_t FIRMWARE_CAPABILITIES = CORE_CAPABILITIES | CAP_MOTION_PARAMS;
+
+// POSITION_UNKNOWN : mouvement interrompu par un arrêt d'urgence, servo arrêté entre deux positions
+enum TrackPosition : uint8_t { POSITION_LEFT, POSITION_RIGHT, POSITION_UNKNOWN };
+TrackPosition currentPosition = POSITION_LEFT; // Position initiale
 
 // Pins hardware
 const int LED_LEFT_PIN  = 2;
 const int LED_RIGHT_PIN = 4;
+const int SERVO_PIN     = 13;
+
+// Servo d'aiguillage - profil de mouvement cadencé par timer matériel (esp_timer)
+const uint8_t SERVO_LEDC_CHANNEL = 0;
+const uint32_t SERVO_PWM_HZ = 50;                  // Trame servo standard (20 ms)
+const uint8_t SERVO_PWM_BITS = 16;
+const uint32_t SERVO_MIN_PULSE_US = 500;           // Impulsion à 0°
+const uint32_t SERVO_MAX_PULSE_US = 2500;          // Impulsion à 180°
+const uint8_t ANGLE_LEFT = 30;                     // Angle de la position gauche
+const uint8_t ANGLE_RIGHT = 150;                   // Angle de la position droite
+const uint32_t MOTION_TICK_US = 10000;             // Période de mise à jour du profil (100 Hz)
+const uint32_t TRAVEL_MIN_MS = 300;                // Course la plus rapide (vitesse 100, limite mécanique)
+const uint32_t TRAVEL_MAX_MS = 3000;               // Course la plus lente (vitesse 1)
+const uint8_t DEFAULT_SPEED = 50;                  // Vitesse par défaut (1-100, comme la timeline)
+
+static_assert(TRAVEL_MIN_MS < TRAVEL_MAX_MS, "Plage de course invalide");
+static_assert(TRAVEL_MIN_MS * 1000 >= 10 * MOTION_TICK_US, "Au moins 10 pas de profil par course");
+
+// Mouvement en cours - écrit par loop() au démarrage, puis par le timer jusqu'à la fin
+struct MotionState {
+  volatile bool active;
+  volatile bool done;
+  volatile bool interrupted;     // Coupé par un arrêt d'urgence, à signaler par loop()
+  volatile uint32_t elapsedUs;   // Durée réelle, fixée à la fin (ou à l'interruption) du mouvement
+  uint32_t startUs;
+  uint32_t travelUs;
+  int32_t fromAngleQ8;           // Angle de départ (1/256 de degré)
+  uint8_t toAngle;
+  TrackPosition target;
+  uint32_t requestedMs;
+  char command[COMMAND_NAME_MAX];
+  uint32_t commandId;
+};
+
+MotionState motion = {};
+esp_timer_handle_t motionTimer = nullptr;
+volatile int32_t servoAngleQ8 = 0;                 // Dernier angle écrit (le servo s'y immobilise)
+
+const uint8_t OP_SWITCH_LEFT = 0x20;
+const uint8_t OP_SWITCH_RIGHT = 0x21;
 
 // Déclarations des fonctions
-void connectWiFi();
-void connectSocket();
-void webSocketEvent(WStype_t type, uint8_t * payload, size_t length);
-void authenticateModule();
-void handleConnected(const char* payload);
-void handleCommand(const char* payload);
-void handleError(const char* payload);
+void startMotion(const QueuedCommand& queued, TrackPosition target);
+void checkMotionDone();
+void checkMotionInterrupted();
+void onMotionTick(void* arg);
+void servoAttach();
+void writeServoAngleQ8(int32_t angleQ8);
+uint8_t angleOf(TrackPosition position);
+uint32_t travelTimeMs(uint8_t speed, uint32_t durationMs);
 void updateLEDs();
-void sendCommandResponse(const String& command, const String& status, const String& position);
-void sendHeartbeat();
-void sendTelemetry();
-
-void setup() {
-  Serial.begin(115200);
-  Serial.println("[SWITCH TRACK] 🚀 ESP32 Switch Track démarrant...");
-  
-  uptimeStart = millis();
-  
+const char* positionName(TrackPosition position);
+
+void setupHardware() {
   // Configuration pins LED
   pinMode(LED_LEFT_PIN, OUTPUT);
   pinMode(LED_RIGHT_PIN, OUTPUT);
-  
+
+  // Servo et timer de profil de mouvement
+  servoAttach();
+  writeServoAngleQ8(angleOf(currentPosition) << 8);
+  esp_timer_create_args_t timerArgs = {};
+  timerArgs.callback = &onMotionTick;
+  timerArgs.name = "motion";
+  esp_timer_create(&timerArgs, &motionTimer);
+
   // Position initiale - LED gauche allumée
   updateLEDs();
-  Serial.println("[SWITCH TRACK] 📍 Position initiale: " + currentPosition);
-  
-  // Connexion WiFi
-  connectWiFi();
-  
-  // Connexion Socket.io
-  connectSocket();
+  Serial.printf(MC_TAG " 📍 Position initiale: %s\n", positionName(currentPosition));
+}
+
+// Fin de mouvement : indépendante de la connexion
+void serviceOutputs() {
+  checkMotionDone();
+  checkEstop();
+  checkMotionInterrupted();
+}
+
+// Les commandes et les pas de timeline attendent la fin du mouvement en cours, ou le
+// traitement par checkEstop() d'un arrêt reçu hors de loop()
+bool outputsBusy() {
+  return motion.active || estop.pending;
+}
+
+void parseCommandParams(CommandParams& params, JsonVariantConst data) {
+  params.speed = constrain((int)(data["speed"] | DEFAULT_SPEED), 1, 100);
 }
 
-void loop() {
-  static unsigned long lastWiFiCheck = 0;
-  static unsigned long lastHeartbeat = 0;
-  static unsigned long lastTelemetry = 0;
-  unsigned long now = millis();
-  
-  // Monitoring WiFi continu
-  if (now - lastWiFiCheck > 10000) { // Vérifier toutes les 10 secondes
-    lastWiFiCheck = now;
-    Serial.printf("[SWITCH TRACK] 📶 WiFi: %d - RSSI: %d dBm\n", WiFi.status(), WiFi.RSSI());
+void executeCommand(const QueuedCommand& queued) {
+  const char* command = queued.name;
+  const char* status = "success";
+
+  // Verrou d'arrêt d'urgence : seules la lecture d'état et la levée du verrou sont acceptées
+  if (estop.latched && strcmp(command, "get_position") && strcmp(command, "estop") && strcmp(command, "estop_reset")) {
+    sendCommandResponse(command, queued.id, "estop_latched");
+    return;
   }
-  
-  // Vérifier la connexion WiFi avant WebSocket
-  if (WiFi.status() == WL_CONNECTED) {
-    webSocket.loop();
-    
-    // Envoyer heartbeat si authentifié
-    if (isAuthenticated && now - lastHeartbeat > 30000) { // Toutes les 30 secondes
-      sendHeartbeat();
-      lastHeartbeat = now;
+
+  // Traitement des commandes - les bascules démarrent un mouvement, la réponse part à sa fin
+  if (!strcmp(command, "switch_left") || !strcmp(command, "left") || !strcmp(command, "switch_to_A")) {
+    Serial.println(MC_TAG " 🔄 Aiguillage basculé vers la GAUCHE");
+    startMotion(queued, POSITION_LEFT);
+    return;
+
+  } else if (!strcmp(command, "switch_right") || !strcmp(command, "right") || !strcmp(command, "switch_to_B")) {
+    Serial.println(MC_TAG " 🔄 Aiguillage basculé vers la DROITE");
+    startMotion(queued, POSITION_RIGHT);
+    return;
+
+  } else if (!strcmp(command, "estop")) {
+    // Voie lente (serveur) : même coupure que la trame LAN, signalée par checkEstop()
+    unsigned long startUs = micros();
+    emergencyStop(queued.id);
+    estop.handleUs = micros() - startUs;
+    return;
+
+  } else if (!strcmp(command, "estop_reset")) {
+    if (releaseEstop()) {
+      updateLEDs();
+      Serial.println(MC_TAG " ✅ Verrou d'arrêt d'urgence levé");
+    } else {
+      status = "estop_latched";
     }
-    
-    // Envoyer télémétrie périodique si authentifié
-    if (isAuthenticated && now - lastTelemetry > 10000) { // Toutes les 10 secondes
-      sendTelemetry();
-      lastTelemetry = now;
+
+  } else if (!strcmp(command, "timeline_play")) {
+    startTimeline(queued);
+    return;
+
+  } else if (!strcmp(command, "timeline_stop")) {
+    if (timeline.playing) {
+      timeline.playing = false;
+      sendTimelineStatus("stopped");
     }
-    
+    Serial.println(MC_TAG " ⏹️ Timeline arrêtée");
+
+  } else if (!strcmp(command, "get_position")) {
+    // Pas de changement de position, juste retourner l'état
+    Serial.printf(MC_TAG " 📍 Position actuelle: %s\n", positionName(currentPosition));
+
   } else {
-    Serial.println("[SWITCH TRACK] ⚠️ WiFi déconnecté - reconnexion...");
-    isAuthenticated = false;
-    digitalWrite(LED_LEFT_PIN, LOW);
-    digitalWrite(LED_RIGHT_PIN, LOW);
-    connectWiFi();
-    if (WiFi.status() == WL_CONNECTED) {
-      connectSocket();
-    }
+    Serial.printf(MC_TAG " ❌ Commande inconnue: %s\n", command);
+    status = "unknown_command";
   }
-  
-  delay(100);
+
+  // Envoyer la réponse de commande (WebSocket natif)
+  sendCommandResponse(command, queued.id, status);
+
+  Serial.printf(MC_TAG " ✅ Commande exécutée: %s\n", positionName(currentPosition));
 }
 
-void connectWiFi() {
-  Serial.print("[SWITCH TRACK] 🌐 Connexion WiFi à ");
-  Serial.println(ssid);
-  
-  // Configuration WiFi pour stabilité
-  WiFi.mode(WIFI_STA);
-  WiFi.setSleep(false); // Désactiver le sleep WiFi
-  WiFi.setAutoReconnect(true);
-  WiFi.persistent(true);
-  
-  WiFi.begin(ssid, password);
-  
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
-  }
-  
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println();
-    Serial.print("[SWITCH TRACK] ✅ WiFi connecté - IP: ");
-    Serial.println(WiFi.localIP());
-    Serial.print("[SWITCH TRACK] 📶 Signal WiFi: ");
-    Serial.print(WiFi.RSSI());
-    Serial.println(" dBm");
-  } else {
-    Serial.println();
-    Serial.println("[SWITCH TRACK] ❌ Échec connexion WiFi");
-    delay(5000); // Attendre avant retry
+void startMotion(const QueuedCommand& queued, TrackPosition target) {
+  // Déjà en position : rien à déplacer (jamais après une interruption : position inconnue)
+  if (target == currentPosition) {
+    sendCommandResponse(queued.name, queued.id, "success", 0, queued.durationMs);
+    return;
   }
+
+  uint32_t travelMs = travelTimeMs(queued.params.speed, queued.durationMs);
+
+  // Position inconnue : course complète depuis l'angle où le servo s'est immobilisé
+  motion.fromAngleQ8 = currentPosition == POSITION_UNKNOWN ? servoAngleQ8 : angleOf(currentPosition) << 8;
+  motion.toAngle = angleOf(target);
+  motion.target = target;
+  motion.travelUs = travelMs * 1000;
+  motion.requestedMs = queued.durationMs;
+  strlcpy(motion.command, queued.name, COMMAND_NAME_MAX);
+  motion.commandId = queued.id;
+  motion.done = false;
+  motion.startUs = (uint32_t)esp_timer_get_time();
+  motion.active = true;
+
+  // LEDs éteintes pendant le mouvement
+  digitalWrite(LED_LEFT_PIN, LOW);
+  digitalWrite(LED_RIGHT_PIN, LOW);
+  esp_timer_start_periodic(motionTimer, MOTION_TICK_US);
+
+  Serial.printf(MC_TAG " 🎢 Mouvement vers %s - vitesse %u, course %lu ms (fenêtre %lu ms)\n",
+                positionName(target), queued.params.speed, (unsigned long)travelMs, (unsigned long)queued.durationMs);
 }
 
-void connectSocket() {
-  Serial.println("[SWITCH TRACK] 🔗 Connexion WebSocket natif...");
-  Serial.println("[SWITCH TRACK] 📍 Module ID: " + MODULE_ID);
-  Serial.println("[SWITCH TRACK] 🔑 Password: " + MODULE_PASSWORD.substring(0, 8) + "...");
-  
-  // Configuration WebSocket natif (Solution A)
-  webSocket.begin(server_host, server_port, websocket_path);
-  webSocket.onEvent(webSocketEvent);
-  webSocket.setReconnectInterval(5000);
-  webSocket.enableHeartbeat(15000, 3000, 2);
-  
-  Serial.printf("[SWITCH TRACK] 🤖 WebSocket: ws://%s:%d%s\n", server_host, server_port, websocket_path);
-  Serial.println("[SWITCH TRACK] ✅ ESP32 Switch Track prêt (Architecture hybride)!");
+void checkMotionDone() {
+  if (!motion.done) return;
+  motion.done = false;
+
+  currentPosition = motion.target;
+  updateLEDs();
+
+  unsigned long actualMs = motion.elapsedUs / 1000;
+  Serial.printf(MC_TAG " ✅ Mouvement terminé: %s en %lu ms\n", positionName(currentPosition), actualMs);
+  sendCommandResponse(motion.command, motion.commandId, "success", actualMs, motion.requestedMs);
 }
 
-void webSocketEvent(WStype_t type, uint8_t * payload, size_t length) {
-  switch(type) {
-    case WStype_CONNECTED:
-      Serial.println("[SWITCH TRACK] 🟢 Connecté au serveur WebSocket");
-      authenticateModule();
-      break;
-      
-    case WStype_DISCONNECTED:
-      Serial.println("[SWITCH TRACK] 🔴 Déconnexion du serveur");
-      isAuthenticated = false;
-      digitalWrite(LED_LEFT_PIN, LOW);
-      digitalWrite(LED_RIGHT_PIN, LOW);
-      break;
-      
-    case WStype_TEXT: {
-      Serial.println("[SWITCH TRACK] 📡 Message reçu: " + String((char*)payload));
-      
-      JsonDocument doc;
-      deserializeJson(doc, (char*)payload);
-      
-      String msgType = doc["type"].as<String>();
-      
-      if (msgType == "connected") {
-        handleConnected((char*)payload);
-      } else if (msgType == "command") {
-        handleCommand((char*)payload);
-      } else if (msgType == "error") {
-        handleError((char*)payload);
-      } else {
-        Serial.println("[SWITCH TRACK] ⚠️ Événement non géré: '" + msgType + "'");
-        Serial.println("[SWITCH TRACK] 🔍 Message complet: " + String((char*)payload));
-      }
-      break;
-    }
-    
-    default:
-      break;
+// Mouvement coupé par un arrêt d'urgence : position inconnue jusqu'à la prochaine bascule, la
+// commande interrompue reçoit estop_latched
+void checkMotionInterrupted() {
+  if (!motion.interrupted) return;
+  motion.interrupted = false;
+
+  currentPosition = POSITION_UNKNOWN;
+  unsigned long actualMs = motion.elapsedUs / 1000;
+  Serial.printf(MC_TAG " ⚠️ Mouvement vers %s interrompu après %lu ms - position inconnue\n",
+                positionName(motion.target), actualMs);
+  sendCommandResponse(motion.command, motion.commandId, "estop_latched", actualMs, motion.requestedMs);
+}
+
+// Exécuté dans la tâche esp_timer à MOTION_TICK_US
+void onMotionTick(void* arg) {
+  if (!motion.active || estop.latched) return;
+
+  uint32_t elapsed = (uint32_t)esp_timer_get_time() - motion.startUs;
+  if (elapsed >= motion.travelUs) {
+    writeServoAngleQ8(motion.toAngle << 8);
+    motion.elapsedUs = elapsed;
+    motion.active = false;
+    motion.done = true;
+    esp_timer_stop(motionTimer);
+    return;
   }
+
+  // Profil en S (smoothstep) en virgule fixe Q16 : s = t²(3 - 2t), vitesse nulle aux extrémités
+  uint32_t t = (uint32_t)(((uint64_t)elapsed << 16) / motion.travelUs);
+  uint64_t t2 = ((uint64_t)t * t) >> 16;
+  uint32_t s = (uint32_t)((t2 * ((3UL << 16) - 2 * t)) >> 16);
+  int32_t deltaQ8 = ((int32_t)motion.toAngle << 8) - motion.fromAngleQ8;
+  writeServoAngleQ8(motion.fromAngleQ8 + (int32_t)(((int64_t)deltaQ8 * s) >> 16));
 }
 
-void authenticateModule() {
-  Serial.println("[SWITCH TRACK] � Authentification WebSocket natif...");
-  
-  // Format WebSocket natif pour Solution A
-  JsonDocument authData;
-  authData["type"] = "module_identify";
-  authData["moduleId"] = MODULE_ID;
-  authData["password"] = MODULE_PASSWORD;
-  authData["moduleType"] = "switch-track";
-  authData["uptime"] = millis() - uptimeStart;
-  authData["position"] = currentPosition;
-  
-  String authMessage;
-  serializeJson(authData, authMessage);
-  webSocket.sendTXT(authMessage);
-  
-  Serial.println("[SWITCH TRACK] 📤 Authentification envoyée: " + authMessage);
+void servoAttach() {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  ledcAttach(SERVO_PIN, SERVO_PWM_HZ, SERVO_PWM_BITS);
+#else
+  ledcSetup(SERVO_LEDC_CHANNEL, SERVO_PWM_HZ, SERVO_PWM_BITS);
+  ledcAttachPin(SERVO_PIN, SERVO_LEDC_CHANNEL);
+#endif
 }
 
-void handleConnected(const char* payload) {
-  Serial.println("[SWITCH TRACK] ✅ Module authentifié WebSocket natif");
-  
-  isAuthenticated = true;
-  updateLEDs(); // Mettre à jour les LEDs selon la position
-  
-  // Envoyer télémétrie initiale
-  delay(1000);
-  sendTelemetry();
+// Angle en degrés Q8 (1/256 de degré) -> largeur d'impulsion -> rapport cyclique
+void writeServoAngleQ8(int32_t angleQ8) {
+  angleQ8 = constrain(angleQ8, 0, 180 << 8);
+  servoAngleQ8 = angleQ8;
+  uint32_t pulseUs = SERVO_MIN_PULSE_US +
+                     (uint32_t)(((uint64_t)(SERVO_MAX_PULSE_US - SERVO_MIN_PULSE_US) * angleQ8) / (180 << 8));
+  uint32_t duty = (uint32_t)(((uint64_t)pulseUs << SERVO_PWM_BITS) * SERVO_PWM_HZ / 1000000);
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  ledcWrite(SERVO_PIN, duty);
+#else
+  ledcWrite(SERVO_LEDC_CHANNEL, duty);
+#endif
 }
 
-void handleCommand(const char* payload) {
-  if (!isAuthenticated) {
-    Serial.println("[SWITCH TRACK] ⚠️ Commande refusée - non authentifié");
-    return;
-  }
-  
-  // Parse du JSON WebSocket natif
-  JsonDocument doc;
-  deserializeJson(doc, payload);
-  
-  String command = doc["data"]["command"];
-  Serial.println("[SWITCH TRACK] 🎮 Commande reçue: " + command);
-  
-  String newPosition = currentPosition;
-  String status = "success";
-  
-  // Traitement des commandes
-  if (command == "switch_left" || command == "left" || command == "switch_to_A") {
-    newPosition = "left";
-    Serial.println("[SWITCH TRACK] 🔄 Aiguillage basculé vers la GAUCHE");
-    updateLEDs(); // Allumer LED gauche
-    
-  } else if (command == "switch_right" || command == "right" || command == "switch_to_B") {
-    newPosition = "right";
-    Serial.println("[SWITCH TRACK] 🔄 Aiguillage basculé vers la DROITE");
-    updateLEDs(); // Allumer LED droite
-    
-  } else if (command == "get_position") {
-    // Pas de changement de position, juste retourner l'état
-    Serial.println("[SWITCH TRACK] 📍 Position actuelle: " + currentPosition);
-    
-  } else {
-    Serial.println("[SWITCH TRACK] ❌ Commande inconnue: " + command);
-    status = "unknown_command";
+uint8_t angleOf(TrackPosition position) {
+  return position == POSITION_RIGHT ? ANGLE_RIGHT : ANGLE_LEFT;
+}
+
+// Vitesse 1-100 -> durée de course ; la fenêtre déclarée la raccourcit, dans la limite mécanique
+uint32_t travelTimeMs(uint8_t speed, uint32_t durationMs) {
+  speed = constrain(speed, 1, 100);
+  uint32_t travelMs = TRAVEL_MAX_MS - (uint32_t)(speed - 1) * (TRAVEL_MAX_MS - TRAVEL_MIN_MS) / 99;
+  if (durationMs > 0 && travelMs > durationMs) {
+    travelMs = durationMs > TRAVEL_MIN_MS ? durationMs : TRAVEL_MIN_MS;
   }
-  
-  currentPosition = newPosition;
-  
-  // Envoyer la réponse de commande (WebSocket natif)
-  sendCommandResponse(command, status, currentPosition);
-  
-  Serial.println("[SWITCH TRACK] ✅ Commande exécutée: " + currentPosition);
+  return travelMs;
 }
 
-void handleError(const char* payload) {
-  Serial.println("[SWITCH TRACK] ❌ Erreur reçue du serveur");
-  
-  isAuthenticated = false;
-  // Éteindre toutes les LEDs en cas d'erreur
+// ============================================================================
+// ARRÊT D'URGENCE LAN
+// ============================================================================
+
+// Appelé par emergencyStop() : le servo s'immobilise sur place, LEDs éteintes. Un mouvement
+// en cours (ou terminé mais pas encore signalé) est traité par checkMotionInterrupted()
+void cutOutputs() {
+  esp_timer_stop(motionTimer);
+  if (motion.active || motion.done) {
+    motion.elapsedUs = (uint32_t)esp_timer_get_time() - motion.startUs;
+    motion.interrupted = true;
+  }
+  motion.active = false;
+  motion.done = false;
   digitalWrite(LED_LEFT_PIN, LOW);
   digitalWrite(LED_RIGHT_PIN, LOW);
 }
 
-// Fonction sendTelemetry supprimée - pas nécessaire avec Socket.io
-// Socket.io gère automatiquement la détection de déconnexion
+// ============================================================================
+// TIMELINES COMPILÉES
+// ============================================================================
+
+// Taille des opérandes par opcode (-1 : opcode non pris en charge par ce module)
+int8_t timelineOperandBytes(uint8_t opcode) {
+  switch (opcode) {
+    case OP_SWITCH_LEFT:  return 1;  // vitesse
+    case OP_SWITCH_RIGHT: return 1;  // vitesse
+    default:              return -1;
+  }
+}
+
+void executeTimelineStep(uint8_t opcode, uint16_t durationMs, const uint8_t* operands) {
+  QueuedCommand step = {};
+  step.receivedAt = millis();
+  step.durationMs = durationMs;
+  step.params.speed = operands[0];
+
+  if (opcode == OP_SWITCH_LEFT) {
+    strlcpy(step.name, "switch_left", COMMAND_NAME_MAX);
+    startMotion(step, POSITION_LEFT);
+  } else if (opcode == OP_SWITCH_RIGHT) {
+    strlcpy(step.name, "switch_right", COMMAND_NAME_MAX);
+    startMotion(step, POSITION_RIGHT);
+  }
+}
+
+// ============================================================================
+// MESSAGES D'ÉTAT ET LEDS
+// ============================================================================
+
+void writeModuleState(JsonDocument& doc, StateReport report) {
+  doc["position"] = positionName(currentPosition);
+  if (report == REPORT_TELEMETRY) doc["estop"] = estop.latched;
+}
+
+void writeModuleSummaries(JsonObject summary) {
+}
+
+// LEDs selon la position une fois authentifié, éteintes hors session (déconnexion, erreur)
+void onSessionChanged(bool authenticated) {
+  if (authenticated) {
+    updateLEDs();
+  } else {
+    digitalWrite(LED_LEFT_PIN, LOW);
+    digitalWrite(LED_RIGHT_PIN, LOW);
+  }
+}
+
+void printModuleMemory() {
+}
 
 void updateLEDs() {
-  if (currentPosition == "left") {
+  if (currentPosition == POSITION_LEFT) {
     digitalWrite(LED_LEFT_PIN, HIGH);   // LED gauche ON
     digitalWrite(LED_RIGHT_PIN, LOW);   // LED droite OFF
-    Serial.println("[SWITCH TRACK] 💡 LED GAUCHE allumée");
-  } else if (currentPosition == "right") {
+    Serial.println(MC_TAG " 💡 LED GAUCHE allumée");
+  } else if (currentPosition == POSITION_RIGHT) {
     digitalWrite(LED_LEFT_PIN, LOW);    // LED gauche OFF
     digitalWrite(LED_RIGHT_PIN, HIGH);  // LED droite ON
-    Serial.println("[SWITCH TRACK] 💡 LED DROITE allumée");
+    Serial.println(MC_TAG " 💡 LED DROITE allumée");
+  } else {
+    digitalWrite(LED_LEFT_PIN, LOW);    // Position inconnue : aucune LED
+    digitalWrite(LED_RIGHT_PIN, LOW);
   }
 }
 
-// Fonctions WebSocket natif
-void sendCommandResponse(const String& command, const String& status, const String& position) {
-  if (!isAuthenticated) return;
-  
-  JsonDocument doc;
-  doc["type"] = "command_response";
-  doc["moduleId"] = MODULE_ID;
-  doc["password"] = MODULE_PASSWORD;
-  doc["command"] = command;
-  doc["status"] = status;
-  doc["position"] = position;
-  
-  String message;
-  serializeJson(doc, message);
-  webSocket.sendTXT(message);
-  
-  Serial.printf("[SWITCH TRACK] 📤 Réponse: %s -> %s\n", command.c_str(), status.c_str());
-}
-
-void sendHeartbeat() {
-  if (!isAuthenticated) return;
-  
-  JsonDocument doc;
-  doc["type"] = "heartbeat";
-  doc["moduleId"] = MODULE_ID;
-  doc["password"] = MODULE_PASSWORD;
-  doc["uptime"] = millis() - uptimeStart;
-  doc["position"] = currentPosition;
-  doc["wifiRSSI"] = WiFi.RSSI();
-  doc["freeHeap"] = ESP.getFreeHeap();
-  
-  String message;
-  serializeJson(doc, message);
-  webSocket.sendTXT(message);
-  
-  Serial.println("[SWITCH TRACK] 💓 Heartbeat envoyé");
+const char* positionName(TrackPosition position) {
+  switch (position) {
+    case POSITION_LEFT:  return "left";
+    case POSITION_RIGHT: return "right";
+    default:             return "unknown";
+  }
 }
 
-void sendTelemetry() {
-  if (!isAuthenticated) return;
-  
-  JsonDocument doc;
-  doc["type"] = "telemetry";
-  doc["moduleId"] = MODULE_ID;
-  doc["password"] = MODULE_PASSWORD;
-  doc["uptime"] = millis() - uptimeStart;
-  doc["position"] = currentPosition;
-  doc["status"] = "operational";
-  
-  String message;
-  serializeJson(doc, message);
-  webSocket.sendTXT(message);
-  
-  Serial.println("[SWITCH TRACK] 📊 Télémétrie envoyée");
-}
\ No newline at end of file
@@ -135,7 +135,8 @@ function initializePagination() {
 
 /**
  * Initialise les filtres de colonnes pour les tables d'administration
- * Configure les événements de filtrage et les boutons de réinitialisation
+ * Les filtres sont appliqués après une courte pause de saisie : rechargement du flux pour
+ * les filtres serveur, simple réaffichage pour les filtres sur dates formatées
  * @returns {void}
  * @public
  */
@@ -145,8 +146,9 @@ function initializeFilters() {
 
   columnFilters.forEach(filter => {
     const eventType = filter.tagName.toLowerCase() === 'select' ? 'change' : 'input';
+    const tableType = filter.id.startsWith('filter-user-') ? 'users' : 'modules';
     filter.addEventListener(eventType, function () {
-      applyFilters();
+      scheduleFilter(tableType, this.getAttribute('data-column'));
     });
   });
 
@@ -167,6 +169,30 @@ function initializeFilters() {
   }
 }
 
+/**
+ * Programme l'application des filtres d'une table après la pause de saisie
+ * Un filtre serveur modifié pendant l'attente impose le rechargement du flux
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @param {string} column - Colonne du filtre modifié
+ * @returns {void}
+ * @private
+ */
+function scheduleFilter(tableType, column) {
+  const data = tableData[tableType];
+  data.reloadPending = data.reloadPending || SERVER_FILTERS[tableType].includes(column);
+
+  clearTimeout(data.filterTimer);
+  data.filterTimer = setTimeout(() => {
+    paginationState[tableType].page = 1;
+    if (data.reloadPending) {
+      data.reloadPending = false;
+      loadTable(tableType);
+    } else {
+      refreshView(tableType);
+    }
+  }, FILTER_DEBOUNCE_MS);
+}
+
 /**
  * Efface tous les filtres d'une table spécifique
  * @param {string} tableType - Type de table à réinitialiser ('users' ou 'modules')
@@ -182,54 +208,18 @@ function clearFilters(tableType) {
     filter.value = '';
   });
 
-  applyFilters();
-}
-
-/**
- * Applique tous les filtres sélectionnés aux tables (côté client uniquement)
- * Met à jour le tri, la pagination et l'affichage des résultats filtrés
- * @returns {void}
- * @public
- */
-function applyFilters() {
-  // Filtrer les utilisateurs
-  filterTable('users');
-
-  // Filtrer les modules
-  filterTable('modules');
-
-  // Réappliquer le tri après filtrage
-  applySorting('users');
-  applySorting('modules');
-
-  // Réinitialiser la pagination après filtrage
-  paginationState.users.page = 1;
-  paginationState.modules.page = 1;
-
-  // Réappliquer la pagination avec les nouveaux résultats
-  applyClientSidePagination('users');
-  applyClientSidePagination('modules');
-  updatePaginationControls('users');
-  updatePaginationControls('modules');
+  clearTimeout(tableData[tableType].filterTimer);
+  tableData[tableType].reloadPending = false;
+  loadTable(tableType);
 }
 
 /**
- * Filtre une table spécifique basée sur ses filtres de colonnes actifs
- * Cache/affiche les rangées selon les critères de filtrage définis
- * @param {string} tableType - Type de table à filtrer ('users' ou 'modules')
- * @returns {void}
- * @public
+ * Lit les filtres actifs d'une table
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @returns {Object} Valeurs en minuscules par colonne
+ * @private
  */
-function filterTable(tableType) {
-  const table = document.querySelector(`.admin-table[data-table="${tableType}"]`);
-  if (!table) {
-    return;
-  }
-
-  const rows = table.querySelectorAll('tbody tr:not(.filter-row)');
-  let visibleCount = 0;
-
-  // Récupérer tous les filtres pour cette table
+function readFilters(tableType) {
   const prefix = tableType === 'users' ? 'user' : 'module';
   const filters = {};
 
@@ -241,116 +231,326 @@ function filterTable(tableType) {
     }
   });
 
-  rows.forEach(row => {
-    let isVisible = true;
-
-    // Appliquer chaque filtre
-    Object.entries(filters).forEach(([column, filterValue]) => {
-      if (!isVisible) return; // Déjà masqué
-
-      let cellValue = '';
-
-      // Récupérer la valeur de la cellule selon la colonne
-      const cells = row.querySelectorAll('td');
-
-      switch (column) {
-        case 'name':
-          cellValue =
-            tableType === 'users'
-              ? cells[0]
-                ? cells[0].textContent.toLowerCase()
-                : ''
-              : cells[1]
-                ? cells[1].textContent.toLowerCase()
-                : '';
-          break;
-        case 'email':
-          cellValue = cells[1] ? cells[1].textContent.toLowerCase() : '';
-          break;
-        case 'role':
-          cellValue = cells[2] ? cells[2].textContent.toLowerCase() : '';
-          break;
-        case 'module_count':
-          cellValue = cells[3] ? cells[3].textContent.toLowerCase() : '';
-          break;
-        case 'last_login':
-          cellValue = cells[4] ? cells[4].textContent.toLowerCase() : '';
-          break;
-        case 'created_at':
-          cellValue = cells[5] ? cells[5].textContent.toLowerCase() : '';
-          break;
-        case 'module_id':
-          cellValue = cells[0] ? cells[0].textContent.toLowerCase() : '';
-          break;
-        case 'type':
-          cellValue = cells[2] ? cells[2].textContent.toLowerCase() : '';
-          break;
-        case 'user_name':
-          cellValue = cells[3] ? cells[3].textContent.toLowerCase() : '';
-          break;
-        case 'status':
-          cellValue = cells[4] ? cells[4].textContent.toLowerCase() : '';
-          break;
-        case 'last_seen':
-          cellValue = cells[5] ? cells[5].textContent.toLowerCase() : '';
-          break;
-        default:
-          // Recherche dans toute la ligne si colonne non spécifiée
-          cellValue = row.textContent.toLowerCase();
-      }
+  return filters;
+}
 
-      if (!cellValue.includes(filterValue)) {
-        isVisible = false;
-      }
+/**
+ * Charge une table depuis son flux NDJSON avec les filtres serveur courants
+ * Un chargement en cours est annulé ; les lignes s'affichent au fil de la réception
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @returns {Promise<void>}
+ * @public
+ */
+async function loadTable(tableType) {
+  const data = tableData[tableType];
+  data.controller?.abort();
+  const controller = new AbortController();
+  data.controller = controller;
+
+  const params = new URLSearchParams();
+  Object.entries(readFilters(tableType)).forEach(([column, value]) => {
+    if (SERVER_FILTERS[tableType].includes(column)) {
+      params.set(column, value);
+    }
+  });
+
+  data.rows = [];
+  data.byKey.clear();
+  data.loading = true;
+  paginationState[tableType].page = 1;
+  refreshView(tableType);
+
+  try {
+    const response = await fetch(`/admin/api/${tableType}?${params}`, {
+      signal: controller.signal,
     });
+    if (!response.ok) {
+      throw new Error(`HTTP ${response.status}`);
+    }
 
-    // Appliquer la visibilité
-    if (isVisible) {
-      row.style.display = '';
-      row.classList.remove('filtered-hidden');
-      visibleCount++;
-    } else {
-      row.style.display = 'none';
-      row.classList.add('filtered-hidden');
+    await readNdjson(
+      response,
+      item => {
+        if (item.error) throw new Error(item.error);
+        if (item.done) return;
+        data.rows.push(item);
+        data.byKey.set(getRowKey(tableType, item), item);
+      },
+      () => scheduleRefresh(tableType)
+    );
+  } catch (error) {
+    if (error.name !== 'AbortError') {
+      console.error(`Error loading admin ${tableType}:`, error);
+      window.showToast?.(`⚠️ ${tableType}: ${error.message}`, 'error', 5000);
+    }
+  } finally {
+    // Un chargement plus récent a pris la main : il se chargera de l'affichage
+    if (data.controller === controller) {
+      data.controller = null;
+      data.loading = false;
+      refreshView(tableType);
+    }
+  }
+}
+
+/**
+ * Lit une réponse NDJSON objet par objet au fil de la réception
+ * @param {Response} response - Réponse fetch en flux
+ * @param {Function} onItem - Appelée pour chaque objet JSON reçu
+ * @param {Function} onChunk - Appelée après chaque bloc reçu
+ * @returns {Promise<void>}
+ * @private
+ */
+async function readNdjson(response, onItem, onChunk) {
+  const reader = response.body.getReader();
+  const decoder = new TextDecoder();
+  let buffer = '';
+
+  for (;;) {
+    const { value, done } = await reader.read();
+    buffer += decoder.decode(value, { stream: !done });
+
+    const lines = buffer.split('\n');
+    buffer = lines.pop();
+    lines.filter(line => line.trim()).forEach(line => onItem(JSON.parse(line)));
+
+    if (done) break;
+    onChunk();
+  }
+
+  if (buffer.trim()) {
+    onItem(JSON.parse(buffer));
+  }
+}
+
+/**
+ * Clé d'index temps réel d'une ligne
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @param {Object} row - Utilisateur ou module
+ * @returns {string} id utilisateur ou module_id
+ * @private
+ */
+function getRowKey(tableType, row) {
+  return tableType === 'users' ? String(row.id) : row.module_id;
+}
+
+/**
+ * Recalcule la vue d'une table (filtres, tri) et réaffiche la page courante
+ * Les filtres serveur sont réappliqués ici pour suivre les changements temps réel
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @returns {void}
+ * @public
+ */
+function refreshView(tableType) {
+  const data = tableData[tableType];
+  clearTimeout(data.refreshTimer);
+  data.refreshTimer = null;
+
+  const filters = readFilters(tableType);
+  const { column, order } = sortingState[tableType];
+  const direction = order === 'asc' ? 1 : -1;
+
+  data.view = data.rows
+    .filter(row => matchesFilters(tableType, row, filters))
+    .map(row => ({ row, value: getSortValue(tableType, row, column) }))
+    .sort((a, b) => {
+      if (a.value < b.value) return -direction;
+      if (a.value > b.value) return direction;
+      return 0;
+    })
+    .map(entry => entry.row);
+
+  const pagination = paginationState[tableType];
+  const totalPages = Math.max(1, Math.ceil(data.view.length / pagination.itemsPerPage));
+  pagination.page = Math.min(pagination.page, totalPages);
+
+  applyClientSidePagination(tableType);
+  updatePaginationControls(tableType);
+}
+
+/**
+ * Programme un réaffichage groupé (réception du flux, mises à jour temps réel)
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @returns {void}
+ * @private
+ */
+function scheduleRefresh(tableType) {
+  const data = tableData[tableType];
+  if (data.refreshTimer) return;
+  data.refreshTimer = setTimeout(() => refreshView(tableType), VIEW_REFRESH_MS);
+}
+
+/**
+ * Vérifie qu'une ligne satisfait les filtres actifs de sa table
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @param {Object} row - Utilisateur ou module
+ * @param {Object} filters - Filtres actifs (voir readFilters)
+ * @returns {boolean} True si la ligne est retenue
+ * @private
+ */
+function matchesFilters(tableType, row, filters) {
+  return Object.entries(filters).every(([column, filterValue]) => {
+    switch (column) {
+      case 'role':
+        return filterValue === 'admin' ? !!row.is_admin : !row.is_admin;
+      case 'module_count':
+        return Number(row.module_count) === parseInt(filterValue);
+      case 'status':
+        return row.status === filterValue;
+      default:
+        return getCellText(tableType, row, column).toLowerCase().includes(filterValue);
     }
   });
+}
 
-  // Afficher un message si aucun résultat
-  showNoResultsMessage(table, visibleCount);
+/**
+ * Texte affiché dans une colonne, utilisé pour le rendu et les filtres texte
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @param {Object} row - Utilisateur ou module
+ * @param {string} column - Colonne
+ * @returns {string} Texte de la cellule
+ * @private
+ */
+function getCellText(tableType, row, column) {
+  const locale = window.MC?.locale || 'fr-FR';
+
+  if (tableType === 'users') {
+    switch (column) {
+      case 'role':
+        return row.is_admin ? getLabel('administrator') : getLabel('user');
+      case 'last_login':
+        return row.last_login ? new Date(row.last_login).toLocaleString(locale) : getLabel('never');
+      case 'created_at':
+        return new Date(row.created_at).toLocaleDateString(locale);
+      default:
+        return String(row[column] ?? '');
+    }
+  }
+
+  switch (column) {
+    case 'name':
+      return row.name || getLabel('withoutName');
+    case 'type':
+      return row.type || getLabel('unknown');
+    case 'status':
+      return row.status === 'online' ? getLabel('online') : getLabel('offline');
+    case 'last_seen':
+      return row.lastSeen ? new Date(row.lastSeen).toLocaleString(locale) : getLabel('never');
+    default:
+      return String(row[column] ?? '');
+  }
+}
+
+/**
+ * Libellé traduit fourni par la page (window.MC.labels)
+ * @param {string} key - Clé du libellé
+ * @returns {string} Libellé, ou la clé si absent
+ * @private
+ */
+function getLabel(key) {
+  return window.MC?.labels?.[key] || key;
+}
+
+/**
+ * Crée une cellule de tableau
+ * @param {string|Node} content - Texte ou élément à insérer
+ * @param {string} [className] - Classe CSS de la cellule
+ * @returns {HTMLTableCellElement} Cellule créée
+ * @private
+ */
+function createCell(content, className) {
+  const cell = document.createElement('td');
+  if (className) cell.className = className;
+  cell.append(content);
+  return cell;
+}
+
+/**
+ * Crée la ligne HTML d'un utilisateur
+ * @param {Object} user - Utilisateur issu du flux
+ * @returns {HTMLTableRowElement} Ligne créée
+ * @private
+ */
+function renderUserRow(user) {
+  const row = document.createElement('tr');
+  row.dataset.userId = user.id;
+
+  const role = document.createElement('span');
+  role.className = `${user.is_admin ? 'badge badge-admin' : 'badge badge-user'} user-role`;
+  role.textContent = getCellText('users', user, 'role');
+
+  row.append(
+    createCell(user.name, 'user-name'),
+    createCell(user.email, 'user-email'),
+    createCell(role),
+    createCell(String(user.module_count)),
+    createCell(getCellText('users', user, 'last_login')),
+    createCell(getCellText('users', user, 'created_at'))
+  );
+  return row;
+}
+
+/**
+ * Crée la ligne HTML d'un module
+ * @param {Object} module - Module issu du flux
+ * @returns {HTMLTableRowElement} Ligne créée
+ * @private
+ */
+function renderModuleRow(module) {
+  const row = document.createElement('tr');
+  row.dataset.moduleId = module.module_id;
+
+  const moduleId = document.createElement('code');
+  moduleId.textContent = module.module_id;
+
+  const type = document.createElement('span');
+  type.className = 'type-badge-container';
+  type.dataset.moduleType = module.type || 'Unknown';
+  type.innerHTML = getTypeBadge(module.type);
+
+  const status = document.createElement('span');
+  status.className = `status ${module.status === 'online' ? 'status-online' : 'status-offline'}`;
+  status.textContent = getCellText('modules', module, 'status');
+
+  row.append(
+    createCell(moduleId),
+    createCell(getCellText('modules', module, 'name')),
+    createCell(type),
+    createCell(module.user_name || ''),
+    createCell(status),
+    createCell(getCellText('modules', module, 'last_seen'))
+  );
+  return row;
 }
 
 /**
  * Affiche un message si aucun résultat n'est trouvé
  * @param {HTMLElement} table - L'élément table
- * @param {number} visibleCount - Nombre d'éléments visibles
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @returns {void}
  */
-function showNoResultsMessage(table, visibleCount) {
-  // Supprimer l'ancien message s'il existe
-  const existingMessage = table.querySelector('.no-results-row');
-  if (existingMessage) {
-    existingMessage.remove();
-  }
-
-  if (visibleCount === 0) {
-    const tbody = table.querySelector('tbody');
-    const colCount = table.querySelectorAll('thead th').length;
+function showNoResultsMessage(table, tableType) {
+  const tbody = table.querySelector('tbody');
+  const colCount = table.querySelectorAll('thead th').length;
+  const title = getLabel(tableType === 'users' ? 'noUsers' : 'noModules');
 
-    const messageRow = document.createElement('tr');
-    messageRow.className = 'no-results-row';
-    messageRow.innerHTML = `
+  const messageRow = document.createElement('tr');
+  messageRow.className = 'no-results-row';
+  messageRow.innerHTML = `
             <td colspan="${colCount}" class="empty-state-cell">
                 <div class="empty-state-message">
                     <svg xmlns="http://www.w3.org/2000/svg" fill="none" viewBox="0 0 24 24" stroke="currentColor">
                         <path stroke-linecap="round" stroke-linejoin="round" stroke-width="2" d="M21 21l-6-6m2-5a7 7 0 11-14 0 7 7 0 0114 0z" />
                     </svg>
-                    <h4>Aucun résultat trouvé</h4>
-                    <p>Aucun élément ne correspond aux filtres sélectionnés. Essayez d'ajuster vos critères de recherche.</p>
+                    <h4></h4>
+                    <p></p>
                 </div>
             </td>
         `;
+  messageRow.querySelector('h4').textContent = title;
+  messageRow.querySelector('p').textContent = getLabel('tryModifyFilters');
 
-    tbody.appendChild(messageRow);
-  }
+  tbody.replaceChildren(messageRow);
 }
 
 /**
@@ -375,13 +575,9 @@ function initializeSorting() {
     });
   });
 
-  // Appliquer le tri initial par défaut
-  setTimeout(() => {
-    updateSortArrows('users', 'last_login', 'desc');
-    updateSortArrows('modules', 'last_seen', 'desc');
-    applySorting('users');
-    applySorting('modules');
-  }, 200);
+  // Flèches du tri par défaut (appliqué au chargement des données)
+  updateSortArrows('users', sortingState.users.column, sortingState.users.order);
+  updateSortArrows('modules', sortingState.modules.column, sortingState.modules.order);
 }
 
 /**
@@ -404,134 +600,38 @@ function handleSort(tableType, column) {
   // Mettre à jour l'état
   sortingState[tableType] = { column, order: newOrder };
 
-  // Appliquer le tri
-  applySorting(tableType);
-
   // Mettre à jour les flèches
   updateSortArrows(tableType, column, newOrder);
 
-  // Réappliquer les filtres et la pagination
-  applyClientSidePagination(tableType);
-  updatePaginationControls(tableType);
+  // Retrier les données et réafficher la page courante
+  refreshView(tableType);
 }
 
 /**
- * Applique le tri sur une table selon l'état de tri actuel
- * Gère le tri spécialisé pour dates, nombres et statuts avec parsing intelligent
- * @param {string} tableType - Type de table à trier ('users' ou 'modules')
- * @returns {void}
- * @public
+ * Valeur de tri d'une ligne pour une colonne, lue sur les données et non sur le DOM
+ * Dates en horodatage, rôle et statut en 0/1 ("En ligne" avant "Hors ligne" en desc)
+ * @param {string} tableType - Type de table ('users' ou 'modules')
+ * @param {Object} row - Utilisateur ou module
+ * @param {string} column - Colonne triée
+ * @returns {number|string} Valeur comparable
+ * @private
  */
-function applySorting(tableType) {
-  const table = document.querySelector(`.admin-table[data-table="${tableType}"]`);
-  if (!table) return;
-
-  const tbody = table.querySelector('tbody');
-  const rows = Array.from(tbody.querySelectorAll('tr:not(.filter-row):not(.no-results-row)'));
-  const { column, order } = sortingState[tableType];
-
-  // Fonction pour obtenir la valeur de tri d'une cellule
-  const getSortValue = (row, column, tableType) => {
-    const cells = row.querySelectorAll('td');
-    let cellIndex = 0;
-    let cellValue = '';
-
-    if (tableType === 'users') {
-      switch (column) {
-        case 'name':
-          cellIndex = 0;
-          break;
-        case 'email':
-          cellIndex = 1;
-          break;
-        case 'is_admin':
-          cellIndex = 2;
-          break;
-        case 'module_count':
-          cellIndex = 3;
-          break;
-        case 'last_login':
-          cellIndex = 4;
-          break;
-        case 'created_at':
-          cellIndex = 5;
-          break;
-        default:
-          cellIndex = 0;
-      }
-    } else if (tableType === 'modules') {
-      switch (column) {
-        case 'module_id':
-          cellIndex = 0;
-          break;
-        case 'name':
-          cellIndex = 1;
-          break;
-        case 'type':
-          cellIndex = 2;
-          break;
-        case 'user_name':
-          cellIndex = 3;
-          break;
-        case 'status':
-          cellIndex = 4;
-          break;
-        case 'last_seen':
-          cellIndex = 5;
-          break;
-        default:
-          cellIndex = 0;
-      }
-    }
-
-    cellValue = cells[cellIndex] ? cells[cellIndex].textContent.trim() : '';
-
-    // Traitement spécial pour certaines colonnes
-    if (column === 'module_count') {
-      return parseInt(cellValue) || 0;
-    } else if (column === 'last_login' || column === 'last_seen' || column === 'created_at') {
-      if (cellValue === 'Jamais') return new Date(0);
-
-      // Parser les dates françaises (DD/MM/YYYY HH:mm:ss)
-      const dateMatch = cellValue.match(/(\d{2})\/(\d{2})\/(\d{4})\s+(\d{2}):(\d{2}):(\d{2})/);
-      if (dateMatch) {
-        const [, day, month, year, hour, minute, second] = dateMatch;
-        return new Date(year, month - 1, day, hour, minute, second);
-      }
-
-      // Fallback pour d'autres formats
-      const simpleMatch = cellValue.match(/(\d{2})\/(\d{2})\/(\d{4})/);
-      if (simpleMatch) {
-        const [, day, month, year] = simpleMatch;
-        return new Date(year, month - 1, day);
-      }
-
-      return new Date(cellValue);
-    } else if (column === 'is_admin') {
-      return cellValue.toLowerCase().includes('admin') ? 1 : 0;
-    } else if (column === 'status') {
-      // "En ligne" doit être trié avant "Hors ligne"
-      const onlineText = window.t('common.online').toLowerCase();
-      return cellValue.toLowerCase().includes(onlineText) ? 1 : 0;
-    }
-
-    return cellValue.toLowerCase();
-  };
-
-  // Trier les lignes
-  rows.sort((a, b) => {
-    const valueA = getSortValue(a, column, tableType);
-    const valueB = getSortValue(b, column, tableType);
-
-    let comparison = 0;
-    if (valueA < valueB) comparison = -1;
-    else if (valueA > valueB) comparison = 1;
-
-    return order === 'asc' ? comparison : -comparison;
-  });
-
-  // Réorganiser les lignes dans le DOM
-  rows.forEach(row => tbody.appendChild(row));
+function getSortValue(tableType, row, column) {
+  switch (column) {
+    case 'module_count':
+      return Number(row.module_count) || 0;
+    case 'last_login':
+    case 'created_at':
+      return row[column] ? new Date(row[column]).getTime() : 0;
+    case 'last_seen':
+      return row.lastSeen ? new Date(row.lastSeen).getTime() : 0;
+    case 'is_admin':
+      return row.is_admin ? 1 : 0;
+    case 'status':
+      return row.status === 'online' ? 1 : 0;
+    default:
+      return getCellText(tableType, row, column).toLowerCase();
+  }
 }
 
 /**
@@ -620,8 +720,10 @@ function initializeAll() {
     initializeFilters();
     initializeSorting();
 
-    // Initialiser la pagination côté client
+    // Initialiser la pagination côté client et charger les listes en flux
     initializeClientSidePagination();
+    loadTable('users');
+    loadTable('modules');
 
     // Initialiser les événements temps réel
     initializeRealTimeEvents();
@@ -654,11 +756,6 @@ function initializeClientSidePagination() {
     }
   }
 
-  // Appliquer la pagination initiale
-  applyClientSidePagination('users');
-  applyClientSidePagination('modules');
-  updatePaginationControls('users');
-  updatePaginationControls('modules');
 }
 
 // Un seul event listener pour éviter les doublons
@@ -676,6 +773,34 @@ const sortingState = {
   modules: { column: 'last_seen', order: 'desc' },
 };
 
+/**
+ * Délai sans saisie avant d'appliquer un filtre
+ * @constant {number}
+ */
+const FILTER_DEBOUNCE_MS = 300;
+
+/**
+ * Intervalle minimum entre deux réaffichages dus au flux ou au temps réel
+ * @constant {number}
+ */
+const VIEW_REFRESH_MS = 500;
+
+/**
+ * Filtres transmis au serveur ; les filtres sur dates formatées restent côté client
+ * @constant {Object}
+ */
+const SERVER_FILTERS = {
+  users: ['name', 'email', 'role', 'module_count'],
+  modules: ['module_id', 'name', 'type', 'user_name', 'status'],
+};
+
+// Données des tables : lignes reçues du flux, index temps réel et vue filtrée/triée
+const tableData = {
+  users: { rows: [], byKey: new Map(), view: [], loading: false, controller: null },
+  modules: { rows: [], byKey: new Map(), view: [], loading: false, controller: null },
+};
+
+
 /**
  * Fonctions de pagination côté client (sans URL)
  */
@@ -690,7 +815,7 @@ window.changeItemsPerPage = function (select) {
   paginationState[table].itemsPerPage = itemsPerPage;
   paginationState[table].page = 1; // Retour à la première page
 
-  // Réappliquer les filtres et la pagination
+  // Réappliquer la pagination
   applyClientSidePagination(table);
   updatePaginationControls(table);
 };
@@ -707,18 +832,9 @@ window.navigatePage = function (table, direction, event) {
   if (direction === 'prev') {
     newPage = Math.max(1, currentPage - 1);
   } else if (direction === 'next') {
-    // Calculer le nombre maximum de pages basé sur les éléments visibles
-    const tableElement = document.querySelector(`.admin-table[data-table="${table}"]`);
-    if (tableElement) {
-      const allRows = Array.from(
-        tableElement.querySelectorAll('tbody tr:not(.filter-row):not(.no-results-row)')
-      );
-      const visibleRows = allRows.filter(
-        row => !row.classList.contains('filtered-hidden') && row.style.display !== 'none'
-      );
-      const maxPages = Math.ceil(visibleRows.length / paginationState[table].itemsPerPage);
-      newPage = Math.min(maxPages || 1, currentPage + 1);
-    }
+    // Calculer le nombre maximum de pages sur la vue filtrée
+    const maxPages = Math.ceil(tableData[table].view.length / paginationState[table].itemsPerPage);
+    newPage = Math.min(maxPages || 1, currentPage + 1);
   }
 
   if (newPage !== currentPage) {
@@ -731,8 +847,8 @@ window.navigatePage = function (table, direction, event) {
 };
 
 /**
- * Applique la pagination côté client aux lignes visibles d'une table
- * Masque toutes les lignes puis affiche uniquement celles de la page courante
+ * Affiche la page courante d'une table
+ * Seules les lignes de cette page existent dans le DOM, quel que soit le volume chargé
  * @param {string} tableType - Type de table à paginer ('users' ou 'modules')
  * @returns {void}
  * @public
@@ -741,29 +857,18 @@ function applyClientSidePagination(tableType) {
   const table = document.querySelector(`.admin-table[data-table="${tableType}"]`);
   if (!table) return;
 
-  // Récupérer seulement les lignes visibles (non filtrées)
-  const allRows = Array.from(
-    table.querySelectorAll('tbody tr:not(.filter-row):not(.no-results-row)')
-  );
-  const visibleRows = allRows.filter(
-    row => !row.classList.contains('filtered-hidden') && row.style.display !== 'none'
-  );
-
+  const { view, loading } = tableData[tableType];
   const { page, itemsPerPage } = paginationState[tableType];
   const startIndex = (page - 1) * itemsPerPage;
-  const endIndex = startIndex + itemsPerPage;
 
-  // D'abord, masquer toutes les lignes paginées
-  allRows.forEach(row => {
-    row.classList.add('pagination-hidden');
-  });
+  if (view.length === 0 && !loading) {
+    showNoResultsMessage(table, tableType);
+    return;
+  }
 
-  // Puis afficher seulement les lignes de la page courante
-  visibleRows.forEach((row, index) => {
-    if (index >= startIndex && index < endIndex) {
-      row.classList.remove('pagination-hidden');
-    }
-  });
+  const render = tableType === 'users' ? renderUserRow : renderModuleRow;
+  const rows = view.slice(startIndex, startIndex + itemsPerPage).map(render);
+  table.querySelector('tbody').replaceChildren(...rows);
 }
 
 /**
@@ -774,19 +879,9 @@ function applyClientSidePagination(tableType) {
  * @public
  */
 function updatePaginationControls(tableType) {
-  const table = document.querySelector(`.admin-table[data-table="${tableType}"]`);
-  if (!table) return;
-
-  // Compter seulement les lignes visibles (non filtrées)
-  const allRows = Array.from(
-    table.querySelectorAll('tbody tr:not(.filter-row):not(.no-results-row)')
-  );
-  const visibleRows = allRows.filter(
-    row => !row.classList.contains('filtered-hidden') && row.style.display !== 'none'
-  );
-
+  const { view, loading } = tableData[tableType];
   const { page, itemsPerPage } = paginationState[tableType];
-  const totalItems = visibleRows.length;
+  const totalItems = view.length;
   const totalPages = Math.ceil(totalItems / itemsPerPage);
   const startItem = totalItems === 0 ? 0 : (page - 1) * itemsPerPage + 1;
   const endItem = Math.min(page * itemsPerPage, totalItems);
@@ -805,87 +900,53 @@ function updatePaginationControls(tableType) {
     nextBtn.style.opacity = nextBtn.disabled ? '0.5' : '1';
   }
 
-  // Mettre à jour l'info de pagination
+  // Mettre à jour l'info de pagination (total provisoire pendant le chargement)
   const paginationInfo = document.querySelector(`.pagination-info[data-table="${tableType}"]`);
   if (paginationInfo) {
     if (totalItems === 0) {
-      paginationInfo.textContent = 'Aucun élément';
+      paginationInfo.textContent = loading ? '…' : 'Aucun élément';
     } else {
-      paginationInfo.textContent = `${startItem}-${endItem} sur ${totalItems}`;
+      paginationInfo.textContent = `${startItem}-${endItem} sur ${totalItems}${loading ? '…' : ''}`;
     }
   }
 }
 
 /**
- * Met à jour le statut d'un module en temps réel dans le tableau
- * Change le texte et les classes CSS avec animation visuelle
+ * Met à jour le statut d'un module en temps réel
+ * Modifie la donnée, puis la ligne si elle est affichée (avec animation)
  * @param {string} moduleId - Identifiant unique du module
  * @param {boolean} isOnline - État de connexion du module
  * @returns {void}
  * @public
  */
 function updateModuleStatus(moduleId, isOnline) {
-  const moduleRow = document.querySelector(`tr[data-module-id="${moduleId}"]`);
-  if (!moduleRow) return;
+  const module = tableData.modules.byKey.get(moduleId);
+  if (!module) return;
 
-  const statusCell = moduleRow.cells[4];
-  if (!statusCell) return;
+  const status = isOnline ? 'online' : 'offline';
+  if (module.status === status) return;
+  module.status = status;
 
-  const statusSpan = statusCell.querySelector('.status');
-  if (!statusSpan) return;
-
-  // Mise à jour simple et directe
-  const newText = isOnline ? 'En ligne' : 'Hors ligne';
-  const newClass = `status ${isOnline ? 'status-online' : 'status-offline'}`;
-
-  statusSpan.textContent = newText;
-  statusSpan.className = newClass;
-
-  // Animation simple
-  statusSpan.classList.add(isOnline ? 'statusChangeOnline' : 'statusChangeOffline');
-  setTimeout(() => {
-    statusSpan.classList.remove('statusChangeOnline', 'statusChangeOffline');
-  }, 3000);
-
-  statusSpan.textContent = newText;
-  statusSpan.className = newClass;
-
-  // Tri automatique après mise à jour
-  applySorting('modules');
-}
-
-/**
- * Met à jour visuellement l'horodatage de dernière activité d'un module
- * Formate la date au format français et met à jour la cellule correspondante
- * @param {string} moduleId - Identifiant unique du module
- * @param {Date} timestamp - Horodatage de la dernière activité
- * @returns {void}
- * @public
- */
-function updateModuleLastSeenInTable(moduleId, timestamp) {
   const moduleRow = document.querySelector(`tr[data-module-id="${moduleId}"]`);
-  if (!moduleRow) return;
-
-  const lastActivityCell = moduleRow.cells[5];
-  if (!lastActivityCell) return;
-
-  // Utiliser la VRAIE timestamp de la télémétrie
-  const realTimestamp = timestamp || new Date();
-  const formattedDate = realTimestamp.toLocaleString('fr-FR', {
-    day: '2-digit',
-    month: '2-digit',
-    year: 'numeric',
-    hour: '2-digit',
-    minute: '2-digit',
-    second: '2-digit',
-  });
+  const statusSpan = moduleRow?.cells[4]?.querySelector('.status');
+  if (statusSpan) {
+    statusSpan.textContent = getCellText('modules', module, 'status');
+    statusSpan.className = `status ${isOnline ? 'status-online' : 'status-offline'}`;
+
+    // Animation simple
+    statusSpan.classList.add(isOnline ? 'statusChangeOnline' : 'statusChangeOffline');
+    setTimeout(() => {
+      statusSpan.classList.remove('statusChangeOnline', 'statusChangeOffline');
+    }, 3000);
+  }
 
-  lastActivityCell.textContent = formattedDate;
+  // Position ou visibilité dépendant du statut : réaffichage groupé
+  scheduleRefresh('modules');
 }
 
 /**
- * Met à jour l'affichage de dernière activité d'un module dans toutes les lignes
- * Gère le formatage automatique si aucun format n'est fourni
+ * Met à jour la dernière activité d'un module
+ * Modifie la donnée, puis la cellule si la ligne est affichée
  * @param {string} moduleId - Identifiant unique du module
  * @param {Date|string} lastSeen - Date de dernière activité
  * @param {string} [lastSeenFormatted] - Date déjà formatée (optionnel)
@@ -893,18 +954,22 @@ function updateModuleLastSeenInTable(moduleId, timestamp) {
  * @public
  */
 function updateModuleLastSeen(moduleId, lastSeen, lastSeenFormatted) {
-  const moduleRows = document.querySelectorAll(`tr[data-module-id="${moduleId}"]`);
+  const module = tableData.modules.byKey.get(moduleId);
+  if (!module) return;
 
-  moduleRows.forEach(row => {
-    // La colonne "Dernière activité" est la 6ème colonne (index 5)
-    const lastSeenCell = row.children[5]; // 0: ID, 1: Nom, 2: Type, 3: Propriétaire, 4: Statut, 5: Dernière activité
-    if (lastSeenCell) {
-      // Utiliser le format déjà formaté ou formater la date
-      const displayText =
-        lastSeenFormatted || (lastSeen ? new Date(lastSeen).toLocaleString('fr-FR') : 'Jamais');
-      lastSeenCell.textContent = displayText;
-    }
-  });
+  module.lastSeen = lastSeen;
+
+  // La colonne "Dernière activité" est la 6ème colonne (index 5)
+  const moduleRow = document.querySelector(`tr[data-module-id="${moduleId}"]`);
+  const lastSeenCell = moduleRow?.children[5];
+  if (lastSeenCell) {
+    lastSeenCell.textContent = lastSeenFormatted || getCellText('modules', module, 'last_seen');
+  }
+
+  // Le tri par défaut porte sur la dernière activité
+  if (sortingState.modules.column === 'last_seen' || readFilters('modules').last_seen) {
+    scheduleRefresh('modules');
+  }
 }
 
 /**
@@ -929,60 +994,46 @@ function updateSimpleStats(data) {
 }
 
 /**
- * Met à jour complètement les données d'un utilisateur dans le tableau
- * Synchronise nom, email et rôle avec les données reçues en temps réel
+ * Met à jour complètement les données d'un utilisateur
+ * Synchronise nom, email et rôle, puis la ligne si elle est affichée
  * @param {Object} user - Objet utilisateur avec propriétés id, name, email, isAdmin
  * @returns {void}
  * @public
  */
 function updateUserInTable(user) {
-  // Chercher la ligne utilisateur par ID
-  const userRows = document.querySelectorAll(`tr[data-user-id="${user.id}"]`);
-
-  userRows.forEach(row => {
-    // Mettre à jour le nom
-    const nameCell = row.querySelector('.user-name');
-    if (nameCell) {
-      nameCell.textContent = user.name;
-    }
+  const entry = tableData.users.byKey.get(String(user.id));
+  if (!entry) return;
 
-    // Mettre à jour l'email
-    const emailCell = row.querySelector('.user-email');
-    if (emailCell) {
-      emailCell.textContent = user.email;
-    }
+  entry.name = user.name;
+  entry.email = user.email;
+  entry.is_admin = user.isAdmin ? 1 : 0;
 
-    // Mettre à jour le badge de rôle si nécessaire
-    const roleCell = row.querySelector('.user-role');
-    if (roleCell) {
-      const roleText = user.isAdmin ? 'ADMINISTRATEUR' : 'UTILISATEUR';
-      const badgeClass = user.isAdmin ? 'badge badge-admin' : 'badge badge-user';
-
-      roleCell.textContent = roleText;
-      roleCell.className = `${badgeClass} user-role`;
-    }
-  });
+  const row = document.querySelector(`tr[data-user-id="${user.id}"]`);
+  if (row) {
+    row.replaceWith(renderUserRow(entry));
+  }
+  scheduleRefresh('users');
 }
 
 /**
  * Met à jour l'horodatage de dernière connexion d'un utilisateur
- * Formate automatiquement la date au format local français
  * @param {string} userId - Identifiant unique de l'utilisateur
  * @param {Date} loginTime - Horodatage de la connexion
  * @returns {void}
  * @public
  */
 function updateUserLastLogin(userId, loginTime) {
-  // Chercher la ligne utilisateur par ID
-  const userRows = document.querySelectorAll(`tr[data-user-id="${userId}"]`);
-
-  userRows.forEach(row => {
-    // Mettre à jour la colonne "Dernière connexion" (5ème td = index 4)
-    const loginCell = row.children[4]; // 0: name, 1: email, 2: role, 3: modules, 4: last_login
-    if (loginCell) {
-      loginCell.textContent = loginTime.toLocaleString('fr-FR');
-    }
-  });
+  const entry = tableData.users.byKey.get(String(userId));
+  if (!entry) return;
+
+  entry.last_login = loginTime;
+
+  // Colonne "Dernière connexion" (index 4) : 0: name, 1: email, 2: role, 3: modules, 4: last_login
+  const loginCell = document.querySelector(`tr[data-user-id="${userId}"]`)?.children[4];
+  if (loginCell) {
+    loginCell.textContent = getCellText('users', entry, 'last_login');
+  }
+  scheduleRefresh('users');
 }
 
 /**
@@ -1031,16 +1082,17 @@ function setupModuleEvents() {
     updateModuleStatus(data.moduleId, true);
 
     // Mise à jour avec la VRAIE timestamp de télémétrie
-    const telemetryTimestamp = data.timestamp ? new Date(data.timestamp) : new Date();
-    updateModuleLastSeenInTable(data.moduleId, telemetryTimestamp);
-
-    // Forcer le tri pour repositionner par activité récente
-    applySorting('modules');
+    updateModuleLastSeen(data.moduleId, data.timestamp ? new Date(data.timestamp) : new Date());
   });
 
   // Réponses aux commandes
   window.socket.on('module_command_response', data => {
-    window.showToast?.(`✅ ${data.moduleId}: ${data.command} → ${data.status}`, 'success', 3000);
+    const ok = data.status === 'success';
+    window.showToast?.(
+      `${ok ? '✅' : '⚠️'} ${data.moduleId}: ${data.command} → ${data.status}`,
+      ok ? 'success' : 'warning',
+      3000
+    );
   });
 }
 
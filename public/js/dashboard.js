@@ -8,9 +8,14 @@
  * @description Interface de surveillance avec mises à jour temps réel et statistiques
  */
 
-const moduleStatus = new Map();
-let onlineModules = 0;
-let offlineModules = 0;
+/**
+ * Intervalle du rechargement de secours des statistiques (les variations sont poussées)
+ * @constant {number}
+ */
+const STATS_RESYNC_INTERVAL_MS = 5 * 60 * 1000;
+
+const dashboardStats = { totalModules: 0, onlineModules: 0, offlineModules: 0, moduleTypes: {} };
+let statsEtag = null;
 
 document.addEventListener('DOMContentLoaded', function () {
   initializeDashboard();
@@ -37,13 +42,21 @@ function addNewModule() {
  * @returns {void}
  */
 function initializeDashboard() {
+  const totalElement = document.querySelector('.dashboard-stat:not(.online):not(.offline)');
   const onlineElement = document.querySelector('.dashboard-stat.online');
   const offlineElement = document.querySelector('.dashboard-stat.offline');
 
-  if (onlineElement && offlineElement) {
-    onlineModules = parseInt(onlineElement.textContent || '0');
-    offlineModules = parseInt(offlineElement.textContent || '0');
+  // Statistiques initiales rendues par le serveur
+  if (totalElement && onlineElement && offlineElement) {
+    dashboardStats.totalModules = parseInt(totalElement.textContent || '0');
+    dashboardStats.onlineModules = parseInt(onlineElement.textContent || '0');
+    dashboardStats.offlineModules = parseInt(offlineElement.textContent || '0');
   }
+  document.querySelectorAll('.module-types .type-row').forEach(row => {
+    const name = row.querySelector('.type-name')?.textContent.trim();
+    const count = parseInt(row.querySelector('.type-count')?.textContent || '0');
+    if (name) dashboardStats.moduleTypes[name] = count;
+  });
 
   const cards = document.querySelectorAll('.dashboard-card');
   cards.forEach((card, index) => {
@@ -60,7 +73,8 @@ function initializeDashboard() {
 
 /**
  * Initialise la connexion WebSocket pour le dashboard
- * Configure les écouteurs d'événements temps réel avec fallback polling
+ * Les variations de statistiques sont poussées par le serveur ; un rechargement conditionnel
+ * n'a lieu qu'à la reconnexion, sur demande du serveur, ou à intervalle long en secours
  * @returns {void}
  */
 function initializeDashboardWebSocket() {
@@ -68,18 +82,24 @@ function initializeDashboardWebSocket() {
 
   /**
    * Configure les écouteurs d'événements WebSocket
-   * Établit la communication temps réel pour les mises à jour de statut
+   * Établit la communication temps réel pour les mises à jour de statistiques
    * @returns {boolean} True si WebSocket prêt, false sinon
    * @private
    */
   function setupWebSocketListeners() {
     if (typeof window.socket !== 'undefined' && window.socket && window.socket.connected) {
-      window.socket.on('user:module:online', function (data) {
-        updateModuleStatus(data.moduleId, true);
+      window.socket.on('user:stats:delta', function (delta) {
+        if (delta.resync) {
+          refreshStats();
+        } else {
+          applyStatsDelta(delta);
+        }
       });
 
-      window.socket.on('user:module:offline', function (data) {
-        updateModuleStatus(data.moduleId, false);
+      // Variations manquées pendant une coupure : rejouées par le serveur, rechargement
+      // seulement si l'écart dépasse son journal
+      window.socket.on('events:resume', function (resume) {
+        if (resume.mode === 'snapshot') refreshStats();
       });
 
       webSocketReady = true;
@@ -95,107 +115,113 @@ function initializeDashboardWebSocket() {
   });
 
   if (typeof window.socket !== 'undefined' && window.socket) {
-    if (setupWebSocketListeners()) {
-      return;
-    }
+    setupWebSocketListeners();
   }
 
-  setTimeout(() => {
-    if (!webSocketReady) {
-      startStatsPolling();
+  setInterval(refreshStats, STATS_RESYNC_INTERVAL_MS);
+}
+
+/**
+ * Recharge les statistiques depuis le serveur
+ * Requête conditionnelle : 304 sans corps tant que l'état des modules est inchangé
+ * @returns {Promise<void>}
+ */
+async function refreshStats() {
+  try {
+    const response = await fetch('/dashboard/stats', {
+      cache: 'no-store',
+      headers: statsEtag ? { 'If-None-Match': statsEtag } : {},
+    });
+    if (response.status === 304) return;
+    if (response.ok) {
+      statsEtag = response.headers.get('ETag');
+      const stats = await response.json();
+      updateCountersFromStats(stats);
+    }
+  } catch (error) {
+    if (window.MC?.isDevelopment) {
+      console.error('Error refreshing stats:', error);
     }
-  }, 2000);
+  }
 }
 
 /**
- * Démarre le sondage périodique des statistiques
- * Fallback pour mise à jour des compteurs en l'absence de WebSocket
+ * Applique une variation de statistiques poussée par le serveur
+ * @param {Object} delta - Variations {totalModules, onlineModules, offlineModules, moduleTypes}
  * @returns {void}
  */
-function startStatsPolling() {
-  setInterval(async () => {
-    try {
-      const response = await fetch('/dashboard/stats');
-      if (response.ok) {
-        const stats = await response.json();
-        updateCountersFromStats(stats);
-      }
-    } catch (error) {
-      if (window.MC?.isDevelopment) {
-        console.error('Error polling stats:', error);
-      }
-    }
-  }, 10000);
+function applyStatsDelta(delta) {
+  const moduleTypes = { ...dashboardStats.moduleTypes };
+  Object.entries(delta.moduleTypes || {}).forEach(([type, change]) => {
+    moduleTypes[type] = (moduleTypes[type] || 0) + change;
+    if (moduleTypes[type] <= 0) delete moduleTypes[type];
+  });
+
+  updateCountersFromStats({
+    totalModules: Math.max(0, dashboardStats.totalModules + (delta.totalModules || 0)),
+    onlineModules: Math.max(0, dashboardStats.onlineModules + (delta.onlineModules || 0)),
+    offlineModules: Math.max(0, dashboardStats.offlineModules + (delta.offlineModules || 0)),
+    moduleTypes,
+  });
+
+  // Le serveur a changé : le prochain rechargement ne peut plus être validé par l'ancien ETag
+  statsEtag = null;
 }
 
 /**
  * Met à jour les compteurs de statistiques depuis les données du serveur
  * Compare les valeurs actuelles avec les nouvelles et anime les changements
  * @param {Object} stats - Objet contenant les statistiques des modules
+ * @param {number} stats.totalModules - Nombre total de modules
  * @param {number} stats.onlineModules - Nombre de modules en ligne
  * @param {number} stats.offlineModules - Nombre de modules hors ligne
+ * @param {Object} stats.moduleTypes - Répartition par types de modules
  * @returns {void}
  */
 function updateCountersFromStats(stats) {
-  const onlineElement = document.querySelector('.dashboard-stat.online');
-  const offlineElement = document.querySelector('.dashboard-stat.offline');
-
-  if (onlineElement && offlineElement) {
-    const currentOnline = parseInt(onlineElement.textContent || '0');
-    const currentOffline = parseInt(offlineElement.textContent || '0');
-
-    if (currentOnline !== stats.onlineModules) {
-      animateCounterUpdate(onlineElement, stats.onlineModules);
-      onlineModules = stats.onlineModules;
+  const counters = {
+    totalModules: document.querySelector('.dashboard-stat:not(.online):not(.offline)'),
+    onlineModules: document.querySelector('.dashboard-stat.online'),
+    offlineModules: document.querySelector('.dashboard-stat.offline'),
+  };
+
+  Object.entries(counters).forEach(([key, element]) => {
+    if (element && dashboardStats[key] !== stats[key]) {
+      animateCounterUpdate(element, stats[key]);
     }
+    dashboardStats[key] = stats[key];
+  });
 
-    if (currentOffline !== stats.offlineModules) {
-      animateCounterUpdate(offlineElement, stats.offlineModules);
-      offlineModules = stats.offlineModules;
-    }
-  }
+  dashboardStats.moduleTypes = stats.moduleTypes || {};
+  renderModuleTypes(dashboardStats.moduleTypes);
 }
 
 /**
- * Met à jour le statut d'un module spécifique et ajuste les compteurs
- * Gère les transitions d'état en temps réel avec animation des compteurs
- * @param {string} moduleId - Identifiant unique du module
- * @param {boolean} isOnline - Nouveau statut du module (true=en ligne, false=hors ligne)
+ * Réaffiche la répartition des modules par type
+ * @param {Object} moduleTypes - Nombre de modules par type
  * @returns {void}
  */
-function updateModuleStatus(moduleId, isOnline) {
-  const onlineElement = document.querySelector('.dashboard-stat.online');
-  const offlineElement = document.querySelector('.dashboard-stat.offline');
+function renderModuleTypes(moduleTypes) {
+  const container = document.querySelector('.module-types');
+  if (!container) return;
 
-  if (!onlineElement || !offlineElement) {
-    console.warn('Dashboard counter elements not found');
-    return;
-  }
+  const rows = Object.entries(moduleTypes).map(([type, count]) => {
+    const row = document.createElement('div');
+    row.className = 'type-row';
 
-  const previousStatus = moduleStatus.get(moduleId);
+    const name = document.createElement('span');
+    name.className = 'type-name';
+    name.textContent = type;
 
-  if (previousStatus === isOnline) {
-    return;
-  }
+    const value = document.createElement('span');
+    value.className = 'type-count';
+    value.textContent = count;
 
-  moduleStatus.set(moduleId, isOnline);
-
-  // Seulement mettre à jour si c'est un changement de statut (pas une nouvelle détection)
-  // Si previousStatus === undefined, le module est déjà compté dans les stats initiales du DOM
-  if (previousStatus !== undefined) {
-    if (previousStatus === false && isOnline === true) {
-      // Module passe d'offline à online
-      onlineModules++;
-      if (offlineModules > 0) offlineModules--;
-    } else if (previousStatus === true && isOnline === false) {
-      // Module passe d'online à offline
-      if (onlineModules > 0) onlineModules--;
-      offlineModules++;
-    }
+    row.append(name, value);
+    return row;
+  });
 
-    animateCounterUpdate(onlineElement, onlineModules);
-    animateCounterUpdate(offlineElement, offlineModules);
-  }
+  container.replaceChildren(...rows);
 }
 
 /**
@@ -169,6 +169,13 @@ window.copyToClipboard = function (text, element = null) {
 let socket = null;
 let isInitializing = false;
 
+/**
+ * Position dans le flux d'événements séquencés de l'utilisateur
+ * Présentée à chaque reconnexion pour ne recevoir que les événements manqués
+ * @type {{epoch: string|null, seq: number}}
+ */
+const eventStream = { epoch: null, seq: 0 };
+
 /**
  * Initialise la connexion WebSocket avec authentification automatique
  * Configure Socket.IO avec polling, gestion des événements et authentification utilisateur
@@ -199,6 +206,27 @@ function initializeWebSocket() {
       forceNew: false, // Réutilise les connexions existantes
       transports: ['polling'], // Force polling pour éviter les conflits WebSocket
       upgrade: false, // Désactive l'upgrade automatique vers WebSocket
+      // Réévalué à chaque (re)connexion : reprise du flux là où il s'est arrêté
+      auth: callback => {
+        const { epoch, seq } = eventStream;
+        callback(epoch ? { eventResume: { epoch, seq } } : {});
+      },
+    });
+
+    // Séquence des événements reçus (les écouteurs "any" passent avant ceux des pages)
+    socket.onAny((event, data) => {
+      if (data && typeof data.eventSeq === 'number' && data.eventSeq > eventStream.seq) {
+        eventStream.seq = data.eventSeq;
+      }
+    });
+
+    // Résultat de la reprise : 'delta' (manqués rejoués) ou 'snapshot' (état à recharger)
+    socket.on('events:resume', function (resume) {
+      eventStream.epoch = resume.epoch;
+      eventStream.seq = resume.seq;
+      if (resume.mode === 'delta' && resume.replayed > 0) {
+        console.log(`🔁 ${resume.replayed} événement(s) rattrapé(s) après reconnexion`);
+      }
     });
 
     // Événement de connexion WebSocket avec authentification automatique
@@ -12,6 +12,52 @@ window.ws_sendCommand = window.ws_sendCommand || function () {};
 
 const controllersByMid = new Map();
 
+/**
+ * Demi-période de clignotement des lampes (ms)
+ * @constant {number}
+ */
+const BLINK_PERIOD_MS = 800;
+
+/**
+ * Horloge de clignotement partagée par toutes les cartes
+ * Une seule boucle requestAnimationFrame (arrêtée sans abonné) remplace un setInterval par
+ * lampe ; les lampes clignotent en phase et ne sont redessinées qu'au changement d'état
+ */
+const blinkClock = (() => {
+  const subscribers = new Set();
+  let frame = null;
+  let phase = false;
+
+  const isOn = (now = performance.now()) => Math.floor(now / BLINK_PERIOD_MS) % 2 === 1;
+
+  const tick = now => {
+    const on = isOn(now);
+    if (on !== phase) {
+      phase = on;
+      subscribers.forEach(callback => callback(on));
+    }
+    frame = subscribers.size > 0 ? requestAnimationFrame(tick) : null;
+  };
+
+  return {
+    isOn,
+
+    /**
+     * Abonne une lampe aux changements de phase
+     * @param {Function} callback - Appelée avec l'état allumé/éteint à chaque changement
+     * @returns {Function} Fonction de désabonnement
+     */
+    subscribe(callback) {
+      subscribers.add(callback);
+      if (!frame) {
+        phase = isOn();
+        frame = requestAnimationFrame(tick);
+      }
+      return () => subscribers.delete(callback);
+    },
+  };
+})();
+
 /**
  * Crée un contrôleur de station interactif
  * Génère l'interface de contrôle pour un module de type station avec boutons et indicateurs
@@ -42,7 +88,7 @@ function makeStationController(panel) {
     nextSectionFree = true;
   let inDispatch = false,
     dispatchTmr = null;
-  let blinkTmr = null,
+  let blinkSub = null,
     blinkOn = false;
   let gatesCooldown = false,
     harnessCooldown = false;
@@ -96,13 +142,13 @@ function makeStationController(panel) {
    * @private
    */
   function startBlink() {
-    if (blinkTmr || inDispatch || estop) return;
-    blinkOn = false;
+    if (blinkSub || inDispatch || estop) return;
+    blinkOn = blinkClock.isOn();
     applyDispatchLamp();
-    blinkTmr = setInterval(() => {
-      blinkOn = !blinkOn;
+    blinkSub = blinkClock.subscribe(on => {
+      blinkOn = on;
       applyDispatchLamp();
-    }, 800);
+    });
   }
   /**
    * Arrête le clignotement de la lampe de dispatch
@@ -111,9 +157,9 @@ function makeStationController(panel) {
    * @private
    */
   function stopBlink(forceOff = true) {
-    if (blinkTmr) {
-      clearInterval(blinkTmr);
-      blinkTmr = null;
+    if (blinkSub) {
+      blinkSub();
+      blinkSub = null;
     }
     blinkOn = !forceOff;
     applyDispatchLamp();
@@ -229,8 +275,8 @@ function makeStationController(panel) {
     onPresenceOffline,
     updateTelemetry,
     destroy() {
-      clearInterval(blinkTmr);
-      blinkTmr = null;
+      blinkSub?.();
+      blinkSub = null;
       clearTimeout(dispatchTmr);
     },
   };
@@ -318,7 +364,14 @@ function makeSwitchController(root) {
    */
   function updateTelemetry(payload) {
     if (payload.position) {
-      left = String(payload.position).toLowerCase() === 'left';
+      const position = String(payload.position).toLowerCase();
+      // Mouvement interrompu par un arrêt d'urgence : LEDs éteintes jusqu'à la bascule suivante
+      if (position === 'unknown') {
+        setLED(ledL, false);
+        setLED(ledR, false);
+        return;
+      }
+      left = position === 'left';
       update();
     }
   }
@@ -444,7 +497,7 @@ function makeLaunchController(panel) {
     speed = 60;
   let inLaunch = false,
     blinkOn = false,
-    blinkTmr = null,
+    blinkSub = null,
     dirCooldown = false;
 
   const MIN_LDUR = 2,
@@ -534,13 +587,13 @@ function makeLaunchController(panel) {
    * @private
    */
   function startBlink() {
-    if (blinkTmr || inLaunch) return;
-    blinkOn = false;
+    if (blinkSub || inLaunch) return;
+    blinkOn = blinkClock.isOn();
     applyLamp();
-    blinkTmr = setInterval(() => {
-      blinkOn = !blinkOn;
+    blinkSub = blinkClock.subscribe(on => {
+      blinkOn = on;
       applyLamp();
-    }, 800);
+    });
   }
 
   /**
@@ -550,9 +603,9 @@ function makeLaunchController(panel) {
    * @private
    */
   function stopBlink(forceOff = true) {
-    if (blinkTmr) {
-      clearInterval(blinkTmr);
-      blinkTmr = null;
+    if (blinkSub) {
+      blinkSub();
+      blinkSub = null;
     }
     blinkOn = !forceOff;
     applyLamp();
@@ -842,7 +895,7 @@ function makeLaunchController(panel) {
     onPresenceOffline,
     updateTelemetry,
     destroy() {
-      clearInterval(blinkTmr);
+      blinkSub?.();
     },
   };
 }
@@ -868,7 +921,7 @@ function makeSmokeController(panel) {
     inRun = false,
     ready = true,
     blinkOn = false,
-    blinkTmr = null;
+    blinkSub = null;
   let STEP = 36,
     BASE = 0;
 
@@ -920,13 +973,13 @@ function makeSmokeController(panel) {
    * @private
    */
   function startBlink() {
-    if (blinkTmr || inRun) return;
-    blinkOn = false;
+    if (blinkSub || inRun) return;
+    blinkOn = blinkClock.isOn();
     applyBtn();
-    blinkTmr = setInterval(() => {
-      blinkOn = !blinkOn;
+    blinkSub = blinkClock.subscribe(on => {
+      blinkOn = on;
       applyBtn();
-    }, 800);
+    });
   }
 
   /**
@@ -936,9 +989,9 @@ function makeSmokeController(panel) {
    * @private
    */
   function stopBlink(forceOff = true) {
-    if (blinkTmr) {
-      clearInterval(blinkTmr);
-      blinkTmr = null;
+    if (blinkSub) {
+      blinkSub();
+      blinkSub = null;
     }
     blinkOn = !forceOff;
     applyBtn();
@@ -1141,7 +1194,7 @@ function makeSmokeController(panel) {
     onPresenceOffline,
     updateTelemetry,
     destroy() {
-      clearInterval(blinkTmr);
+      blinkSub?.();
     },
   };
 }
@@ -1176,7 +1229,7 @@ function makeAudioController(panel) {
 
   let index = 0;
   let cooldown = false;
-  let blinkTimer = null,
+  let blinkSub = null,
     lampOn = false;
 
   /**
@@ -1195,13 +1248,13 @@ function makeAudioController(panel) {
    * @private
    */
   function startBlink() {
-    if (blinkTimer || cooldown) return;
-    lampOn = false;
-    setLamp(false);
-    blinkTimer = setInterval(() => {
-      lampOn = !lampOn;
-      setLamp(lampOn);
-    }, 800);
+    if (blinkSub || cooldown) return;
+    lampOn = blinkClock.isOn();
+    setLamp(lampOn);
+    blinkSub = blinkClock.subscribe(on => {
+      lampOn = on;
+      setLamp(on);
+    });
   }
 
   /**
@@ -1211,9 +1264,9 @@ function makeAudioController(panel) {
    * @private
    */
   function stopBlink(forceOff = true) {
-    if (blinkTimer) {
-      clearInterval(blinkTimer);
-      blinkTimer = null;
+    if (blinkSub) {
+      blinkSub();
+      blinkSub = null;
     }
     lampOn = !forceOff;
     setLamp(!forceOff);
@@ -1387,7 +1440,7 @@ function makeAudioController(panel) {
     onPresenceOffline,
     updateTelemetry,
     destroy() {
-      if (blinkTimer) clearInterval(blinkTimer);
+      blinkSub?.();
     },
   };
 }
@@ -1630,47 +1683,119 @@ document.getElementById('disableOnlineFilter')?.addEventListener('click', () =>
   }
 
   /**
-   * Marque tous les modules comme hors ligne
-   * Met à jour l'interface et notifie les contrôleurs
-   * @returns {void}
-   * @private
+   * Panneaux par identifiant de module, pour éviter une recherche DOM par événement
+   * @type {Map<string, HTMLElement[]>}
    */
-  function markAllOffline() {
-    document.querySelectorAll('.panel[data-mid]').forEach(p => {
-      p.classList.remove('online');
-      p.classList.add('offline', 'disabled');
-      const badge = p.querySelector('.state');
-      if (badge) {
-        badge.textContent = 'offline';
-        badge.classList.remove('online');
-        badge.classList.add('offline');
-      }
-      p.dispatchEvent(new CustomEvent('mc:offline'));
-      // notifie le controller
-      const mid = (p.dataset.mid || '').trim();
-      const ctl = controllersByMid.get(mid);
-      ctl?.onPresenceOffline?.();
-    });
-    window.applyOnlineFilter?.();
-  }
+  const panelsByMid = new Map();
+
+  /**
+   * Présence appliquée au DOM par module
+   * @type {Map<string, boolean>}
+   */
+  const presenceByMid = new Map();
+
+  /**
+   * Changements reçus depuis la dernière frame, par module : {online, telemetry}
+   * La télémétrie est fusionnée champ par champ (la dernière valeur l'emporte)
+   * @type {Map<string, Object>}
+   */
+  const pendingByMid = new Map();
+  let flushFrame = null;
 
   // Par défaut, offline
   document.querySelectorAll('.panel[data-mid]').forEach(p => {
     p.classList.add('offline', 'disabled');
+    const mid = (p.dataset.mid || '').trim();
+    if (!mid) return;
+    if (!panelsByMid.has(mid)) panelsByMid.set(mid, []);
+    panelsByMid.get(mid).push(p);
+    presenceByMid.set(mid, false);
   });
 
   /**
-   * Met à jour l'état de présence d'un module spécifique
-   * Gère l'affichage visuel et les événements de connexion/déconnexion
+   * Retourne l'entrée en attente d'un module, créée au besoin, et programme l'application
+   * @param {string} moduleId - Identifiant du module
+   * @returns {Object|null} Entrée en attente, null si le module n'est pas affiché
+   * @private
+   */
+  function pendingFor(moduleId) {
+    if (!panelsByMid.has(moduleId)) return null;
+
+    let entry = pendingByMid.get(moduleId);
+    if (!entry) {
+      entry = {};
+      pendingByMid.set(moduleId, entry);
+    }
+    if (flushFrame === null) {
+      flushFrame = requestAnimationFrame(flushPending);
+    }
+    return entry;
+  }
+
+  /**
+   * Enregistre un changement de présence, appliqué à la prochaine frame
    * @param {string} moduleId - Identifiant unique du module
    * @param {boolean} online - Statut de connexion (true=en ligne, false=hors ligne)
    * @returns {void}
    * @private
    */
   function setPresence(moduleId, online) {
-    const panels = document.querySelectorAll(`.panel[data-mid="${moduleId}"]`);
+    const entry = pendingFor(moduleId);
+    if (entry) entry.online = online;
+  }
+
+  /**
+   * Enregistre des données de télémétrie, appliquées à la prochaine frame
+   * @param {string} moduleId - Identifiant du module concerné
+   * @param {Object} payload - Données de télémétrie à appliquer
+   * @returns {void}
+   * @private
+   */
+  function updateTelemetry(moduleId, payload) {
+    const entry = pendingFor(moduleId);
+    if (entry && payload) entry.telemetry = Object.assign(entry.telemetry || {}, payload);
+  }
+
+  /**
+   * Applique en une passe les changements accumulés depuis la dernière frame
+   * Les présences inchangées ne touchent pas le DOM ; le filtre n'est réappliqué qu'une fois
+   * @returns {void}
+   * @private
+   */
+  function flushPending() {
+    flushFrame = null;
+    let presenceChanged = false;
+
+    pendingByMid.forEach((entry, moduleId) => {
+      const ctl = controllersByMid.get(moduleId);
+
+      if ('online' in entry && presenceByMid.get(moduleId) !== entry.online) {
+        applyPresence(moduleId, entry.online);
+        presenceChanged = true;
+      }
+      if (entry.telemetry) {
+        ctl?.updateTelemetry?.(entry.telemetry);
+      }
+    });
+    pendingByMid.clear();
+
+    if (presenceChanged) {
+      window.applyOnlineFilter?.();
+    }
+  }
 
-    panels.forEach(p => {
+  /**
+   * Applique l'état de présence d'un module au DOM et à son contrôleur
+   * @param {string} moduleId - Identifiant unique du module
+   * @param {boolean} online - Statut de connexion
+   * @returns {void}
+   * @private
+   */
+  function applyPresence(moduleId, online) {
+    presenceByMid.set(moduleId, online);
+    const ctl = controllersByMid.get(moduleId);
+
+    (panelsByMid.get(moduleId) || []).forEach(p => {
       p.classList.toggle('online', online);
       p.classList.toggle('offline', !online);
       p.classList.toggle('disabled', !online);
@@ -1685,30 +1810,22 @@ document.getElementById('disableOnlineFilter')?.addEventListener('click', () =>
       p.dispatchEvent(new CustomEvent(online ? 'mc:online' : 'mc:offline'));
 
       // Notifier le contrôleur
-      const ctl = controllersByMid.get(moduleId);
       if (online) {
         ctl?.onPresenceOnline?.();
       } else {
         ctl?.onPresenceOffline?.();
       }
     });
-    window.applyOnlineFilter?.();
   }
 
   /**
-   * Met à jour les données de télémétrie d'un module
-   * Transmet les données au contrôleur associé pour mise à jour de l'interface
-   * @param {string} moduleId - Identifiant du module concerné
-   * @param {Object} payload - Données de télémétrie à appliquer
+   * Marque tous les modules comme hors ligne
+   * Met à jour l'interface et notifie les contrôleurs
    * @returns {void}
    * @private
    */
-  function updateTelemetry(moduleId, payload) {
-    const panels = document.querySelectorAll(`.panel[data-mid="${moduleId}"]`);
-    panels.forEach(() => {
-      const ctl = controllersByMid.get(moduleId);
-      ctl?.updateTelemetry?.(payload);
-    });
+  function markAllOffline() {
+    panelsByMid.forEach((_, moduleId) => setPresence(moduleId, false));
   }
 
   // Plus besoin de reconnectionManager - global.js s'en charge
@@ -1733,19 +1850,20 @@ document.getElementById('disableOnlineFilter')?.addEventListener('click', () =>
     // Configurer les événements spécifiques aux modules
     setupSocketEvents(socket);
 
-    // Enregistrer cette page si la connexion est active
-    if (socket.connected) {
+    // Enregistrer cette page à chaque (re)connexion
+    socket.on('connect', () => {
       socket.emit('register_page', { page: 'modules' });
+    });
 
-      // Demander synchronisation initiale des statuts
-      requestInitialSync();
-    } else {
-      socket.on('connect', () => {
-        socket.emit('register_page', { page: 'modules' });
+    // Instantané complet uniquement si le serveur n'a pas pu rejouer les événements manqués
+    socket.on('events:resume', resume => {
+      if (resume.mode === 'snapshot') requestInitialSync();
+    });
 
-        // Demander synchronisation initiale après connexion
-        requestInitialSync();
-      });
+    // Connexion déjà établie : sa reprise est passée avant cette page
+    if (socket.connected) {
+      socket.emit('register_page', { page: 'modules' });
+      requestInitialSync();
     }
   }
 
@@ -1830,7 +1948,11 @@ document.getElementById('disableOnlineFilter')?.addEventListener('click', () =>
       const panel = document.querySelector(`.panel[data-mid="${data.moduleId}"]`);
       if (panel) {
         panel.remove();
+        controllersByMid.get(data.moduleId)?.destroy?.();
         controllersByMid.delete(data.moduleId);
+        panelsByMid.delete(data.moduleId);
+        presenceByMid.delete(data.moduleId);
+        pendingByMid.delete(data.moduleId);
       }
     });
 
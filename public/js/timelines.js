@@ -19,11 +19,7 @@ const MODULE_CONFIGS = {
         duration: { min: 0.1, max: 5, default: 1 },
         params: { force_stop: { type: 'boolean', default: true, label: 'Arrêt immédiat' } },
       },
-      deactivate: {
-        name: 'Désactiver E-Stop',
-        duration: { min: 0.1, max: 2, default: 0.5 },
-        params: {},
-      },
+      // Le réarmement reste un geste opérateur, jamais une action de timeline
     },
   },
   'switch-track': {
@@ -163,6 +159,7 @@ class TimelineSequencer {
     // Timeline state
     this.elements = [];
     this.isPlaying = false;
+    this.playingModules = []; // Modules exécutant la séquence en cours
     this.currentTime = 0;
     this.totalDuration = 60;
     this.selectedElement = null;
@@ -946,81 +943,87 @@ class TimelineSequencer {
     if (this.instructions) this.instructions.style.display = 'block';
   }
 
+  /**
+   * Bascule entre lecture et arrêt de la séquence
+   * @returns {void}
+   * @public
+   */
+  togglePlayback() {
+    if (this.isPlaying) {
+      this.stopSequence();
+    } else {
+      this.playSequence();
+    }
+  }
+
   /**
    * Lance la lecture de la séquence de timeline
-   * Exécute les actions des modules selon leur programmation temporelle
+   * La séquence est compilée côté serveur en programme binaire par module ;
+   * chaque module l'exécute lui-même à partir d'un départ commun.
    * @returns {void}
    * @public
    */
   playSequence() {
-    if (!this.websocketManager.isConnected) {
-      this.websocketManager.showAlert('danger', locales.errorNotConnected);
+    if (!window.socket?.connected) {
+      showToast(t('timelines.not_connected'), 'error');
       return;
     }
 
-    if (this.elements.length === 0) {
-      this.websocketManager.showAlert('warning', locales.timeline.noElements);
+    const sequence = this.generateSequence();
+    if (Object.keys(sequence.modules).length === 0) {
+      showToast(t('timelines.no_modules_alert'), 'warning');
       return;
     }
 
     this.isPlaying = true;
-    this.playButton.disabled = true;
-    this.stopButton.disabled = false;
-    this.playButton.textContent = locales.timeline.playing;
-
-    this.startTime = Date.now();
-    this.animationFrame = requestAnimationFrame(() => this.updatePlaybackPosition());
+    this.setPlayButtonState(true);
 
-    const sortedElements = this.elements
-      .filter(el => el.moduleId && el.action && el.startTime !== null)
-      .sort((a, b) => a.startTime + a.delay - (b.startTime + b.delay));
-
-    this.scheduleActions(sortedElements);
+    window.socket.once('timeline_play_result', result => this.handlePlayResult(result));
+    window.socket.emit('timeline_play', sequence);
   }
 
   /**
-   * Programme l'exécution des actions selon leur timing
-   * Crée les timeouts pour déclencher les actions aux bons moments
-   * @param {Array<Object>} elements - Liste des éléments à exécuter
+   * Traite la réponse du serveur au lancement de la séquence
+   * Démarre l'indicateur de lecture sur la durée du programme le plus long
+   * @param {Object} result - {started: [{moduleId, totalMs}], skipped: [{moduleId, error}]}
    * @returns {void}
    * @private
    */
-  scheduleActions(elements) {
-    this.timeouts = [];
-    elements.forEach(el => {
-      const delay = (el.startTime + el.delay) * 1000;
-      const timeout = setTimeout(() => {
-        this.executeAction(el);
-      }, delay);
-      this.timeouts.push(timeout);
+  handlePlayResult(result) {
+    if (!this.isPlaying) return;
+
+    result.skipped?.forEach(({ moduleId, error }) => {
+      showToast(`${moduleId}: ${error}`, 'warning');
     });
 
-    if (elements.length > 0) {
-      const totalDuration =
-        Math.max(...elements.map(e => e.startTime + e.delay + e.duration)) * 1000;
-      this.stopTimeout = setTimeout(() => {
-        this.stopSequence();
-      }, totalDuration);
+    if (!result.started?.length) {
+      if (result.error) showToast(result.error, 'error');
+      this.stopSequence();
+      return;
     }
+
+    this.playingModules = result.started.map(entry => entry.moduleId);
+    this.startTime = Date.now();
+    this.animationFrame = requestAnimationFrame(() => this.updatePlaybackPosition());
+
+    const totalMs = Math.max(...result.started.map(entry => entry.totalMs));
+    this.stopTimeout = setTimeout(() => this.stopSequence(false), totalMs);
   }
 
   /**
-   * Exécute une action de module via WebSocket
-   * Envoie la commande au serveur pour contrôler le module physique
-   * @param {Object} element - Élément contenant les données d'action
+   * Met à jour le bouton de lecture
+   * @param {boolean} playing - Lecture en cours
    * @returns {void}
    * @private
    */
-  executeAction(element) {
-    const message = {
-      type: 'moduleAction',
-      moduleId: element.moduleId,
-      action: element.action,
-      parameters: element.parameters || {},
-      duration: element.duration,
-    };
+  setPlayButtonState(playing) {
+    const playIcon = document.getElementById('playIcon');
+    const playText = document.getElementById('playText');
 
-    this.websocketManager.send(message);
+    if (playIcon) playIcon.className = playing ? 'bi bi-stop-fill' : 'bi bi-play-fill';
+    if (playText) {
+      playText.textContent = t(playing ? 'timelines.stop_timeline' : 'timelines.play_timeline');
+    }
   }
 
   /**
@@ -1058,23 +1061,24 @@ class TimelineSequencer {
 
   /**
    * Arrête complètement la lecture de la séquence
-   * Annule tous les timeouts et remet l'interface à l'état initial
+   * Demande l'arrêt aux modules si la lecture est interrompue avant sa fin
+   * @param {boolean} [notifyModules=true] - Envoyer timeline_stop aux modules
    * @returns {void}
    * @public
    */
-  stopSequence() {
+  stopSequence(notifyModules = true) {
+    if (notifyModules && this.playingModules?.length && window.socket?.connected) {
+      window.socket.emit('timeline_stop', { moduleIds: this.playingModules });
+    }
+
     this.isPlaying = false;
-    this.playButton.disabled = false;
-    this.stopButton.disabled = true;
-    this.playButton.textContent = locales.timeline.play;
+    this.playingModules = [];
+    this.setPlayButtonState(false);
 
     if (this.animationFrame) {
       cancelAnimationFrame(this.animationFrame);
     }
 
-    this.timeouts.forEach(timeout => clearTimeout(timeout));
-    this.timeouts = [];
-
     if (this.stopTimeout) {
       clearTimeout(this.stopTimeout);
     }
@@ -1098,7 +1102,7 @@ class TimelineSequencer {
     };
 
     this.elements.forEach(element => {
-      const moduleId = element.moduleId;
+      const moduleId = element.moduleData?.id;
       if (!moduleId) return;
 
       if (!sequence.modules[moduleId]) {
@@ -1106,17 +1110,14 @@ class TimelineSequencer {
       }
 
       sequence.modules[moduleId].push({
-        startTime: element.startTime + element.delay,
-        action: element.action,
-        parameters: element.parameters || {},
+        startTime: element.startTime,
+        action: element.actionType,
+        parameters: element.actionParams || {},
         duration: element.duration,
       });
     });
 
-    sequence.totalDuration = Math.max(
-      ...this.elements.map(e => e.startTime + e.delay + e.duration),
-      0
-    );
+    sequence.totalDuration = Math.max(...this.elements.map(e => e.startTime + e.duration), 0);
 
     return sequence;
   }
@@ -1153,7 +1154,7 @@ class TimelineSequencer {
         this.loadSequence(sequence);
       } catch (error) {
         console.error("Erreur lors de l'import:", error);
-        this.websocketManager.showAlert('danger', "Erreur lors de l'import du fichier");
+        showToast("Erreur lors de l'import du fichier", 'error');
       }
     };
     reader.readAsText(file);
@@ -368,7 +368,7 @@
       if (getCurrentPageName() === 'admin' && window.updateModuleStatus) {
         window.updateModuleStatus(data.moduleId, true);
         if (data.lastSeen && window.updateModuleLastSeen) {
-          window.updateModuleLastSeen(data.moduleId, data.lastSeen, data.lastSeenFormatted);
+          window.updateModuleLastSeen(data.moduleId, data.lastSeen);
         }
       }
     });
@@ -380,7 +380,7 @@
       if (getCurrentPageName() === 'admin' && window.updateModuleStatus) {
         window.updateModuleStatus(data.moduleId, false);
         if (data.lastSeen && window.updateModuleLastSeen) {
-          window.updateModuleLastSeen(data.moduleId, data.lastSeen, data.lastSeenFormatted);
+          window.updateModuleLastSeen(data.moduleId, data.lastSeen);
         }
       }
     });
@@ -416,13 +416,15 @@
 
     socket.on('rt_telemetry_updated', function (data) {
       if (getCurrentPageName() === 'admin' && data.lastSeen && window.updateModuleLastSeen) {
-        window.updateModuleLastSeen(data.moduleId, data.lastSeen, data.lastSeenFormatted);
+        window.updateModuleLastSeen(data.moduleId, data.lastSeen);
       }
     });
 
-    socket.on('rt_module_last_seen_updated', function (data) {
+    socket.on('rt_modules_last_seen_digest', function (data) {
       if (getCurrentPageName() === 'admin' && window.updateModuleLastSeen) {
-        window.updateModuleLastSeen(data.moduleId, data.lastSeen, data.lastSeenFormatted);
+        (data.modules || []).forEach(entry => {
+          window.updateModuleLastSeen(entry.moduleId, entry.lastSeen);
+        });
       }
     });
 
@@ -16,43 +16,110 @@ const router = express.Router();
 
 router.use(requireAdmin);
 
+/**
+ * Taille des pages lues en base pour alimenter les flux NDJSON
+ * @constant {number}
+ */
+const STREAM_PAGE_SIZE = 500;
+
+/**
+ * Attend que le tampon d'écriture de la réponse se vide (ou que le client se déconnecte)
+ * @param {Response} res - Réponse Express en cours d'écriture
+ * @returns {Promise<void>}
+ * @private
+ */
+function waitForDrain(res) {
+  return new Promise(resolve => {
+    const done = () => {
+      res.off('drain', done);
+      res.off('close', done);
+      resolve();
+    };
+    res.on('drain', done);
+    res.on('close', done);
+  });
+}
+
+/**
+ * Diffuse une liste paginée par curseur en NDJSON (un objet JSON par ligne)
+ * Les pages sont lues une à une au rythme du client ; la dernière ligne {done, count}
+ * signale la fin, une ligne {error} une interruption après l'envoi des en-têtes
+ * @param {Response} res - Réponse Express
+ * @param {Function} readPage - (cursor) => Promise<{items, nextCursor}>
+ * @returns {Promise<void>}
+ * @private
+ */
+async function streamPages(res, readPage) {
+  let closed = false;
+  res.on('close', () => {
+    closed = true;
+  });
+
+  res.set({
+    'Content-Type': 'application/x-ndjson; charset=utf-8',
+    'Cache-Control': 'no-store',
+  });
+
+  let cursor = null;
+  let count = 0;
+
+  do {
+    const { items, nextCursor } = await readPage(cursor);
+    if (closed) return;
+
+    const chunk = items.map(item => `${JSON.stringify(item)}\n`).join('');
+    count += items.length;
+    if (chunk && !res.write(chunk)) {
+      await waitForDrain(res);
+    }
+    cursor = nextCursor;
+  } while (cursor !== null && !closed);
+
+  if (!closed) {
+    res.end(`${JSON.stringify({ done: true, count })}\n`);
+  }
+}
+
+/**
+ * Termine une réponse de flux en erreur (JSON classique si rien n'a encore été envoyé)
+ * @param {Response} res - Réponse Express
+ * @param {string} message - Message d'erreur
+ * @returns {void}
+ * @private
+ */
+function failStream(res, message) {
+  if (res.headersSent) {
+    res.end(`${JSON.stringify({ error: message })}\n`);
+  } else {
+    res.status(500).json({ error: message });
+  }
+}
+
 /**
  * Route de la page principale d'administration
- * Récupère tous les utilisateurs et modules pour affichage avec pagination côté client
+ * Rend uniquement les compteurs ; les listes sont chargées en flux par /api/users et
+ * /api/modules puis affichées page par page côté client
  * @param {Request} req - Requête Express avec session admin
  * @param {Response} res - Réponse Express pour rendu de vue
  * @returns {Promise<void>}
  */
 router.get('/', async (req, res) => {
   try {
-    const [allUsersResult, allModulesResult] = await Promise.all([
-      databaseManager.users.findAll({
-        limit: 999999,
-        offset: 0,
-        sortBy: 'created_at',
-        sortOrder: 'DESC',
-      }),
-      databaseManager.modules.findAll({
-        limit: 999999,
-        offset: 0,
-        sortBy: 'created_at',
-        sortOrder: 'DESC',
-      }),
+    const [totalUsers, moduleStats, user] = await Promise.all([
+      databaseManager.users.count(),
+      databaseManager.modules.getStats(),
+      databaseManager.users.findById(req.session.user_id),
     ]);
 
-    const user = await databaseManager.users.findById(req.session.user_id);
-
     const stats = {
-      totalUsers: allUsersResult.users.length,
+      totalUsers,
       onlineUsers: 0,
-      totalModules: allModulesResult.modules.length,
-      onlineModules: allModulesResult.modules.filter(m => m.status === 'online').length,
+      totalModules: moduleStats.total,
+      onlineModules: moduleStats.online,
     };
 
     res.render('admin', {
       currentPage: 'admin',
-      users: allUsersResult.users,
-      modules: allModulesResult.modules,
       stats,
       error: null,
       success: null,
@@ -74,19 +141,21 @@ router.get('/', async (req, res) => {
  */
 router.get('/api/stats', async (req, res) => {
   try {
-    const [usersResult, modulesResult] = await Promise.all([
-      databaseManager.users.findAll({ limit: 10000, offset: 0 }),
-      databaseManager.modules.findAll({ limit: 10000, offset: 0 }),
+    // Compteurs SQL et cache de statuts : aucune liste chargée
+    const [userStats, moduleStats] = await Promise.all([
+      databaseManager.users.getStats(),
+      databaseManager.modules.getStats(),
     ]);
 
     const stats = {
-      totalUsers: usersResult.total,
+      totalUsers: userStats.total,
       onlineUsers: 0, // Sera fourni par WebSocket en temps réel
-      totalModules: modulesResult.total,
-      onlineModules: modulesResult.modules.filter(m => m.status === 'online').length,
-      offlineModules: modulesResult.modules.filter(m => m.status === 'offline').length,
-      adminUsers: usersResult.users.filter(u => u.is_admin).length,
-      regularUsers: usersResult.users.filter(u => !u.is_admin).length,
+      totalModules: moduleStats.total,
+      onlineModules: moduleStats.online,
+      offlineModules: moduleStats.offline,
+      adminUsers: userStats.admins,
+      regularUsers: userStats.regular,
+      telemetry: req.app.locals.realTimeAPI?.modules.getFleetTelemetry() || null,
     };
 
     res.json(stats);
@@ -97,36 +166,54 @@ router.get('/api/stats', async (req, res) => {
 });
 
 /**
- * API de récupération de la liste des utilisateurs
- * Fournit la liste complète des utilisateurs pour l'interface d'administration
+ * API de récupération de la liste des utilisateurs (flux NDJSON)
+ * Filtres serveur en paramètres de requête : name, email, role (admin/user), module_count
  * @param {Request} req - Requête Express avec session admin
- * @param {Response} res - Réponse JSON avec liste utilisateurs
+ * @param {Response} res - Réponse NDJSON, un utilisateur par ligne puis {done, count}
  * @returns {Promise<void>}
  */
 router.get('/api/users', async (req, res) => {
+  const { name, email, role, module_count } = req.query;
+  const filters = { name, email, role, module_count };
+
   try {
-    const usersResult = await databaseManager.users.findAll({ limit: 1000, offset: 0 });
-    res.json(usersResult);
+    await streamPages(res, async cursor => {
+      const { users, nextCursor } = await databaseManager.users.findPage({
+        cursor,
+        limit: STREAM_PAGE_SIZE,
+        filters,
+      });
+      return { items: users, nextCursor };
+    });
   } catch (error) {
     Logger.app.error('Admin users API error:', error);
-    res.status(500).json({ error: 'Erreur interne du serveur' });
+    failStream(res, 'Erreur interne du serveur');
   }
 });
 
 /**
- * API de récupération de la liste des modules
- * Fournit la liste complète des modules pour l'interface d'administration
+ * API de récupération de la liste des modules (flux NDJSON)
+ * Filtres serveur en paramètres de requête : module_id, name, type, user_name, status
  * @param {Request} req - Requête Express avec session admin
- * @param {Response} res - Réponse JSON avec liste modules
+ * @param {Response} res - Réponse NDJSON, un module par ligne puis {done, count}
  * @returns {Promise<void>}
  */
 router.get('/api/modules', async (req, res) => {
+  const { module_id, name, type, user_name, status } = req.query;
+  const filters = { module_id, name, type, user_name, status };
+
   try {
-    const modulesResult = await databaseManager.modules.findAll({ limit: 1000, offset: 0 });
-    res.json(modulesResult);
+    await streamPages(res, async cursor => {
+      const { modules, nextCursor } = await databaseManager.modules.findPage({
+        cursor,
+        limit: STREAM_PAGE_SIZE,
+        filters,
+      });
+      return { items: modules, nextCursor };
+    });
   } catch (error) {
     Logger.app.error('Admin modules API error:', error);
-    res.status(500).json({ error: 'Erreur lors de la récupération des modules' });
+    failStream(res, 'Erreur lors de la récupération des modules');
   }
 });
 
@@ -15,19 +15,21 @@ const Logger = require('../utils/logger');
 
 /**
  * Calcule les statistiques personnalisées pour un utilisateur
- * Génère les métriques de modules et types pour le dashboard
+ * Génère les métriques de modules et types pour le dashboard à partir de l'instantané
+ * mémoire des modules (aucune requête en base une fois l'instantané chargé)
  * @param {number} userId - ID de l'utilisateur
- * @returns {Promise<Object>} Statistiques calculées
- * @returns {number} returns.totalModules - Nombre total de modules
- * @returns {number} returns.onlineModules - Nombre de modules en ligne
- * @returns {number} returns.offlineModules - Nombre de modules hors ligne
- * @returns {Object} returns.moduleTypes - Répartition par types de modules
+ * @returns {Promise<Object>} {stats, etag}
+ * @returns {number} returns.stats.totalModules - Nombre total de modules
+ * @returns {number} returns.stats.onlineModules - Nombre de modules en ligne
+ * @returns {number} returns.stats.offlineModules - Nombre de modules hors ligne
+ * @returns {Object} returns.stats.moduleTypes - Répartition par types de modules
+ * @returns {string} returns.etag - ETag de l'état des modules
  * @private
  */
 async function calculateStats(userId) {
-  const userModules = await databaseManager.modules.findByUserId(userId);
+  const { modules: userModules, etag } = await databaseManager.modules.getUserModulesView(userId);
 
-  // Récupérer les statuts en ligne depuis la base de données
+  // Statuts en ligne issus du cache alimenté par le serveur ESP32
   const onlineModules = userModules.filter(m => m.status === 'online').length;
 
   const stats = {
@@ -43,7 +45,7 @@ async function calculateStats(userId) {
     stats.moduleTypes[type] = (stats.moduleTypes[type] || 0) + 1;
   });
 
-  return stats;
+  return { stats, etag };
 }
 
 /**
@@ -60,7 +62,7 @@ router.get('/', async (req, res) => {
     }
 
     // Calculer les statistiques
-    const stats = await calculateStats(req.session.user_id);
+    const { stats } = await calculateStats(req.session.user_id);
 
     // Récupérer les informations utilisateur
     const user = await databaseManager.users.findById(req.session.user_id);
@@ -83,7 +85,8 @@ router.get('/', async (req, res) => {
 
 /**
  * API de récupération des statistiques temps réel
- * Fournit les métriques actualisées pour le dashboard utilisateur
+ * Fournit les métriques actualisées pour le dashboard utilisateur, avec ETag :
+ * un sondage sur un état inchangé reçoit un 304 sans corps
  * @param {Request} req - Requête Express avec session utilisateur
  * @param {Response} res - Réponse JSON avec statistiques
  * @returns {Promise<void>}
@@ -94,7 +97,13 @@ router.get('/stats', async (req, res) => {
       return res.status(401).json({ error: 'Not authenticated' });
     }
 
-    const stats = await calculateStats(req.session.user_id);
+    const { stats, etag } = await calculateStats(req.session.user_id);
+
+    res.set({ ETag: etag, 'Cache-Control': 'private, no-cache' });
+    if (req.fresh) {
+      return res.status(304).end();
+    }
+
     res.json(stats);
   } catch (error) {
     Logger.system.error('Erreur lors de la récupération des statistiques:', error);
@@ -54,6 +54,21 @@ function mcInferType(moduleId, name = '') {
   return 'Unknown';
 }
 
+/**
+ * Infère les types manquants sur une liste de modules
+ * @param {Array<Object>} modules - Modules issus de l'instantané (objets propres à la requête)
+ * @returns {Array<Object>} La même liste, types complétés
+ * @private
+ */
+function withInferredTypes(modules) {
+  modules.forEach(module => {
+    if (!module.type) {
+      module.type = mcInferType(module.module_id, module.name);
+    }
+  });
+  return modules;
+}
+
 /**
  * Route principale de la page de gestion des modules
  * Affiche la liste des modules de l'utilisateur avec inférence automatique des types
@@ -70,15 +85,8 @@ router.get('/', requireAuth, async (req, res) => {
       return res.redirect('/logout');
     }
 
-    // Récupérer tous les modules de l'utilisateur
-    const modules = await databaseManager.modules.findByUserId(userId);
-
-    // Inférer les types manquants
-    modules.forEach(module => {
-      if (!module.type) {
-        module.type = mcInferType(module.module_id, module.name);
-      }
-    });
+    // Modules de l'utilisateur depuis l'instantané mémoire, types manquants inférés
+    const modules = withInferredTypes(await databaseManager.modules.findByUserId(userId));
 
     // Rendu de la page
     res.render('modules', {
@@ -104,7 +112,8 @@ router.get('/', requireAuth, async (req, res) => {
 
 /**
  * API de récupération des modules en format JSON
- * Fournit la liste des modules de l'utilisateur pour les requêtes AJAX
+ * Fournit la liste des modules de l'utilisateur pour les requêtes AJAX, avec ETag :
+ * une requête If-None-Match sur un état inchangé reçoit un 304 sans corps
  * @param {Request} req - Requête Express avec session utilisateur authentifiée
  * @param {Response} res - Réponse JSON avec liste des modules
  * @returns {Promise<void>}
@@ -112,16 +121,14 @@ router.get('/', requireAuth, async (req, res) => {
 router.get('/api', requireAuth, async (req, res) => {
   try {
     const userId = req.session.user_id;
-    const modules = await databaseManager.modules.findByUserId(userId);
+    const { modules, etag } = await databaseManager.modules.getUserModulesView(userId);
 
-    // Inférer les types manquants
-    modules.forEach(module => {
-      if (!module.type) {
-        module.type = mcInferType(module.module_id, module.name);
-      }
-    });
+    res.set({ ETag: etag, 'Cache-Control': 'private, no-cache' });
+    if (req.fresh) {
+      return res.status(304).end();
+    }
 
-    res.json({ success: true, modules });
+    res.json({ success: true, modules: withInferredTypes(modules) });
   } catch (error) {
     Logger.modules.error('Error fetching modules:', error);
     res.status(500).json({ success: false, error: 'Database error' });
@@ -206,6 +213,7 @@ router.post('/claim', requireAuth, async (req, res) => {
     `,
       [userId, nameTrim, type, existingModule.id]
     );
+    databaseManager.modules.invalidateUserSnapshot(userId);
 
     // Émettre événement temps réel : module ajouté
     if (req.app.locals.realTimeAPI) {
@@ -256,6 +264,7 @@ router.post('/add', requireAuth, async (req, res) => {
     `,
       [userId, module_id.trim(), name?.trim() || null, type]
     );
+    databaseManager.modules.invalidateUserSnapshot(userId);
 
     // Émettre événement temps réel : module ajouté
     if (req.app.locals.realTimeAPI) {
@@ -313,6 +322,7 @@ router.post('/delete/:moduleId', requireAuth, async (req, res) => {
     `,
       [moduleId, userId]
     );
+    databaseManager.modules.invalidateUserSnapshot(userId);
 
     // Émettre événement temps réel : module supprimé
     if (req.app.locals.realTimeAPI) {
@@ -365,6 +375,7 @@ router.post('/update/:moduleId', requireAuth, async (req, res) => {
     `,
       [name?.trim() || null, finalType, moduleId, userId]
     );
+    databaseManager.modules.invalidateUserSnapshot(userId);
 
     // Émettre événement temps réel : module mis à jour
     if (req.app.locals.realTimeAPI) {
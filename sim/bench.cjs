@@ -0,0 +1,117 @@
+/**
+ * Banc firmware natif - lance le vrai firmware compilé pour l'hôte (sim/native)
+ * Un processus par module simulé, connecté au serveur réel via SERVER_URL
+ *
+ * Modules : MODULE_ID / MODULE_PASSWORD (un seul module) ou SIM_MODULES_FILE,
+ * fichier JSON de la forme [{ "moduleId": "...", "password": "..." }, ...]
+ * Firmware : BENCH_BIN (aiguillage par défaut ; speed-control-bench, led-control-bench,
+ * estop-button-bench dans sim/native/build). Le bouton d'arrêt se réarme avec son contact
+ * fermé : BENCH_PINS_LOW=33
+ */
+
+const { spawn } = require('child_process');
+const fs = require('fs');
+const path = require('path');
+
+const config = {
+  serverUrl: process.env.SERVER_URL || 'ws://127.0.0.1:3000/esp32',
+  binary: process.env.BENCH_BIN || path.join(__dirname, 'native', 'build', 'switch-track-bench'),
+  modulesFile: process.env.SIM_MODULES_FILE || null,
+  log: process.env.SIM_LOG !== '0',
+  spawnStaggerMs: 50, // Évite que tous les modules s'authentifient dans la même milliseconde
+  restartDelayMs: 2000,
+};
+
+const children = new Map();
+let stopping = false;
+
+function loadModules() {
+  if (!config.modulesFile) {
+    return [
+      {
+        moduleId: process.env.MODULE_ID || 'MC-0001-ST',
+        password: process.env.MODULE_PASSWORD || 'F674iaRftVsHGKOA8hq3TI93HQHUaYqZ',
+      },
+    ];
+  }
+
+  const modules = JSON.parse(fs.readFileSync(config.modulesFile, 'utf8'));
+  if (!Array.isArray(modules) || modules.some(m => !m.moduleId || !m.password)) {
+    throw new Error(`${config.modulesFile}: liste de { moduleId, password } attendue`);
+  }
+  return modules;
+}
+
+// Préfixe chaque ligne de la console série par l'identifiant du module
+function pipeLines(stream, moduleId, target) {
+  let pending = '';
+  stream.setEncoding('utf8');
+  stream.on('data', chunk => {
+    pending += chunk;
+    const lines = pending.split('\n');
+    pending = lines.pop();
+    if (config.log) {
+      for (const line of lines) target.write(`[${moduleId}] ${line}\n`);
+    }
+  });
+}
+
+function startModule(module) {
+  const child = spawn(config.binary, [], {
+    env: {
+      ...process.env,
+      SERVER_URL: config.serverUrl,
+      MODULE_ID: module.moduleId,
+      MODULE_PASSWORD: module.password,
+    },
+    stdio: ['ignore', 'pipe', 'pipe'],
+  });
+
+  children.set(module.moduleId, child);
+  pipeLines(child.stdout, module.moduleId, process.stdout);
+  pipeLines(child.stderr, module.moduleId, process.stderr);
+
+  child.on('error', error => {
+    console.error(`[${module.moduleId}] ❌ Lancement impossible: ${error.message}`);
+    if (error.code === 'ENOENT') {
+      console.error('💡 Compiler le banc avec: npm run sim-esp:build');
+      shutdown(1);
+    }
+  });
+
+  // Un firmware qui s'arrête est un crash : relancé comme un ESP32 après reset
+  child.on('exit', (code, signal) => {
+    children.delete(module.moduleId);
+    if (stopping) return;
+    console.error(`[${module.moduleId}] 💥 Firmware arrêté (code ${code}, signal ${signal})`);
+    if (code === 2) return; // Configuration refusée par le banc : inutile de relancer
+    setTimeout(() => !stopping && startModule(module), config.restartDelayMs);
+  });
+}
+
+function shutdown(exitCode = 0) {
+  if (stopping) return;
+  stopping = true;
+  for (const child of children.values()) child.kill('SIGTERM');
+  setTimeout(() => process.exit(exitCode), 200);
+}
+
+function main() {
+  let modules;
+  try {
+    modules = loadModules();
+  } catch (error) {
+    console.error(`❌ ${error.message}`);
+    process.exit(1);
+  }
+
+  console.log(`🧪 Banc firmware: ${modules.length} module(s) → ${config.serverUrl}`);
+  modules.forEach((module, index) => {
+    setTimeout(() => !stopping && startModule(module), index * config.spawnStaggerMs);
+  });
+
+  process.on('SIGINT', () => shutdown(0));
+  process.on('SIGTERM', () => shutdown(0));
+}
+
+main();
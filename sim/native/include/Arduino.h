@@ -0,0 +1,121 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Sous-ensemble de l'API Arduino-ESP32 utilisé par les firmwares de esp/, implémenté sur POSIX
+ * (temps monotone, sorties sur stdout, broches sans effet matériel)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp32-hal-rmt.h"
+
+// Cœur Arduino-ESP32 3.x (ledcAttach, esp_now_recv_info_t)
+#define ESP_ARDUINO_VERSION_MAJOR 3
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define digitalPinToInterrupt(pin) (pin)
+
+#define IRAM_ATTR
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+using std::max;
+using std::min;
+
+// Sections critiques FreeRTOS : verrou tournant entre loop() et les threads de callbacks
+struct portMUX_TYPE {
+  std::atomic_flag locked;
+};
+#define portMUX_INITIALIZER_UNLOCKED { ATOMIC_FLAG_INIT }
+
+inline void portENTER_CRITICAL(portMUX_TYPE* mux) {
+  while (mux->locked.test_and_set(std::memory_order_acquire)) {
+  }
+}
+
+inline void portEXIT_CRITICAL(portMUX_TYPE* mux) {
+  mux->locked.clear(std::memory_order_release);
+}
+
+#define portENTER_CRITICAL_ISR(mux) portENTER_CRITICAL(mux)
+#define portEXIT_CRITICAL_ISR(mux) portEXIT_CRITICAL(mux)
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode);
+
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution);
+bool ledcWrite(uint8_t pin, uint32_t duty);
+
+uint32_t esp_random();
+
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size);
+#endif
+
+class IPAddress {
+ public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : bytes_{ a, b, c, d } {}
+  uint8_t operator[](int index) const { return bytes_[index]; }
+
+ private:
+  uint8_t bytes_[4];
+};
+
+// Console série : une ligne par appel println, écrite sur stdout sans tampon intermédiaire
+class HardwareSerial {
+ public:
+  void begin(unsigned long baud) { (void)baud; }
+  int printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+  void print(const char* value);
+  void print(char value);
+  void print(int value) { print(static_cast<long>(value)); }
+  void print(unsigned int value) { print(static_cast<unsigned long>(value)); }
+  void print(long value);
+  void print(unsigned long value);
+  void print(double value);
+  void print(const IPAddress& value);
+
+  template <class T>
+  void println(const T& value) {
+    print(value);
+    println();
+  }
+  void println();
+};
+
+class EspClass {
+ public:
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+};
+
+extern HardwareSerial Serial;
+extern EspClass ESP;
+
+void setup();
+void loop();
@@ -0,0 +1,34 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Preferences (NVS) sur fichier : un fichier par module et par espace de noms, dans
+ * BENCH_NVS_DIR (par défaut le répertoire temporaire), pour que l'époque d'état survive
+ * aux redémarrages du processus comme à ceux de l'ESP32
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences {
+ public:
+  bool begin(const char* name, bool readOnly = false);
+  void end();
+
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+  size_t putUInt(const char* key, uint32_t value);
+  size_t getBytes(const char* key, void* buffer, size_t maxLength);
+  size_t putBytes(const char* key, const void* value, size_t length);
+
+ private:
+  bool save();
+
+  std::string path_;
+  bool open_ = false;
+  bool readOnly_ = false;
+  std::map<std::string, uint32_t> values_;
+  std::map<std::string, std::vector<uint8_t>> blobs_;
+};
@@ -0,0 +1,81 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Client WebSocket (RFC 6455) sur socket TCP POSIX, même interface et même cycle de vie
+ * que la bibliothèque arduinoWebSockets : tout se passe dans loop(), reconnexion comprise
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+#include <string>
+#include <vector>
+
+// Espace réservé devant la charge utile pour l'en-tête (sendTXT/sendBIN headerToPayload)
+#define WEBSOCKETS_MAX_HEADER_SIZE 14
+
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+  WStype_PING,
+  WStype_PONG,
+} WStype_t;
+
+typedef void (*WebSocketClientEvent)(WStype_t type, uint8_t* payload, size_t length);
+
+class WebSocketsClient {
+ public:
+  ~WebSocketsClient();
+
+  void begin(const char* host, uint16_t port, const char* url = "/");
+  void onEvent(WebSocketClientEvent callback) { callback_ = callback; }
+  void setReconnectInterval(unsigned long ms) { reconnectIntervalMs_ = ms; }
+  void enableHeartbeat(uint32_t pingIntervalMs, uint32_t pongTimeoutMs, uint8_t disconnectTimeoutCount);
+  void loop();
+  void disconnect();
+  bool isConnected() const { return connected_; }
+
+  bool sendTXT(uint8_t* payload, size_t length = 0, bool headerToPayload = false);
+  bool sendTXT(const char* payload) { return sendFrame(0x1, reinterpret_cast<const uint8_t*>(payload), strlen(payload)); }
+  bool sendBIN(uint8_t* payload, size_t length, bool headerToPayload = false);
+
+ private:
+  bool connectSocket();
+  bool handshake();
+  bool sendFrame(uint8_t opcode, const uint8_t* data, size_t length);
+  bool sendAll(const uint8_t* data, size_t length);
+  void readFrames();
+  bool parseFrame();
+  void closeSocket(bool notify);
+  void emit(WStype_t type, uint8_t* payload, size_t length);
+
+  std::string host_;
+  uint16_t port_ = 0;
+  std::string url_;
+  WebSocketClientEvent callback_ = nullptr;
+  int fd_ = -1;
+  bool started_ = false;
+  bool connected_ = false;
+  unsigned long reconnectIntervalMs_ = 500;
+  unsigned long lastAttemptMs_ = 0;
+  bool attempted_ = false;
+
+  // Heartbeat : ping périodique, déconnexion après N pongs manqués
+  uint32_t pingIntervalMs_ = 0;
+  uint32_t pongTimeoutMs_ = 0;
+  uint8_t disconnectTimeoutCount_ = 0;
+  uint8_t missedPongs_ = 0;
+  bool pongPending_ = false;
+  unsigned long lastPingMs_ = 0;
+
+  std::vector<uint8_t> rx_;        // Octets reçus non encore découpés en trames
+  std::vector<uint8_t> message_;   // Message fragmenté en cours de réassemblage
+  uint8_t messageOpcode_ = 0;
+};
@@ -0,0 +1,31 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * WiFi station toujours associé : le réseau est celui de la machine hôte
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+typedef enum { WL_IDLE_STATUS = 0, WL_CONNECTED = 3, WL_DISCONNECTED = 6 } wl_status_t;
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+class WiFiClass {
+ public:
+  bool mode(wifi_mode_t mode) { (void)mode; return true; }
+  bool setSleep(bool enabled) { (void)enabled; return true; }
+  bool setAutoReconnect(bool enabled) { (void)enabled; return true; }
+  bool persistent(bool enabled) { (void)enabled; return true; }
+  wl_status_t begin(const char* ssid, const char* passphrase) {
+    (void)ssid;
+    (void)passphrase;
+    return WL_CONNECTED;
+  }
+  wl_status_t status() { return WL_CONNECTED; }
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+
+  // Signal fixe (BENCH_RSSI) : les résumés de télémétrie gardent des valeurs plausibles
+  int8_t RSSI();
+};
+
+extern WiFiClass WiFi;
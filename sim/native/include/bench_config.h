@@ -0,0 +1,19 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Serveur et identité d'un module simulé, lus dans l'environnement du processus avant
+ * setup() (SERVER_URL, MODULE_ID, MODULE_PASSWORD) à la place des constantes du firmware
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+const size_t BENCH_CREDENTIAL_MAX = 48;
+
+extern const char* server_host;
+extern uint16_t server_port;
+extern const char* websocket_path;
+
+extern char MODULE_ID[BENCH_CREDENTIAL_MAX];
+extern char MODULE_PASSWORD[BENCH_CREDENTIAL_MAX];
@@ -0,0 +1,52 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Pilote LEDC de l'ESP-IDF (PWM et fondus matériels), sans sortie matérielle
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "esp_timer.h"
+
+typedef enum { LEDC_LOW_SPEED_MODE = 0, LEDC_SPEED_MODE_MAX } ledc_mode_t;
+typedef enum { LEDC_TIMER_0 = 0, LEDC_TIMER_1, LEDC_TIMER_2, LEDC_TIMER_3, LEDC_TIMER_MAX } ledc_timer_t;
+typedef enum {
+  LEDC_CHANNEL_0 = 0,
+  LEDC_CHANNEL_1,
+  LEDC_CHANNEL_2,
+  LEDC_CHANNEL_3,
+  LEDC_CHANNEL_4,
+  LEDC_CHANNEL_5,
+  LEDC_CHANNEL_6,
+  LEDC_CHANNEL_7,
+  LEDC_CHANNEL_MAX
+} ledc_channel_t;
+typedef enum { LEDC_TIMER_1_BIT = 1, LEDC_TIMER_13_BIT = 13, LEDC_TIMER_BIT_MAX = 21 } ledc_timer_bit_t;
+typedef enum { LEDC_AUTO_CLK = 0 } ledc_clk_cfg_t;
+typedef enum { LEDC_FADE_NO_WAIT = 0, LEDC_FADE_WAIT_DONE } ledc_fade_mode_t;
+
+typedef struct {
+  ledc_mode_t speed_mode;
+  ledc_timer_bit_t duty_resolution;
+  ledc_timer_t timer_num;
+  uint32_t freq_hz;
+  ledc_clk_cfg_t clk_cfg;
+} ledc_timer_config_t;
+
+typedef struct {
+  int gpio_num;
+  ledc_mode_t speed_mode;
+  ledc_channel_t channel;
+  ledc_timer_t timer_sel;
+  uint32_t duty;
+  int hpoint;
+} ledc_channel_config_t;
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* config);
+esp_err_t ledc_channel_config(const ledc_channel_config_t* config);
+esp_err_t ledc_fade_func_install(int intrAllocFlags);
+esp_err_t ledc_set_fade_with_time(ledc_mode_t mode, ledc_channel_t channel, uint32_t targetDuty, int maxFadeTimeMs);
+esp_err_t ledc_fade_start(ledc_mode_t mode, ledc_channel_t channel, ledc_fade_mode_t fadeMode);
+esp_err_t ledc_fade_stop(ledc_mode_t mode, ledc_channel_t channel);
+esp_err_t ledc_set_duty_and_update(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint);
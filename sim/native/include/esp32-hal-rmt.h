@@ -0,0 +1,31 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * RMT du cœur Arduino-ESP32 3.x : canaux et émissions acceptés sans sortie matérielle
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+typedef union {
+  struct {
+    uint32_t duration0 : 15;
+    uint32_t level0 : 1;
+    uint32_t duration1 : 15;
+    uint32_t level1 : 1;
+  };
+  uint32_t val;
+} rmt_data_t;
+
+typedef enum { RMT_RX_MODE = 0, RMT_TX_MODE } rmt_ch_dir_t;
+typedef enum {
+  RMT_MEM_NUM_BLOCKS_1 = 1,
+  RMT_MEM_NUM_BLOCKS_2,
+  RMT_MEM_NUM_BLOCKS_3,
+  RMT_MEM_NUM_BLOCKS_4,
+} rmt_reserve_memsize_t;
+
+bool rmtInit(int pin, rmt_ch_dir_t direction, rmt_reserve_memsize_t memsize, uint32_t frequencyHz);
+bool rmtWrite(int pin, rmt_data_t* data, size_t symbols, uint32_t timeoutMs);
+bool rmtWriteAsync(int pin, rmt_data_t* data, size_t symbols);
@@ -0,0 +1,42 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * ESP-NOW émulé en multicast UDP sur la boucle locale : les modules simulés d'une même
+ * machine reçoivent les trames diffusées (arrêt d'urgence LAN) comme sur le même canal WiFi
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "esp_timer.h"
+
+#define ESP_NOW_ETH_ALEN 6
+#define ESP_NOW_MAX_DATA_LEN 250
+
+typedef struct {
+  uint8_t peer_addr[ESP_NOW_ETH_ALEN];
+  uint8_t lmk[16];
+  uint8_t channel;
+  int ifidx;
+  bool encrypt;
+  void* priv;
+} esp_now_peer_info_t;
+
+typedef struct {
+  uint8_t* src_addr;
+  uint8_t* des_addr;
+  void* rx_ctrl;
+} esp_now_recv_info_t;
+
+typedef enum { ESP_NOW_SEND_SUCCESS = 0, ESP_NOW_SEND_FAIL } esp_now_send_status_t;
+
+typedef void (*esp_now_recv_cb_t)(const esp_now_recv_info_t* info, const uint8_t* data, int length);
+typedef void (*esp_now_send_cb_t)(const uint8_t* mac, esp_now_send_status_t status);
+
+esp_err_t esp_now_init();
+esp_err_t esp_now_deinit();
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer);
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t callback);
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t callback);
+esp_err_t esp_now_send(const uint8_t* peer_addr, const uint8_t* data, size_t length);
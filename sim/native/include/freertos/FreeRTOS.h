@@ -0,0 +1,22 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Types et constantes FreeRTOS utilisés par les firmwares (tâches sur threads, voir task.h)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+typedef int BaseType_t;
+typedef uint32_t TickType_t;
+typedef uint32_t UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define configMAX_PRIORITIES 25
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// Pas d'ordonnanceur à réveiller : les threads du banc sont préemptés par l'hôte
+#define portYIELD_FROM_ISR()
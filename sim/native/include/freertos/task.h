@@ -0,0 +1,19 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Tâches FreeRTOS sur threads : création, notifications (compteur) et délais ; priorité
+ * et cœur sont ignorés, l'hôte ordonnance
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void* arg);
+typedef struct bench_task* TaskHandle_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core);
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait);
+void vTaskDelay(TickType_t ticks);
@@ -0,0 +1,15 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Registres GPIO de l'ESP32 : les écritures W1TS / W1TC passent par les broches du banc
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#define GPIO_OUT_W1TS_REG 0x3FF44008
+#define GPIO_OUT_W1TC_REG 0x3FF4400C
+
+void benchRegWrite(uint32_t reg, uint32_t value);
+
+#define REG_WRITE(reg, value) benchRegWrite((reg), (value))
@@ -0,0 +1,251 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Cœur Arduino natif : horloge monotone, console, broches, configuration du module et
+ * point d'entrée (setup() puis loop() en boucle, comme la tâche Arduino de l'ESP32)
+ */
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <soc/gpio_reg.h>
+
+#include <cstdarg>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "bench_config.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+// ============================================================================
+// CONFIGURATION DU MODULE SIMULÉ
+// ============================================================================
+
+static std::string serverHost = "127.0.0.1";
+static std::string serverPath = "/esp32";
+
+const char* server_host = serverHost.c_str();
+uint16_t server_port = 3000;
+const char* websocket_path = serverPath.c_str();
+
+char MODULE_ID[BENCH_CREDENTIAL_MAX] = "MC-0001-ST";
+char MODULE_PASSWORD[BENCH_CREDENTIAL_MAX] = "F674iaRftVsHGKOA8hq3TI93HQHUaYqZ";
+
+static int8_t benchRssi = -55;
+static uint64_t benchInputsLow = 0;   // Entrées reliées à la masse (BENCH_PINS_LOW)
+static const uint32_t BENCH_FREE_HEAP = 240 * 1024;  // Ordre de grandeur d'un ESP32 WiFi actif
+
+// SERVER_URL de la forme ws://hôte:port/chemin
+static bool parseServerUrl(const char* url) {
+  std::string value(url);
+  const std::string scheme = "ws://";
+  if (value.compare(0, scheme.size(), scheme) != 0) return false;
+  value.erase(0, scheme.size());
+
+  size_t slash = value.find('/');
+  std::string authority = value.substr(0, slash);
+  serverPath = slash == std::string::npos ? "/" : value.substr(slash);
+
+  size_t colon = authority.rfind(':');
+  if (colon != std::string::npos) {
+    server_port = static_cast<uint16_t>(atoi(authority.c_str() + colon + 1));
+    authority.erase(colon);
+  } else {
+    server_port = 80;
+  }
+  if (authority.empty() || server_port == 0) return false;
+  serverHost = authority;
+
+  server_host = serverHost.c_str();
+  websocket_path = serverPath.c_str();
+  return true;
+}
+
+static bool copyCredential(char* target, const char* name) {
+  const char* value = getenv(name);
+  if (!value) return true;
+  if (strlen(value) >= BENCH_CREDENTIAL_MAX) {
+    fprintf(stderr, "[BENCH] %s trop long (max %zu caractères)\n", name, BENCH_CREDENTIAL_MAX - 1);
+    return false;
+  }
+  strlcpy(target, value, BENCH_CREDENTIAL_MAX);
+  return true;
+}
+
+static bool loadConfig() {
+  const char* url = getenv("SERVER_URL");
+  if (url && !parseServerUrl(url)) {
+    fprintf(stderr, "[BENCH] SERVER_URL invalide: %s (attendu ws://hôte:port/chemin)\n", url);
+    return false;
+  }
+  if (const char* rssi = getenv("BENCH_RSSI")) {
+    benchRssi = static_cast<int8_t>(atoi(rssi));
+  }
+  // Liste de broches séparées par des virgules, ex. contact d'arrêt fermé : BENCH_PINS_LOW=33
+  if (const char* pins = getenv("BENCH_PINS_LOW")) {
+    for (const char* cursor = pins; *cursor;) {
+      char* end = nullptr;
+      long pin = strtol(cursor, &end, 10);
+      if (end == cursor) break;
+      if (pin >= 0 && pin < 64) benchInputsLow |= 1ULL << pin;
+      cursor = *end == ',' ? end + 1 : end;
+    }
+  }
+  return copyCredential(MODULE_ID, "MODULE_ID") && copyCredential(MODULE_PASSWORD, "MODULE_PASSWORD");
+}
+
+int main() {
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+  if (!loadConfig()) return 2;
+
+  setup();
+  for (;;) {
+    loop();
+  }
+}
+
+// ============================================================================
+// TEMPS
+// ============================================================================
+
+static const auto bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+  auto elapsed = std::chrono::steady_clock::now() - bootTime;
+  return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+unsigned long micros() {
+  auto elapsed = std::chrono::steady_clock::now() - bootTime;
+  return static_cast<unsigned long>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {
+  std::this_thread::yield();
+}
+
+// ============================================================================
+// BROCHES ET PÉRIPHÉRIQUES
+// ============================================================================
+
+// Pas de matériel : l'état des broches n'est conservé que pour digitalRead. Une entrée en
+// pull-up lit HIGH, sauf si BENCH_PINS_LOW la relie à la masse ; elle ne change plus ensuite,
+// les interruptions attachées ne sont donc jamais levées
+static uint8_t pinLevels[64];
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= sizeof(pinLevels)) return;
+  bool grounded = (benchInputsLow >> pin) & 1;
+  pinLevels[pin] = mode == INPUT_PULLUP && !grounded ? HIGH : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < sizeof(pinLevels)) pinLevels[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < sizeof(pinLevels) ? pinLevels[pin] : LOW;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+  (void)pin;
+  (void)handler;
+  (void)mode;
+}
+
+// Écriture directe des registres de sortie (GPIO 0 à 31)
+void benchRegWrite(uint32_t reg, uint32_t value) {
+  if (reg != GPIO_OUT_W1TS_REG && reg != GPIO_OUT_W1TC_REG) return;
+  for (uint8_t pin = 0; pin < 32; pin++) {
+    if ((value >> pin) & 1) digitalWrite(pin, reg == GPIO_OUT_W1TS_REG ? HIGH : LOW);
+  }
+}
+
+bool ledcAttach(uint8_t pin, uint32_t freq, uint8_t resolution) {
+  (void)pin;
+  (void)freq;
+  (void)resolution;
+  return true;
+}
+
+bool ledcWrite(uint8_t pin, uint32_t duty) {
+  (void)pin;
+  (void)duty;
+  return true;
+}
+
+uint32_t esp_random() {
+  static std::random_device device;
+  return device();
+}
+
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t length = strlen(src);
+  if (size > 0) {
+    size_t copied = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, copied);
+    dst[copied] = '\0';
+  }
+  return length;
+}
+#endif
+
+int8_t WiFiClass::RSSI() {
+  return benchRssi;
+}
+
+uint32_t EspClass::getFreeHeap() {
+  return BENCH_FREE_HEAP;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  return BENCH_FREE_HEAP;
+}
+
+// ============================================================================
+// CONSOLE SÉRIE
+// ============================================================================
+
+int HardwareSerial::printf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  int written = vprintf(format, args);
+  va_end(args);
+  return written;
+}
+
+void HardwareSerial::print(const char* value) {
+  fputs(value, stdout);
+}
+
+void HardwareSerial::print(char value) {
+  fputc(value, stdout);
+}
+
+void HardwareSerial::print(long value) {
+  ::printf("%ld", value);
+}
+
+void HardwareSerial::print(unsigned long value) {
+  ::printf("%lu", value);
+}
+
+void HardwareSerial::print(double value) {
+  ::printf("%.2f", value);
+}
+
+void HardwareSerial::print(const IPAddress& value) {
+  ::printf("%u.%u.%u.%u", value[0], value[1], value[2], value[3]);
+}
+
+void HardwareSerial::println() {
+  fputc('\n', stdout);
+}
@@ -0,0 +1,133 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * ESP-NOW sur multicast UDP (boucle locale) : datagramme = adresse MAC source | données.
+ * Un thread de réception appelle le callback, comme la tâche WiFi de l'ESP32
+ */
+
+#include <esp_now.h>
+
+#include <Arduino.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+
+static const char* BENCH_NOW_GROUP = "239.77.67.1";   // Groupe partagé par les modules du banc
+static const uint16_t BENCH_NOW_PORT = 47650;
+static const uint8_t BROADCAST_ADDR[ESP_NOW_ETH_ALEN] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+static int nowSocket = -1;
+static uint8_t localMac[ESP_NOW_ETH_ALEN];
+static sockaddr_in groupAddr = {};
+static volatile esp_now_recv_cb_t recvCallback = nullptr;
+static volatile esp_now_send_cb_t sendCallback = nullptr;
+
+static void receiveFrames() {
+  uint8_t datagram[ESP_NOW_ETH_ALEN + ESP_NOW_MAX_DATA_LEN];
+
+  for (;;) {
+    ssize_t received = recv(nowSocket, datagram, sizeof(datagram), 0);
+    if (received < 0) return;
+    if (received <= ESP_NOW_ETH_ALEN) continue;
+
+    // Trame émise par ce module : la radio ne reçoit pas ses propres diffusions
+    if (memcmp(datagram, localMac, ESP_NOW_ETH_ALEN) == 0) continue;
+
+    esp_now_recv_cb_t callback = recvCallback;
+    if (!callback) continue;
+
+    esp_now_recv_info_t info = {};
+    info.src_addr = datagram;
+    info.des_addr = const_cast<uint8_t*>(BROADCAST_ADDR);
+    callback(&info, datagram + ESP_NOW_ETH_ALEN, static_cast<int>(received - ESP_NOW_ETH_ALEN));
+  }
+}
+
+esp_err_t esp_now_init() {
+  if (nowSocket >= 0) return ESP_OK;
+
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return ESP_FAIL;
+
+  int enable = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+  setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+
+  sockaddr_in bindAddr = {};
+  bindAddr.sin_family = AF_INET;
+  bindAddr.sin_port = htons(BENCH_NOW_PORT);
+  bindAddr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, reinterpret_cast<sockaddr*>(&bindAddr), sizeof(bindAddr)) < 0) {
+    close(fd);
+    return ESP_FAIL;
+  }
+
+  ip_mreq membership = {};
+  inet_pton(AF_INET, BENCH_NOW_GROUP, &membership.imr_multiaddr);
+  membership.imr_interface.s_addr = htonl(INADDR_LOOPBACK);
+  in_addr loopback = {};
+  loopback.s_addr = htonl(INADDR_LOOPBACK);
+  unsigned char loop = 1;
+  if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0 ||
+      setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback)) < 0 ||
+      setsockopt(fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) < 0) {
+    close(fd);
+    return ESP_FAIL;
+  }
+
+  groupAddr.sin_family = AF_INET;
+  groupAddr.sin_port = htons(BENCH_NOW_PORT);
+  groupAddr.sin_addr = membership.imr_multiaddr;
+
+  // Adresse MAC locale administrée, tirée au démarrage
+  for (size_t i = 0; i < ESP_NOW_ETH_ALEN; i++) {
+    localMac[i] = static_cast<uint8_t>(esp_random());
+  }
+  localMac[0] = (localMac[0] & 0xFE) | 0x02;
+
+  nowSocket = fd;
+  std::thread(receiveFrames).detach();
+  return ESP_OK;
+}
+
+esp_err_t esp_now_deinit() {
+  recvCallback = nullptr;
+  sendCallback = nullptr;
+  return ESP_OK;
+}
+
+esp_err_t esp_now_add_peer(const esp_now_peer_info_t* peer) {
+  return peer ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t callback) {
+  recvCallback = callback;
+  return ESP_OK;
+}
+
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t callback) {
+  sendCallback = callback;
+  return ESP_OK;
+}
+
+// Toute trame est diffusée au groupe ; les destinataires unicast filtrent côté firmware
+esp_err_t esp_now_send(const uint8_t* peer_addr, const uint8_t* data, size_t length) {
+  if (nowSocket < 0) return ESP_ERR_INVALID_STATE;
+  if (!data || length == 0 || length > ESP_NOW_MAX_DATA_LEN) return ESP_ERR_INVALID_ARG;
+
+  uint8_t datagram[ESP_NOW_ETH_ALEN + ESP_NOW_MAX_DATA_LEN];
+  memcpy(datagram, localMac, ESP_NOW_ETH_ALEN);
+  memcpy(datagram + ESP_NOW_ETH_ALEN, data, length);
+
+  ssize_t sent = sendto(nowSocket, datagram, ESP_NOW_ETH_ALEN + length, 0,
+                        reinterpret_cast<const sockaddr*>(&groupAddr), sizeof(groupAddr));
+
+  esp_now_send_cb_t callback = sendCallback;
+  if (callback) {
+    callback(peer_addr ? peer_addr : BROADCAST_ADDR, sent < 0 ? ESP_NOW_SEND_FAIL : ESP_NOW_SEND_SUCCESS);
+  }
+  return sent < 0 ? ESP_FAIL : ESP_OK;
+}
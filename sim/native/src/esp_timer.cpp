@@ -0,0 +1,126 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * esp_timer sur threads : échéances absolues (pas de dérive) et callbacks hors de loop()
+ */
+
+#include <esp_timer.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static const auto bootTime = Clock::now();
+
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void* arg;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::thread worker;
+  bool armed = false;
+  bool periodic = false;
+  bool deleted = false;
+  uint64_t generation = 0;           // Incrémenté à chaque start/stop : annule l'échéance en cours
+  std::chrono::microseconds period{ 0 };
+  Clock::time_point deadline;
+};
+
+static void runTimer(esp_timer* timer) {
+  std::unique_lock<std::mutex> lock(timer->mutex);
+
+  while (!timer->deleted) {
+    if (!timer->armed) {
+      timer->changed.wait(lock);
+      continue;
+    }
+
+    uint64_t generation = timer->generation;
+    if (timer->changed.wait_until(lock, timer->deadline, [&] {
+          return timer->deleted || timer->generation != generation;
+        })) {
+      continue;
+    }
+
+    // Échéance atteinte : la prochaine est calculée depuis la précédente, pas depuis maintenant
+    if (timer->periodic) {
+      timer->deadline += timer->period;
+    } else {
+      timer->armed = false;
+    }
+
+    lock.unlock();
+    timer->callback(timer->arg);
+    lock.lock();
+  }
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out_handle) {
+  if (!args || !args->callback || !out_handle) return ESP_ERR_INVALID_ARG;
+
+  esp_timer* timer = new esp_timer();
+  timer->callback = args->callback;
+  timer->arg = args->arg;
+  timer->worker = std::thread(runTimer, timer);
+  *out_handle = timer;
+  return ESP_OK;
+}
+
+static esp_err_t startTimer(esp_timer_handle_t timer, uint64_t us, bool periodic) {
+  if (!timer) return ESP_ERR_INVALID_ARG;
+
+  std::lock_guard<std::mutex> lock(timer->mutex);
+  if (timer->armed) return ESP_ERR_INVALID_STATE;
+  timer->armed = true;
+  timer->periodic = periodic;
+  timer->period = std::chrono::microseconds(us);
+  timer->deadline = Clock::now() + timer->period;
+  timer->generation++;
+  timer->changed.notify_all();
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  return startTimer(timer, timeout_us, false);
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+  return startTimer(timer, period_us, true);
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer) return ESP_ERR_INVALID_ARG;
+
+  std::lock_guard<std::mutex> lock(timer->mutex);
+  if (!timer->armed) return ESP_ERR_INVALID_STATE;
+  timer->armed = false;
+  timer->generation++;
+  timer->changed.notify_all();
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  if (!timer) return ESP_ERR_INVALID_ARG;
+
+  {
+    std::lock_guard<std::mutex> lock(timer->mutex);
+    if (timer->armed) return ESP_ERR_INVALID_STATE;
+    timer->deleted = true;
+    timer->changed.notify_all();
+  }
+
+  // Appelé depuis son propre callback : le thread se termine seul
+  if (timer->worker.get_id() == std::this_thread::get_id()) {
+    timer->worker.detach();
+    return ESP_OK;
+  }
+  timer->worker.join();
+  delete timer;
+  return ESP_OK;
+}
+
+int64_t esp_timer_get_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - bootTime).count();
+}
@@ -0,0 +1,79 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Tâches FreeRTOS sur threads : notification = compteur protégé, réveil par variable de
+ * condition (comme ulTaskNotifyTake en mode compteur)
+ */
+
+#include <freertos/task.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+struct bench_task {
+  TaskFunction_t code;
+  void* arg;
+  std::mutex mutex;
+  std::condition_variable notified;
+  uint32_t notifications = 0;
+  std::thread worker;
+};
+
+// Tâche courante, pour ulTaskNotifyTake appelé depuis son propre thread
+static thread_local bench_task* currentTask = nullptr;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t priority, TaskHandle_t* created, BaseType_t core) {
+  (void)name;
+  (void)stackDepth;
+  (void)priority;
+  (void)core;
+
+  bench_task* task = new bench_task();
+  task->code = code;
+  task->arg = arg;
+  if (created) *created = task;
+  task->worker = std::thread([task]() {
+    currentTask = task;
+    task->code(task->arg);
+  });
+  task->worker.detach();
+  return pdTRUE;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  if (!task) return pdFALSE;
+  {
+    std::lock_guard<std::mutex> lock(task->mutex);
+    task->notifications++;
+  }
+  task->notified.notify_one();
+  return pdTRUE;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* higherPriorityTaskWoken) {
+  xTaskNotifyGive(task);
+  if (higherPriorityTaskWoken) *higherPriorityTaskWoken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t ticksToWait) {
+  bench_task* task = currentTask;
+  if (!task) return 0;
+
+  std::unique_lock<std::mutex> lock(task->mutex);
+  auto ready = [task]() { return task->notifications > 0; };
+  if (ticksToWait == portMAX_DELAY) {
+    task->notified.wait(lock, ready);
+  } else if (!task->notified.wait_for(lock, std::chrono::milliseconds(ticksToWait * portTICK_PERIOD_MS), ready)) {
+    return 0;
+  }
+
+  uint32_t count = task->notifications;
+  task->notifications = clearOnExit ? 0 : count - 1;
+  return count;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
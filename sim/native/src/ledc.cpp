@@ -0,0 +1,71 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Pilotes LEDC et RMT sans matériel : configurations, fondus et trames de bande sont
+ * vérifiés puis acceptés sans sortie
+ */
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+
+static bool validChannel(ledc_channel_t channel) {
+  return channel >= LEDC_CHANNEL_0 && channel < LEDC_CHANNEL_MAX;
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* config) {
+  return config ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t* config) {
+  return config && validChannel(config->channel) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_fade_func_install(int intrAllocFlags) {
+  (void)intrAllocFlags;
+  return ESP_OK;
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t mode, ledc_channel_t channel, uint32_t targetDuty, int maxFadeTimeMs) {
+  (void)mode;
+  (void)targetDuty;
+  (void)maxFadeTimeMs;
+  return validChannel(channel) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t mode, ledc_channel_t channel, ledc_fade_mode_t fadeMode) {
+  (void)mode;
+  (void)fadeMode;
+  return validChannel(channel) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_fade_stop(ledc_mode_t mode, ledc_channel_t channel) {
+  (void)mode;
+  return validChannel(channel) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty, uint32_t hpoint) {
+  (void)mode;
+  (void)duty;
+  (void)hpoint;
+  return validChannel(channel) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+// ============================================================================
+// RMT
+// ============================================================================
+
+bool rmtInit(int pin, rmt_ch_dir_t direction, rmt_reserve_memsize_t memsize, uint32_t frequencyHz) {
+  (void)pin;
+  (void)direction;
+  (void)memsize;
+  return frequencyHz > 0;
+}
+
+bool rmtWrite(int pin, rmt_data_t* data, size_t symbols, uint32_t timeoutMs) {
+  (void)timeoutMs;
+  return rmtWriteAsync(pin, data, symbols);
+}
+
+bool rmtWriteAsync(int pin, rmt_data_t* data, size_t symbols) {
+  (void)pin;
+  return data != nullptr && symbols > 0;
+}
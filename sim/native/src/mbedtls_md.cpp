@@ -0,0 +1,27 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * HMAC mbedtls_md via OpenSSL (libcrypto)
+ */
+
+#include <mbedtls/md.h>
+
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+
+struct mbedtls_md_info_t {
+  mbedtls_md_type_t type;
+};
+
+static const mbedtls_md_info_t SHA256_INFO = { MBEDTLS_MD_SHA256 };
+
+const mbedtls_md_info_t* mbedtls_md_info_from_type(mbedtls_md_type_t type) {
+  return type == MBEDTLS_MD_SHA256 ? &SHA256_INFO : nullptr;
+}
+
+int mbedtls_md_hmac(const mbedtls_md_info_t* md_info, const unsigned char* key, size_t keylen,
+                    const unsigned char* input, size_t ilen, unsigned char* output) {
+  if (!md_info || md_info->type != MBEDTLS_MD_SHA256) return -1;
+
+  unsigned int length = 0;
+  return HMAC(EVP_sha256(), key, static_cast<int>(keylen), input, ilen, output, &length) ? 0 : -1;
+}
@@ -0,0 +1,96 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Preferences : lignes "clé=valeur" (octets en hexadécimal après '#'), réécrites en entier
+ * (fichier temporaire puis rename)
+ */
+
+#include <Preferences.h>
+
+#include <cstdio>
+
+#include "bench_config.h"
+
+bool Preferences::begin(const char* name, bool readOnly) {
+  const char* dir = getenv("BENCH_NVS_DIR");
+  if (!dir) dir = getenv("TMPDIR");
+  if (!dir) dir = "/tmp";
+
+  path_ = std::string(dir) + "/mc-nvs-" + MODULE_ID + "-" + name;
+  readOnly_ = readOnly;
+  values_.clear();
+  blobs_.clear();
+
+  if (FILE* file = fopen(path_.c_str(), "r")) {
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+      char* value = strchr(line, '=');
+      if (!value) continue;
+      *value++ = '\0';
+      if (*value != '#') {
+        values_[line] = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        continue;
+      }
+      std::vector<uint8_t>& blob = blobs_[line];
+      unsigned int byte;
+      for (const char* hex = value + 1; sscanf(hex, "%2x", &byte) == 1; hex += 2) {
+        blob.push_back(static_cast<uint8_t>(byte));
+      }
+    }
+    fclose(file);
+  }
+
+  open_ = true;
+  return true;
+}
+
+void Preferences::end() {
+  open_ = false;
+  values_.clear();
+  blobs_.clear();
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+  if (!open_) return defaultValue;
+  auto found = values_.find(key);
+  return found == values_.end() ? defaultValue : found->second;
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+  if (!open_ || readOnly_) return 0;
+  values_[key] = value;
+  return save() ? sizeof(value) : 0;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+  if (!open_) return 0;
+  auto found = blobs_.find(key);
+  if (found == blobs_.end() || found->second.size() > maxLength) return 0;
+  memcpy(buffer, found->second.data(), found->second.size());
+  return found->second.size();
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+  if (!open_ || readOnly_) return 0;
+  const uint8_t* bytes = static_cast<const uint8_t*>(value);
+  blobs_[key].assign(bytes, bytes + length);
+  return save() ? length : 0;
+}
+
+bool Preferences::save() {
+  std::string temporary = path_ + ".tmp";
+  FILE* file = fopen(temporary.c_str(), "w");
+  if (!file) return false;
+
+  for (const auto& entry : values_) {
+    fprintf(file, "%s=%lu\n", entry.first.c_str(), static_cast<unsigned long>(entry.second));
+  }
+  for (const auto& entry : blobs_) {
+    fprintf(file, "%s=#", entry.first.c_str());
+    for (uint8_t byte : entry.second) {
+      fprintf(file, "%02x", byte);
+    }
+    fprintf(file, "\n");
+  }
+  bool written = fclose(file) == 0;
+  return written && rename(temporary.c_str(), path_.c_str()) == 0;
+}
@@ -0,0 +1,388 @@
+/*
+ * MicroCoaster - Banc natif des firmwares
+ * Client WebSocket RFC 6455 : connexion et poignée de main bloquantes (bornées), puis
+ * lecture non bloquante dans loop(). Trames client masquées, réassemblage des fragments,
+ * réponse aux ping, heartbeat et reconnexion périodique comme arduinoWebSockets
+ */
+
+#include <WebSocketsClient.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+
+static const int CONNECT_TIMEOUT_MS = 5000;
+static const int HANDSHAKE_TIMEOUT_MS = 5000;
+static const size_t HANDSHAKE_MAX_BYTES = 4096;
+static const size_t MESSAGE_MAX_BYTES = 64 * 1024;   // Borne du réassemblage (le firmware filtre à 1 Ko)
+static const char* WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+enum : uint8_t {
+  OP_CONTINUATION = 0x0,
+  OP_TEXT = 0x1,
+  OP_BINARY = 0x2,
+  OP_CLOSE = 0x8,
+  OP_PING = 0x9,
+  OP_PONG = 0xA,
+};
+
+static std::string base64(const uint8_t* data, size_t length) {
+  std::string out(4 * ((length + 2) / 3), '\0');
+  int written = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(&out[0]), data, static_cast<int>(length));
+  out.resize(written);
+  return out;
+}
+
+WebSocketsClient::~WebSocketsClient() {
+  closeSocket(false);
+}
+
+void WebSocketsClient::begin(const char* host, uint16_t port, const char* url) {
+  host_ = host;
+  port_ = port;
+  url_ = url;
+  started_ = true;
+  attempted_ = false;
+}
+
+void WebSocketsClient::enableHeartbeat(uint32_t pingIntervalMs, uint32_t pongTimeoutMs,
+                                       uint8_t disconnectTimeoutCount) {
+  pingIntervalMs_ = pingIntervalMs;
+  pongTimeoutMs_ = pongTimeoutMs;
+  disconnectTimeoutCount_ = disconnectTimeoutCount;
+}
+
+void WebSocketsClient::loop() {
+  if (!started_) return;
+
+  unsigned long now = millis();
+  if (!connected_) {
+    // Première tentative immédiate, puis au rythme de setReconnectInterval
+    if (attempted_ && now - lastAttemptMs_ < reconnectIntervalMs_) return;
+    attempted_ = true;
+    lastAttemptMs_ = now;
+
+    if (!connectSocket() || !handshake()) {
+      closeSocket(false);
+      return;
+    }
+    connected_ = true;
+    missedPongs_ = 0;
+    pongPending_ = false;
+    lastPingMs_ = now;
+    emit(WStype_CONNECTED, reinterpret_cast<uint8_t*>(&url_[0]), url_.size());
+    return;
+  }
+
+  readFrames();
+  if (!connected_) return;
+
+  if (pingIntervalMs_ > 0) {
+    now = millis();
+    if (pongPending_ && now - lastPingMs_ > pongTimeoutMs_) {
+      pongPending_ = false;
+      if (++missedPongs_ >= disconnectTimeoutCount_ && disconnectTimeoutCount_ > 0) {
+        closeSocket(true);
+        return;
+      }
+    }
+    if (!pongPending_ && now - lastPingMs_ >= pingIntervalMs_) {
+      lastPingMs_ = now;
+      pongPending_ = sendFrame(OP_PING, nullptr, 0);
+    }
+  }
+}
+
+void WebSocketsClient::disconnect() {
+  if (connected_) {
+    uint8_t code[2] = { 0x03, 0xE8 };   // 1000 : fermeture normale
+    sendFrame(OP_CLOSE, code, sizeof(code));
+  }
+  closeSocket(true);
+}
+
+bool WebSocketsClient::sendTXT(uint8_t* payload, size_t length, bool headerToPayload) {
+  if (length == 0 && !headerToPayload) length = strlen(reinterpret_cast<const char*>(payload));
+  const uint8_t* data = headerToPayload ? payload + WEBSOCKETS_MAX_HEADER_SIZE : payload;
+  return sendFrame(OP_TEXT, data, length);
+}
+
+bool WebSocketsClient::sendBIN(uint8_t* payload, size_t length, bool headerToPayload) {
+  const uint8_t* data = headerToPayload ? payload + WEBSOCKETS_MAX_HEADER_SIZE : payload;
+  return sendFrame(OP_BINARY, data, length);
+}
+
+// ============================================================================
+// CONNEXION
+// ============================================================================
+
+bool WebSocketsClient::connectSocket() {
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* results = nullptr;
+  std::string port = std::to_string(port_);
+  if (getaddrinfo(host_.c_str(), port.c_str(), &hints, &results) != 0) return false;
+
+  for (addrinfo* candidate = results; candidate; candidate = candidate->ai_next) {
+    int fd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+    if (fd < 0) continue;
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    int result = ::connect(fd, candidate->ai_addr, candidate->ai_addrlen);
+    if (result < 0 && errno == EINPROGRESS) {
+      pollfd waiter = { fd, POLLOUT, 0 };
+      int error = 0;
+      socklen_t size = sizeof(error);
+      if (poll(&waiter, 1, CONNECT_TIMEOUT_MS) == 1 &&
+          getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size) == 0 && error == 0) {
+        result = 0;
+      }
+    }
+
+    if (result == 0) {
+      int enable = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+      fd_ = fd;
+      break;
+    }
+    ::close(fd);
+  }
+
+  freeaddrinfo(results);
+  return fd_ >= 0;
+}
+
+bool WebSocketsClient::handshake() {
+  uint8_t nonce[16];
+  for (size_t i = 0; i < sizeof(nonce); i += 4) {
+    uint32_t value = esp_random();
+    memcpy(nonce + i, &value, 4);
+  }
+  std::string key = base64(nonce, sizeof(nonce));
+
+  std::string request = "GET " + url_ + " HTTP/1.1\r\n" +
+                        "Host: " + host_ + ":" + std::to_string(port_) + "\r\n" +
+                        "Upgrade: websocket\r\n"
+                        "Connection: Upgrade\r\n"
+                        "Sec-WebSocket-Key: " + key + "\r\n"
+                        "Sec-WebSocket-Version: 13\r\n"
+                        "User-Agent: arduino-WebSocket-Client\r\n\r\n";
+  if (!sendAll(reinterpret_cast<const uint8_t*>(request.data()), request.size())) return false;
+
+  // Réponse HTTP jusqu'à la ligne vide ; les octets suivants sont déjà des trames
+  std::string response;
+  unsigned long start = millis();
+  size_t headerEnd = std::string::npos;
+  while (headerEnd == std::string::npos) {
+    long remaining = HANDSHAKE_TIMEOUT_MS - static_cast<long>(millis() - start);
+    pollfd waiter = { fd_, POLLIN, 0 };
+    if (remaining <= 0 || poll(&waiter, 1, static_cast<int>(remaining)) != 1) return false;
+
+    char buffer[1024];
+    ssize_t received = recv(fd_, buffer, sizeof(buffer), 0);
+    if (received <= 0) return false;
+    response.append(buffer, received);
+    if (response.size() > HANDSHAKE_MAX_BYTES) return false;
+    headerEnd = response.find("\r\n\r\n");
+  }
+
+  if (response.compare(0, 12, "HTTP/1.1 101") != 0) return false;
+
+  uint8_t digest[SHA_DIGEST_LENGTH];
+  std::string accept = key + WS_GUID;
+  SHA1(reinterpret_cast<const uint8_t*>(accept.data()), accept.size(), digest);
+  std::string expected = base64(digest, sizeof(digest));
+
+  std::string headers = response.substr(0, headerEnd);
+  for (char& c : headers) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  size_t field = headers.find("\r\nsec-websocket-accept:");
+  if (field == std::string::npos) return false;
+  size_t valueStart = response.find_first_not_of(' ', field + 23);
+  size_t valueEnd = response.find("\r\n", valueStart);
+  if (response.compare(valueStart, valueEnd - valueStart, expected) != 0) return false;
+
+  rx_.assign(response.begin() + headerEnd + 4, response.end());
+  message_.clear();
+  return true;
+}
+
+void WebSocketsClient::closeSocket(bool notify) {
+  bool wasConnected = connected_;
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  connected_ = false;
+  rx_.clear();
+  message_.clear();
+  if (notify && wasConnected) {
+    emit(WStype_DISCONNECTED, nullptr, 0);
+  }
+}
+
+void WebSocketsClient::emit(WStype_t type, uint8_t* payload, size_t length) {
+  if (callback_) callback_(type, payload, length);
+}
+
+// ============================================================================
+// TRAMES
+// ============================================================================
+
+bool WebSocketsClient::sendAll(const uint8_t* data, size_t length) {
+  while (length > 0) {
+    ssize_t sent = send(fd_, data, length, MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+      pollfd waiter = { fd_, POLLOUT, 0 };
+      if (poll(&waiter, 1, CONNECT_TIMEOUT_MS) != 1) return false;
+      continue;
+    }
+    data += sent;
+    length -= sent;
+  }
+  return true;
+}
+
+bool WebSocketsClient::sendFrame(uint8_t opcode, const uint8_t* data, size_t length) {
+  if (fd_ < 0) return false;
+
+  std::vector<uint8_t> frame;
+  frame.reserve(WEBSOCKETS_MAX_HEADER_SIZE + length);
+  frame.push_back(0x80 | opcode);
+  if (length < 126) {
+    frame.push_back(0x80 | static_cast<uint8_t>(length));
+  } else if (length <= 0xFFFF) {
+    frame.push_back(0x80 | 126);
+    frame.push_back(static_cast<uint8_t>(length >> 8));
+    frame.push_back(static_cast<uint8_t>(length));
+  } else {
+    frame.push_back(0x80 | 127);
+    for (int shift = 56; shift >= 0; shift -= 8) frame.push_back(static_cast<uint8_t>(static_cast<uint64_t>(length) >> shift));
+  }
+
+  uint32_t maskValue = esp_random();
+  uint8_t mask[4];
+  memcpy(mask, &maskValue, sizeof(mask));
+  frame.insert(frame.end(), mask, mask + 4);
+  for (size_t i = 0; i < length; i++) frame.push_back(data[i] ^ mask[i & 3]);
+
+  if (!sendAll(frame.data(), frame.size())) {
+    closeSocket(true);
+    return false;
+  }
+  return true;
+}
+
+void WebSocketsClient::readFrames() {
+  uint8_t buffer[4096];
+  for (;;) {
+    ssize_t received = recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (received > 0) {
+      rx_.insert(rx_.end(), buffer, buffer + received);
+      continue;
+    }
+    if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+      // Trames déjà reçues traitées avant de signaler la fermeture
+      while (parseFrame()) {}
+      closeSocket(true);
+      return;
+    }
+    break;
+  }
+
+  while (connected_ && parseFrame()) {}
+}
+
+// Découpe une trame complète en tête de rx_ ; false s'il en manque une partie
+bool WebSocketsClient::parseFrame() {
+  if (rx_.size() < 2) return false;
+
+  bool fin = rx_[0] & 0x80;
+  uint8_t opcode = rx_[0] & 0x0F;
+  bool masked = rx_[1] & 0x80;
+  uint64_t length = rx_[1] & 0x7F;
+  size_t offset = 2;
+
+  if (length == 126) {
+    if (rx_.size() < 4) return false;
+    length = (rx_[2] << 8) | rx_[3];
+    offset = 4;
+  } else if (length == 127) {
+    if (rx_.size() < 10) return false;
+    length = 0;
+    for (int i = 0; i < 8; i++) length = (length << 8) | rx_[2 + i];
+    offset = 10;
+  }
+
+  uint8_t mask[4] = {};
+  if (masked) {
+    if (rx_.size() < offset + 4) return false;
+    memcpy(mask, &rx_[offset], 4);
+    offset += 4;
+  }
+
+  if (length > MESSAGE_MAX_BYTES) {
+    closeSocket(true);
+    return false;
+  }
+  if (rx_.size() < offset + length) return false;
+
+  // Charge utile terminée par un zéro, comme la bibliothèque Arduino
+  std::vector<uint8_t> payload(rx_.begin() + offset, rx_.begin() + offset + length);
+  if (masked) {
+    for (size_t i = 0; i < payload.size(); i++) payload[i] ^= mask[i & 3];
+  }
+  rx_.erase(rx_.begin(), rx_.begin() + offset + length);
+
+  switch (opcode) {
+    case OP_TEXT:
+    case OP_BINARY:
+    case OP_CONTINUATION: {
+      if (opcode != OP_CONTINUATION) {
+        messageOpcode_ = opcode;
+        message_.clear();
+      }
+      message_.insert(message_.end(), payload.begin(), payload.end());
+      if (message_.size() > MESSAGE_MAX_BYTES) {
+        closeSocket(true);
+        return false;
+      }
+      if (fin) {
+        size_t size = message_.size();
+        message_.push_back('\0');
+        emit(messageOpcode_ == OP_TEXT ? WStype_TEXT : WStype_BIN, message_.data(), size);
+        message_.clear();
+      }
+      break;
+    }
+
+    case OP_PING:
+      sendFrame(OP_PONG, payload.data(), payload.size());
+      break;
+
+    case OP_PONG:
+      pongPending_ = false;
+      missedPongs_ = 0;
+      break;
+
+    case OP_CLOSE:
+      sendFrame(OP_CLOSE, payload.data(), payload.size() >= 2 ? 2 : 0);
+      closeSocket(true);
+      return false;
+
+    default:
+      break;
+  }
+  return true;
+}
@@ -1,12 +1,9 @@
 -- Création des tables pour MicroCoaster WebApp
--- Exécution: En mode développement, ce script est exécuté automatiquement au démarrage
-
--- Supprimer les tables existantes en mode développement (ordre important pour les FK)
-DROP TABLE IF EXISTS modules;
-DROP TABLE IF EXISTS users;
+-- Exécution: à chaque démarrage ; idempotent, les tables existantes et leurs données sont conservées
+-- (remise à zéro : drop_tables.sql, uniquement avec DB_RESET_ON_START=true)
 
 -- Table des utilisateurs
-CREATE TABLE users (
+CREATE TABLE IF NOT EXISTS users (
   id INT AUTO_INCREMENT PRIMARY KEY,
   email VARCHAR(255) UNIQUE NOT NULL,
   password VARCHAR(255) NOT NULL,
@@ -22,7 +19,7 @@ CREATE TABLE users (
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
 
 -- Table des modules
-CREATE TABLE modules (
+CREATE TABLE IF NOT EXISTS modules (
   id INT AUTO_INCREMENT PRIMARY KEY,
   user_id INT NULL, -- NULL pour les modules non assignés
   module_id VARCHAR(50) NOT NULL UNIQUE,
@@ -43,4 +40,13 @@ CREATE TABLE modules (
   INDEX idx_type (type),
   INDEX idx_status (status),
   INDEX idx_last_seen (last_seen)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
+
+-- Table des sessions web (partagée entre processus, conservée entre redémarrages)
+CREATE TABLE IF NOT EXISTS sessions (
+  sid VARCHAR(128) NOT NULL PRIMARY KEY,
+  data MEDIUMTEXT NOT NULL,
+  expires BIGINT UNSIGNED NOT NULL, -- Expiration en millisecondes epoch
+  
+  INDEX idx_expires (expires)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_unicode_ci;
\ No newline at end of file
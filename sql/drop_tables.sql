@@ -0,0 +1,6 @@
+-- Remise à zéro de la base MicroCoaster WebApp (développement uniquement)
+-- Exécution: au démarrage avec DB_RESET_ON_START=true, jamais sous le superviseur de déploiement
+
+-- Ordre important pour les FK
+DROP TABLE IF EXISTS modules;
+DROP TABLE IF EXISTS users;
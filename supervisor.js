@@ -0,0 +1,171 @@
+/**
+ * ============================================================================
+ * MICROCOASTER WEBAPP - DEPLOYMENT SUPERVISOR
+ * ============================================================================
+ * Redémarrage du serveur sans coupure des sessions ESP32
+ *
+ * Le superviseur possède le socket d'écoute (module cluster) et y fait tourner un seul
+ * processus app.js à la fois. Sur SIGHUP, il démarre le nouveau processus sur le même
+ * socket puis orchestre la passation :
+ *   1. le nouveau processus signale qu'il est prêt (handover:ready) ;
+ *   2. l'ancien cesse d'accepter des connexions, attend la réponse des commandes en vol
+ *      et exporte ses sessions ESP32 (handover:prepare -> handover:sessions) ;
+ *   3. le nouveau importe les sessions (handover:import -> handover:imported) ;
+ *   4. l'ancien remet un ticket de reprise à chaque module, ferme ses connexions et
+ *      s'arrête (handover:release) ; les modules se réauthentifient par ticket, sans bcrypt.
+ * Un échec avant l'étape 4 abandonne le nouveau processus : l'ancien reprend le service.
+ *
+ * Usage : npm run start:supervised, puis kill -HUP <pid du superviseur> pour déployer
+ *
+ * @module Supervisor
+ * @description Propriétaire du socket d'écoute et orchestrateur des redémarrages à chaud
+ * ============================================================================
+ */
+
+require('dotenv').config();
+
+const cluster = require('cluster');
+const path = require('path');
+const Logger = require('./utils/logger');
+
+/**
+ * Délais de la passation
+ * stepTimeoutMs couvre l'attente des commandes en vol du processus sortant
+ * @constant {Object}
+ */
+const SUPERVISOR = {
+  readyTimeoutMs: 30000,
+  stepTimeoutMs: 10000,
+  exitTimeoutMs: 10000,
+  restartDelayMs: 2000,
+};
+
+cluster.setupPrimary({ exec: path.join(__dirname, 'app.js') });
+
+let active = null; // Processus qui sert les clients
+let reloading = false;
+let stopping = false;
+
+/**
+ * Attend un message d'un processus serveur
+ * @param {Worker} worker - Processus attendu
+ * @param {string} type - Type de message attendu
+ * @param {number} timeoutMs - Attente maximum
+ * @returns {Promise<Object>} Message reçu
+ * @throws {Error} Si le processus s'arrête ou ne répond pas à temps
+ */
+function waitFor(worker, type, timeoutMs) {
+  return new Promise((resolve, reject) => {
+    const cleanup = () => {
+      clearTimeout(timer);
+      worker.off('message', onMessage);
+      worker.off('exit', onExit);
+    };
+    const onMessage = message => {
+      if (message?.type !== type) return;
+      cleanup();
+      resolve(message);
+    };
+    const onExit = code => {
+      cleanup();
+      reject(new Error(`process ${worker.process.pid} exited (code ${code}) before ${type}`));
+    };
+    const timer = setTimeout(() => {
+      cleanup();
+      reject(new Error(`${type} not received within ${timeoutMs} ms`));
+    }, timeoutMs);
+
+    worker.on('message', onMessage);
+    worker.on('exit', onExit);
+  });
+}
+
+/**
+ * Démarre un processus serveur
+ * Le processus actif qui s'arrête de lui-même est un crash : il est relancé à froid
+ * @returns {Worker} Processus démarré
+ */
+function start() {
+  const worker = cluster.fork();
+
+  worker.on('exit', (code, signal) => {
+    if (worker !== active || stopping) return;
+    Logger.app.error(
+      `💥 Server process ${worker.process.pid} exited (code ${code}, signal ${signal}) - restarting`
+    );
+    active = null;
+    setTimeout(() => {
+      if (!stopping && !active) active = start();
+    }, SUPERVISOR.restartDelayMs);
+  });
+
+  return worker;
+}
+
+/**
+ * Remplace le processus actif par un nouveau, sessions ESP32 comprises
+ * @returns {Promise<void>}
+ */
+async function reload() {
+  if (reloading || stopping || !active) return;
+  reloading = true;
+
+  const previous = active;
+  const next = start();
+  const startedAt = Date.now();
+  let sessions = [];
+  Logger.app.info(`🔀 Handover started: ${previous.process.pid} -> ${next.process.pid}`);
+
+  try {
+    await waitFor(next, 'handover:ready', SUPERVISOR.readyTimeoutMs);
+
+    previous.send({ type: 'handover:prepare' });
+    ({ sessions } = await waitFor(previous, 'handover:sessions', SUPERVISOR.stepTimeoutMs));
+
+    next.send({ type: 'handover:import', sessions });
+    await waitFor(next, 'handover:imported', SUPERVISOR.stepTimeoutMs);
+  } catch (error) {
+    Logger.app.error(`❌ Handover aborted, keeping process ${previous.process.pid}:`, error);
+    next.kill();
+    if (previous.isConnected()) previous.send({ type: 'handover:abort' });
+    reloading = false;
+    return;
+  }
+
+  active = next;
+  previous.send({ type: 'handover:release' });
+  const killTimer = setTimeout(() => previous.kill('SIGKILL'), SUPERVISOR.exitTimeoutMs);
+  previous.once('exit', () => clearTimeout(killTimer));
+
+  Logger.app.info(`✅ Handover completed in ${Date.now() - startedAt} ms`, {
+    sessions: sessions.length,
+  });
+  reloading = false;
+}
+
+/**
+ * Arrête le superviseur et ses processus serveur
+ * @param {string} signal - Signal reçu, transmis aux processus serveur
+ * @returns {void}
+ */
+function shutdown(signal) {
+  if (stopping) return;
+  stopping = true;
+  Logger.app.info(`🛑 ${signal} received - stopping server processes`);
+
+  cluster.on('exit', () => {
+    if (Object.keys(cluster.workers).length === 0) process.exit(0);
+  });
+  for (const worker of Object.values(cluster.workers)) worker.process.kill(signal);
+  setTimeout(() => process.exit(0), SUPERVISOR.exitTimeoutMs).unref();
+}
+
+active = start();
+
+process.on('SIGHUP', () => {
+  reload().catch(error => Logger.app.error('❌ Handover failed:', error));
+});
+process.on('SIGINT', () => shutdown('SIGINT'));
+process.on('SIGTERM', () => shutdown('SIGTERM'));
+
+Logger.app.info(`🧭 Supervisor ${process.pid} started - kill -HUP ${process.pid} to deploy`);
@@ -0,0 +1,335 @@
+/**
+ * Cache borné - LRU avec expiration et comptabilité mémoire
+ *
+ * Cache clé/valeur en mémoire limité en nombre d'entrées et en taille estimée,
+ * avec éviction LRU (moins récemment utilisé), durée de vie (TTL) par entrée
+ * et métriques d'utilisation (hits, misses, évictions, expirations).
+ *
+ * @module BoundedCache
+ * @description Cache mémoire borné avec éviction LRU, expiration TTL et métriques
+ */
+
+/**
+ * Estime grossièrement l'empreinte mémoire d'une valeur (en octets)
+ * Parcours superficiel (profondeur 2) pour rester peu coûteux sur les chemins chauds
+ * @param {*} value - Valeur à estimer
+ * @param {number} [depth=0] - Profondeur courante
+ * @returns {number} Taille estimée en octets
+ * @private
+ */
+function estimateSize(value, depth = 0) {
+  if (value === null || value === undefined) return 0;
+
+  switch (typeof value) {
+    case 'string':
+      return value.length * 2;
+    case 'number':
+      return 8;
+    case 'boolean':
+      return 4;
+    case 'object': {
+      if (value instanceof Date) return 8;
+      if (depth >= 2) return 64;
+      let size = 32;
+      for (const key of Object.keys(value)) {
+        size += key.length * 2 + estimateSize(value[key], depth + 1);
+      }
+      return size;
+    }
+    default:
+      return 16;
+  }
+}
+
+/**
+ * Cache LRU borné avec expiration
+ * S'appuie sur l'ordre d'insertion des Map : la première clé est la moins récemment utilisée
+ * @class BoundedCache
+ */
+class BoundedCache {
+  /**
+   * Crée une instance de cache borné
+   * @param {Object} [options={}] - Options de configuration
+   * @param {string} [options.name='cache'] - Nom du cache pour les métriques
+   * @param {number} [options.maxEntries=1000] - Nombre maximum d'entrées conservées
+   * @param {number} [options.maxBytes=0] - Taille estimée maximum en octets (0 = illimitée)
+   * @param {number} [options.ttlMs=0] - Durée de vie par défaut en ms (0 = sans expiration)
+   * @param {Function} [options.sizeOf] - Estimateur de taille (value, key) => octets
+   * @param {Function} [options.onEvict] - Callback (key, value, reason) à chaque retrait automatique
+   * @param {Function} [options.isPinned] - Prédicat (value, key) : entrée jamais évincée par LRU
+   *   (son expiration reste appliquée) ; les limites peuvent alors être dépassées
+   */
+  constructor(options = {}) {
+    this.name = options.name || 'cache';
+    this.maxEntries = options.maxEntries || 1000;
+    this.maxBytes = options.maxBytes || 0;
+    this.ttlMs = options.ttlMs || 0;
+    this.sizeOf = options.sizeOf || ((value, key) => key.length * 2 + estimateSize(value));
+    this.onEvict = options.onEvict || null;
+    this.isPinned = options.isPinned || null;
+
+    /**
+     * Entrées du cache
+     * @type {Map<string, Object>} key -> {value, expiresAt, size}
+     */
+    this.items = new Map();
+
+    /**
+     * Taille estimée totale des entrées en octets
+     * @type {number}
+     */
+    this.bytes = 0;
+
+    /**
+     * Compteurs d'utilisation
+     * @type {Object}
+     */
+    this.metrics = { hits: 0, misses: 0, sets: 0, evictions: 0, expirations: 0 };
+
+    this.pruneTimer = null;
+  }
+
+  /**
+   * Récupère une valeur et la marque comme récemment utilisée
+   * @param {string} key - Clé recherchée
+   * @returns {*} Valeur ou undefined si absente ou expirée
+   */
+  get(key) {
+    const item = this.items.get(key);
+    if (!item) {
+      this.metrics.misses++;
+      return undefined;
+    }
+
+    if (item.expiresAt && item.expiresAt <= Date.now()) {
+      this._remove(key, item, 'expired');
+      this.metrics.misses++;
+      return undefined;
+    }
+
+    // Remettre en fin de Map (position la plus récente)
+    this.items.delete(key);
+    this.items.set(key, item);
+    this.metrics.hits++;
+    return item.value;
+  }
+
+  /**
+   * Vérifie la présence d'une clé non expirée sans modifier l'ordre LRU
+   * @param {string} key - Clé recherchée
+   * @returns {boolean} True si la clé est présente et valide
+   */
+  has(key) {
+    const item = this.items.get(key);
+    return !!item && (!item.expiresAt || item.expiresAt > Date.now());
+  }
+
+  /**
+   * Ajoute ou remplace une valeur, avec éviction LRU si une limite est dépassée
+   * @param {string} key - Clé
+   * @param {*} value - Valeur à stocker
+   * @param {number} [ttlMs=this.ttlMs] - Durée de vie spécifique en ms (0 = sans expiration)
+   * @returns {BoundedCache} Instance courante
+   */
+  set(key, value, ttlMs = this.ttlMs) {
+    const previous = this.items.get(key);
+    if (previous) {
+      this.items.delete(key);
+      this.bytes -= previous.size;
+    }
+
+    const size = this.sizeOf(value, key);
+    this.items.set(key, {
+      value,
+      expiresAt: ttlMs > 0 ? Date.now() + ttlMs : 0,
+      size,
+    });
+    this.bytes += size;
+    this.metrics.sets++;
+
+    while (
+      this.items.size > 1 &&
+      (this.items.size > this.maxEntries || (this.maxBytes > 0 && this.bytes > this.maxBytes))
+    ) {
+      const oldestKey = this._evictionCandidate();
+      if (oldestKey === undefined) break; // Uniquement des entrées épinglées
+      this._remove(oldestKey, this.items.get(oldestKey), 'evicted');
+    }
+
+    return this;
+  }
+
+  /**
+   * Clé la moins récemment utilisée pouvant être évincée
+   * @returns {string|undefined} Clé, ou undefined si toutes les entrées sont épinglées
+   * @private
+   */
+  _evictionCandidate() {
+    if (!this.isPinned) return this.items.keys().next().value;
+
+    for (const [key, item] of this.items) {
+      if (!this.isPinned(item.value, key)) return key;
+    }
+    return undefined;
+  }
+
+  /**
+   * Supprime une entrée
+   * @param {string} key - Clé à supprimer
+   * @returns {boolean} True si une entrée a été supprimée
+   */
+  delete(key) {
+    const item = this.items.get(key);
+    if (!item) return false;
+
+    this.items.delete(key);
+    this.bytes -= item.size;
+    return true;
+  }
+
+  /**
+   * Retire une entrée automatiquement (expiration ou éviction) et met à jour les métriques
+   * @param {string} key - Clé retirée
+   * @param {Object} item - Entrée interne
+   * @param {string} reason - 'expired' ou 'evicted'
+   * @private
+   */
+  _remove(key, item, reason) {
+    this.items.delete(key);
+    this.bytes -= item.size;
+
+    if (reason === 'expired') {
+      this.metrics.expirations++;
+    } else {
+      this.metrics.evictions++;
+    }
+
+    if (this.onEvict) {
+      this.onEvict(key, item.value, reason);
+    }
+  }
+
+  /**
+   * Supprime les entrées expirées
+   * @returns {number} Nombre d'entrées supprimées
+   */
+  prune() {
+    const now = Date.now();
+    let removed = 0;
+
+    for (const [key, item] of this.items) {
+      if (item.expiresAt && item.expiresAt <= now) {
+        this._remove(key, item, 'expired');
+        removed++;
+      }
+    }
+
+    return removed;
+  }
+
+  /**
+   * Démarre la purge périodique des entrées expirées (timer non bloquant pour l'arrêt du process)
+   * @param {number} intervalMs - Intervalle entre deux purges en ms
+   * @returns {BoundedCache} Instance courante
+   */
+  startPruning(intervalMs) {
+    this.stopPruning();
+    this.pruneTimer = setInterval(() => this.prune(), intervalMs);
+    this.pruneTimer.unref?.();
+    return this;
+  }
+
+  /**
+   * Arrête la purge périodique
+   * @returns {void}
+   */
+  stopPruning() {
+    if (this.pruneTimer) {
+      clearInterval(this.pruneTimer);
+      this.pruneTimer = null;
+    }
+  }
+
+  /**
+   * Itère sur les entrées non expirées sans modifier l'ordre LRU
+   * @yields {Array} [key, value]
+   */
+  *entries() {
+    const now = Date.now();
+    for (const [key, item] of this.items) {
+      if (!item.expiresAt || item.expiresAt > now) {
+        yield [key, item.value];
+      }
+    }
+  }
+
+  /**
+   * Itère sur les clés non expirées
+   * @yields {string} Clé
+   */
+  *keys() {
+    for (const [key] of this.entries()) yield key;
+  }
+
+  /**
+   * Itère sur les valeurs non expirées
+   * @yields {*} Valeur
+   */
+  *values() {
+    for (const [, value] of this.entries()) yield value;
+  }
+
+  /**
+   * Exécute une fonction pour chaque entrée non expirée (signature compatible Map)
+   * @param {Function} callback - callback(value, key)
+   * @returns {void}
+   */
+  forEach(callback) {
+    for (const [key, value] of this.entries()) {
+      callback(value, key);
+    }
+  }
+
+  [Symbol.iterator]() {
+    return this.entries();
+  }
+
+  /**
+   * Vide complètement le cache
+   * @returns {void}
+   */
+  clear() {
+    this.items.clear();
+    this.bytes = 0;
+  }
+
+  /**
+   * Nombre d'entrées actuellement en cache (expirées non purgées incluses)
+   * @type {number}
+   */
+  get size() {
+    return this.items.size;
+  }
+
+  /**
+   * Récupère les métriques du cache
+   * @returns {Object} Statistiques d'occupation et d'utilisation
+   * @returns {number} returns.entries - Nombre d'entrées
+   * @returns {number} returns.bytes - Taille estimée en octets
+   * @returns {number} returns.hitRate - Ratio hits / (hits + misses)
+   */
+  getStats() {
+    const lookups = this.metrics.hits + this.metrics.misses;
+    return {
+      name: this.name,
+      entries: this.items.size,
+      maxEntries: this.maxEntries,
+      bytes: this.bytes,
+      maxBytes: this.maxBytes,
+      ...this.metrics,
+      hitRate: lookups > 0 ? this.metrics.hits / lookups : 0,
+    };
+  }
+}
+
+module.exports = BoundedCache;
@@ -0,0 +1,168 @@
+/**
+ * Résumés de télémétrie - Agrégats statistiques fusionnables
+ *
+ * Décodage et fusion des résumés statistiques calculés par les modules ESP32 :
+ * compteurs entiers (n, min, max, somme, somme des carrés) et histogramme
+ * log-linéaire de type HDR (4 sous-intervalles par puissance de 2, erreur relative ≤ 25 %).
+ * Tous les champs sont additifs : fusionner deux résumés coûte O(nombre d'intervalles).
+ *
+ * @module TelemetrySummary
+ * @description Fusion et lecture (moyenne, écart-type, quantiles) des résumés de télémétrie
+ */
+
+/**
+ * Nombre de bits de précision par puissance de 2 (doit correspondre au firmware)
+ * @constant {number}
+ */
+const SUB_BUCKET_BITS = 2;
+const SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+/**
+ * Nombre d'intervalles de l'histogramme pour des valeurs sur 32 bits
+ * @constant {number}
+ */
+const HISTOGRAM_BUCKETS = (32 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+/**
+ * Quantiles calculés par describe()
+ * @constant {Array<number>}
+ */
+const QUANTILES = [0.5, 0.9, 0.99];
+
+/**
+ * Borne inférieure d'un intervalle de l'histogramme
+ * @param {number} index - Index de l'intervalle
+ * @returns {number} Plus petite valeur entière contenue dans l'intervalle
+ */
+function bucketLowerBound(index) {
+  if (index < SUB_BUCKETS) return index;
+  const magnitude = Math.floor(index / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+  const sub = index % SUB_BUCKETS;
+  return (SUB_BUCKETS + sub) * 2 ** (magnitude - SUB_BUCKET_BITS);
+}
+
+/**
+ * Crée un résumé vide
+ * @param {boolean} [negated=false] - Histogramme construit sur l'opposé des valeurs (ex: RSSI)
+ * @returns {Object} Résumé {n, min, max, sum, sq, buckets, neg}
+ */
+function createSummary(negated = false) {
+  return { n: 0, min: 0, max: 0, sum: 0, sq: 0, buckets: new Map(), neg: negated };
+}
+
+/**
+ * Convertit un résumé reçu d'un module (format filaire) en résumé interne
+ * @param {Object} wire - Résumé {n, min, max, sum, sq, h: [[index, count], ...], neg}
+ * @returns {Object|null} Résumé interne ou null si invalide
+ */
+function fromWire(wire) {
+  if (!wire || !Number.isInteger(wire.n) || wire.n <= 0) return null;
+
+  const summary = createSummary(!!wire.neg);
+  summary.n = wire.n;
+  summary.min = Number(wire.min) || 0;
+  summary.max = Number(wire.max) || 0;
+  summary.sum = Number(wire.sum) || 0;
+  summary.sq = Number(wire.sq) || 0;
+
+  if (Array.isArray(wire.h)) {
+    for (const pair of wire.h) {
+      const [index, count] = Array.isArray(pair) ? pair : [];
+      if (Number.isInteger(index) && index >= 0 && index < HISTOGRAM_BUCKETS && count > 0) {
+        summary.buckets.set(index, (summary.buckets.get(index) || 0) + count);
+      }
+    }
+  }
+
+  return summary;
+}
+
+/**
+ * Fusionne un résumé dans un autre (modifie target)
+ * @param {Object} target - Résumé accumulateur
+ * @param {Object} source - Résumé à ajouter
+ * @returns {Object} target
+ */
+function mergeSummary(target, source) {
+  if (!source || source.n === 0) return target;
+
+  if (target.n === 0) {
+    target.min = source.min;
+    target.max = source.max;
+    target.neg = source.neg;
+  } else {
+    target.min = Math.min(target.min, source.min);
+    target.max = Math.max(target.max, source.max);
+  }
+
+  target.n += source.n;
+  target.sum += source.sum;
+  target.sq += source.sq;
+  for (const [index, count] of source.buckets) {
+    target.buckets.set(index, (target.buckets.get(index) || 0) + count);
+  }
+
+  return target;
+}
+
+/**
+ * Estime un quantile depuis l'histogramme
+ * @param {Object} summary - Résumé
+ * @param {number} q - Quantile entre 0 et 1
+ * @returns {number|null} Valeur estimée (borne de l'intervalle, ramenée dans [min, max])
+ * @private
+ */
+function quantile(summary, q) {
+  const total = Array.from(summary.buckets.values()).reduce((acc, count) => acc + count, 0);
+  if (total === 0) return null;
+
+  // Histogramme construit sur l'opposé : le quantile q des valeurs est le (1 - q) des opposés
+  const rank = Math.ceil((summary.neg ? 1 - q : q) * total);
+  const indexes = Array.from(summary.buckets.keys()).sort((a, b) => a - b);
+
+  let seen = 0;
+  for (const index of indexes) {
+    seen += summary.buckets.get(index);
+    if (seen >= Math.max(rank, 1)) {
+      const bound = summary.neg ? -bucketLowerBound(index) : bucketLowerBound(index);
+      return Math.min(Math.max(bound, summary.min), summary.max);
+    }
+  }
+  return null;
+}
+
+/**
+ * Calcule les statistiques lisibles d'un résumé
+ * @param {Object} summary - Résumé
+ * @returns {Object} {count, min, max, mean, stddev, p50, p90, p99}
+ */
+function describe(summary) {
+  if (!summary || summary.n === 0) {
+    return { count: 0 };
+  }
+
+  const mean = summary.sum / summary.n;
+  const variance = Math.max(summary.sq / summary.n - mean * mean, 0);
+  const stats = {
+    count: summary.n,
+    min: summary.min,
+    max: summary.max,
+    mean: Math.round(mean * 100) / 100,
+    stddev: Math.round(Math.sqrt(variance) * 100) / 100,
+  };
+
+  for (const q of QUANTILES) {
+    stats[`p${Math.round(q * 100)}`] = quantile(summary, q);
+  }
+
+  return stats;
+}
+
+module.exports = {
+  HISTOGRAM_BUCKETS,
+  bucketLowerBound,
+  createSummary,
+  fromWire,
+  mergeSummary,
+  describe,
+};
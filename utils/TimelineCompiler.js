@@ -0,0 +1,322 @@
+/**
+ * Compilateur de timelines - Bytecode binaire pour le firmware des modules
+ *
+ * Transforme une séquence de l'éditeur de timelines en un programme binaire par
+ * module : en-tête versionné, pas à taille fixe par opcode et CRC-32 final.
+ * Le firmware valide le programme une seule fois au chargement, puis l'exécute
+ * pas à pas avec des offsets absolus (aucune dérive cumulée, mémoire bornée).
+ *
+ * Format (petit-boutiste) :
+ *   en-tête  "MCTL" | version u8 | type de module u8 | nombre de pas u16 | durée totale ms u32
+ *   pas      offset ms u32 | opcode u8 | durée ms u16 | opérandes (taille fixe par opcode)
+ *   fin      CRC-32 (IEEE) u32 de tous les octets précédents
+ *
+ * @module TimelineCompiler
+ * @description Compilation des séquences de timeline en bytecode module versionné et contrôlé
+ */
+
+/**
+ * Version du format de bytecode (doit correspondre au firmware)
+ * @constant {number}
+ */
+const BYTECODE_VERSION = 1;
+
+const MAGIC = Buffer.from('MCTL', 'ascii');
+const HEADER_BYTES = 12;
+const STEP_HEADER_BYTES = 7;
+const CRC_BYTES = 4;
+
+/**
+ * Taille maximale d'un programme (tampon statique du firmware)
+ * @constant {number}
+ */
+const MAX_PROGRAM_BYTES = 1024;
+
+/**
+ * Durée maximale d'un pas (champ u16)
+ * @constant {number}
+ */
+const MAX_STEP_DURATION_MS = 0xffff;
+
+/**
+ * Types de module reconnus par le firmware (octet d'en-tête)
+ * @constant {Object}
+ */
+const MODULE_KINDS = {
+  'generic-module': 0,
+  'estop-button': 1,
+  'switch-track': 2,
+  'speed-control': 3,
+  'led-control': 4,
+};
+
+/**
+ * Noms affichés / suffixes d'ID vers type de timeline
+ * @constant {Object}
+ */
+const KIND_ALIASES = {
+  'emergency stop': 'estop-button',
+  'switch track': 'switch-track',
+  'speed control': 'speed-control',
+  'launch track': 'speed-control',
+  'led control': 'led-control',
+  'light fx': 'led-control',
+};
+
+/**
+ * Opcodes et opérandes par type de module
+ * Chaque opérande : [nom du paramètre, taille en octets, encodeur]
+ * @constant {Object}
+ */
+const OPCODES = {
+  END: 0x00,
+  ESTOP_ACTIVATE: 0x10, // 0x11 (ancien ESTOP_DEACTIVATE) refusé par le firmware
+  SWITCH_LEFT: 0x20,
+  SWITCH_RIGHT: 0x21,
+  SET_SPEED: 0x30,
+  RAMP_SPEED: 0x31,
+  LED_ON: 0x40,
+  LED_OFF: 0x41,
+  LED_BLINK: 0x42,
+  ACTIVATE: 0x50,
+  DEACTIVATE: 0x51,
+};
+
+const percent = (value, fallback) => clamp(Math.round(Number(value ?? fallback)), 0, 100);
+const seconds = (value, fallback) =>
+  clamp(Math.round(Number(value ?? fallback) * 1000), 0, MAX_STEP_DURATION_MS);
+
+/**
+ * Table de compilation : type de module -> action -> {opcode, operands}
+ * Les valeurs par défaut reprennent MODULE_CONFIGS de l'éditeur (public/js/timelines.js)
+ * @constant {Object}
+ */
+const ACTIONS = {
+  'estop-button': {
+    activate: {
+      opcode: OPCODES.ESTOP_ACTIVATE,
+      operands: [['force_stop', 1, v => (v === false ? 0 : 1)]],
+    },
+    // Pas de deactivate : une timeline ne lève jamais un arrêt d'urgence (réarmement opérateur)
+  },
+  'switch-track': {
+    switch_left: {
+      opcode: OPCODES.SWITCH_LEFT,
+      operands: [['speed', 1, v => clamp(percent(v, 50), 1, 100)]],
+    },
+    switch_right: {
+      opcode: OPCODES.SWITCH_RIGHT,
+      operands: [['speed', 1, v => clamp(percent(v, 50), 1, 100)]],
+    },
+  },
+  'speed-control': {
+    set_speed: { opcode: OPCODES.SET_SPEED, operands: [['target_speed', 1, v => percent(v, 50)]] },
+    gradual_change: {
+      opcode: OPCODES.RAMP_SPEED,
+      operands: [
+        ['from_speed', 1, v => percent(v, 30)],
+        ['to_speed', 1, v => percent(v, 70)],
+      ],
+    },
+  },
+  'led-control': {
+    turn_on: {
+      opcode: OPCODES.LED_ON,
+      operands: [
+        ['brightness', 1, v => percent(v, 100)],
+        ['color', 3, v => parseColor(v)],
+      ],
+    },
+    turn_off: { opcode: OPCODES.LED_OFF, operands: [] },
+    blink: {
+      opcode: OPCODES.LED_BLINK,
+      operands: [
+        ['on_time', 2, v => seconds(v, 0.5)],
+        ['off_time', 2, v => seconds(v, 0.5)],
+      ],
+    },
+  },
+  'generic-module': {
+    activate: { opcode: OPCODES.ACTIVATE, operands: [['power', 1, v => percent(v, 100)]] },
+    deactivate: { opcode: OPCODES.DEACTIVATE, operands: [] },
+  },
+};
+
+/**
+ * Borne une valeur numérique
+ * @param {number} value - Valeur
+ * @param {number} min - Minimum
+ * @param {number} max - Maximum
+ * @returns {number} Valeur bornée (min si NaN)
+ * @private
+ */
+function clamp(value, min, max) {
+  return Number.isFinite(value) ? Math.min(Math.max(value, min), max) : min;
+}
+
+/**
+ * Convertit une couleur #rrggbb en triplet d'octets
+ * @param {string} value - Couleur hexadécimale
+ * @returns {Array<number>} [r, g, b] (blanc si invalide)
+ * @private
+ */
+function parseColor(value) {
+  const match = /^#?([0-9a-f]{6})$/i.exec(String(value ?? ''));
+  const rgb = match ? parseInt(match[1], 16) : 0xffffff;
+  return [(rgb >> 16) & 0xff, (rgb >> 8) & 0xff, rgb & 0xff];
+}
+
+const CRC_TABLE = (() => {
+  const table = new Uint32Array(256);
+  for (let n = 0; n < 256; n++) {
+    let c = n;
+    for (let k = 0; k < 8; k++) {
+      c = c & 1 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+    }
+    table[n] = c >>> 0;
+  }
+  return table;
+})();
+
+/**
+ * CRC-32 IEEE (même polynôme que le firmware)
+ * @param {Buffer} buffer - Données
+ * @returns {number} CRC non signé
+ */
+function crc32(buffer) {
+  let crc = 0xffffffff;
+  for (const byte of buffer) {
+    crc = CRC_TABLE[(crc ^ byte) & 0xff] ^ (crc >>> 8);
+  }
+  return (crc ^ 0xffffffff) >>> 0;
+}
+
+/**
+ * Résout le type de timeline d'un module (clé MODULE_CONFIGS, nom affiché ou suffixe d'ID)
+ * @param {string} type - Type déclaré du module
+ * @param {string} [moduleId=''] - ID du module (ex: MC-0001-ST)
+ * @returns {string} Clé de MODULE_KINDS
+ */
+function resolveModuleKind(type, moduleId = '') {
+  const key = String(type || '')
+    .trim()
+    .toLowerCase();
+  if (key in MODULE_KINDS) return key;
+  if (key in KIND_ALIASES) return KIND_ALIASES[key];
+
+  const id = String(moduleId).toUpperCase();
+  if (id.endsWith('-ES')) return 'estop-button';
+  if (id.endsWith('-ST')) return 'switch-track';
+  if (id.endsWith('-LT')) return 'speed-control';
+  if (id.endsWith('-LFX')) return 'led-control';
+  return 'generic-module';
+}
+
+/**
+ * Compile les actions d'un module en programme binaire
+ * @param {string} kind - Type de timeline du module (clé MODULE_KINDS)
+ * @param {Array<Object>} actions - [{startTime (s), action, parameters, duration (s)}]
+ * @returns {Object} {program: Buffer, kind, steps, totalMs, crc}
+ * @throws {Error} Action inconnue pour ce type ou programme trop volumineux
+ */
+function compileModuleProgram(kind, actions) {
+  const table = ACTIONS[kind];
+  if (!table) throw new Error(`Unknown module kind: ${kind}`);
+
+  // Tri stable par offset : deux actions au même instant gardent l'ordre de l'éditeur
+  const steps = actions
+    .map((entry, index) => {
+      const spec = table[entry.action];
+      if (!spec) throw new Error(`Action ${entry.action} not supported by ${kind}`);
+      return {
+        spec,
+        index,
+        atMs: Math.round(Math.max(Number(entry.startTime) || 0, 0) * 1000),
+        durationMs: seconds(entry.duration, 0),
+        parameters: entry.parameters || {},
+      };
+    })
+    .sort((a, b) => a.atMs - b.atMs || a.index - b.index);
+
+  const totalMs = steps.reduce((end, step) => Math.max(end, step.atMs + step.durationMs), 0);
+  const operandBytes = steps.reduce(
+    (size, step) => size + step.spec.operands.reduce((acc, [, width]) => acc + width, 0),
+    0
+  );
+  const length =
+    HEADER_BYTES + (steps.length + 1) * STEP_HEADER_BYTES + operandBytes + CRC_BYTES;
+
+  if (length > MAX_PROGRAM_BYTES) {
+    throw new Error(`Program too large: ${length} bytes (max ${MAX_PROGRAM_BYTES})`);
+  }
+
+  const program = Buffer.alloc(length);
+  MAGIC.copy(program, 0);
+  program.writeUInt8(BYTECODE_VERSION, 4);
+  program.writeUInt8(MODULE_KINDS[kind], 5);
+  program.writeUInt16LE(steps.length + 1, 6);
+  program.writeUInt32LE(totalMs, 8);
+
+  let offset = HEADER_BYTES;
+  const writeStep = (atMs, opcode, durationMs) => {
+    program.writeUInt32LE(atMs, offset);
+    program.writeUInt8(opcode, offset + 4);
+    program.writeUInt16LE(durationMs, offset + 5);
+    offset += STEP_HEADER_BYTES;
+  };
+
+  for (const step of steps) {
+    writeStep(step.atMs, step.spec.opcode, step.durationMs);
+    for (const [name, width, encode] of step.spec.operands) {
+      const value = encode(step.parameters[name]);
+      if (Array.isArray(value)) {
+        value.forEach((byte, i) => program.writeUInt8(byte, offset + i));
+      } else if (width === 2) {
+        program.writeUInt16LE(value, offset);
+      } else {
+        program.writeUInt8(value, offset);
+      }
+      offset += width;
+    }
+  }
+  writeStep(totalMs, OPCODES.END, 0);
+
+  const crc = crc32(program.subarray(0, offset));
+  program.writeUInt32LE(crc, offset);
+
+  return { program, kind, steps: steps.length, totalMs, crc };
+}
+
+/**
+ * Compile une séquence complète de l'éditeur, un programme par module
+ * Les modules en erreur sont signalés sans bloquer les autres
+ * @param {Object} sequence - {modules: {moduleId: [actions]}} (format generateSequence)
+ * @param {Function} kindOf - (moduleId) => type de timeline du module
+ * @returns {Object} {programs: Map<moduleId, résultat>, errors: Array<{moduleId, error}>}
+ */
+function compileSequence(sequence, kindOf) {
+  const programs = new Map();
+  const errors = [];
+
+  for (const [moduleId, actions] of Object.entries(sequence?.modules || {})) {
+    if (!Array.isArray(actions) || actions.length === 0) continue;
+    try {
+      programs.set(moduleId, compileModuleProgram(kindOf(moduleId), actions));
+    } catch (error) {
+      errors.push({ moduleId, error: error.message });
+    }
+  }
+
+  return { programs, errors };
+}
+
+module.exports = {
+  BYTECODE_VERSION,
+  MAX_PROGRAM_BYTES,
+  MODULE_KINDS,
+  OPCODES,
+  crc32,
+  resolveModuleKind,
+  compileModuleProgram,
+  compileSequence,
+};
@@ -0,0 +1,132 @@
+/**
+ * Journal d'événements par utilisateur - Anneau séquencé pour la reprise des clients
+ *
+ * Chaque utilisateur possède un anneau de taille fixe des derniers événements qui lui
+ * ont été émis, numérotés par une séquence strictement croissante. Un navigateur qui
+ * se reconnecte présente sa dernière séquence et ne reçoit que les événements manqués ;
+ * un instantané complet n'est nécessaire que si l'écart dépasse l'anneau.
+ *
+ * @module UserEventLog
+ * @description Anneau borné d'événements séquencés par utilisateur (reprise par delta)
+ */
+
+const crypto = require('crypto');
+const BoundedCache = require('./BoundedCache');
+
+/**
+ * Limites du journal
+ * capacity : événements conservés par utilisateur ; journal inactif expiré après idleTtlMs
+ * @constant {Object}
+ */
+const USER_EVENT_LOG = {
+  capacity: 256,
+  maxUsers: 10000,
+  idleTtlMs: 30 * 60 * 1000,
+  pruneIntervalMs: 5 * 60 * 1000,
+  entryBytes: 512,
+};
+
+/**
+ * Journal d'événements séquencés par utilisateur
+ * @class UserEventLog
+ */
+class UserEventLog {
+  /**
+   * Crée le journal
+   * @param {Object} [options={}] - Options de configuration
+   * @param {number} [options.capacity=256] - Événements conservés par utilisateur
+   * @param {number} [options.maxUsers=10000] - Journaux conservés au maximum
+   * @param {number} [options.idleTtlMs=1800000] - Durée de vie d'un journal sans événement
+   */
+  constructor(options = {}) {
+    this.capacity = options.capacity || USER_EVENT_LOG.capacity;
+    const footprint = this.capacity * USER_EVENT_LOG.entryBytes;
+
+    /**
+     * Journaux par utilisateur
+     * @type {BoundedCache} String(userId) -> {epoch, seq, entries: Array<{seq, event, data}>}
+     */
+    this.logs = new BoundedCache({
+      name: 'userEventLog',
+      maxEntries: options.maxUsers || USER_EVENT_LOG.maxUsers,
+      ttlMs: options.idleTtlMs || USER_EVENT_LOG.idleTtlMs,
+      sizeOf: () => footprint,
+    }).startPruning(USER_EVENT_LOG.pruneIntervalMs);
+  }
+
+  /**
+   * Récupère le journal d'un utilisateur, créé à la demande
+   * Un nouveau journal reçoit une nouvelle époque : les séquences d'un journal expiré
+   * ou d'un serveur redémarré ne peuvent pas être confondues avec les siennes
+   * @param {number|string} userId - Identifiant de l'utilisateur
+   * @returns {Object} Journal {epoch, seq, entries}
+   * @private
+   */
+  _ensure(userId) {
+    const key = String(userId);
+    let log = this.logs.get(key);
+    if (!log) {
+      log = { epoch: crypto.randomUUID(), seq: 0, entries: new Array(this.capacity) };
+      this.logs.set(key, log);
+    }
+    return log;
+  }
+
+  /**
+   * Ajoute un événement au journal d'un utilisateur
+   * @param {number|string} userId - Identifiant de l'utilisateur
+   * @param {string} event - Nom de l'événement
+   * @param {Object} data - Données émises
+   * @returns {number} Séquence attribuée
+   */
+  append(userId, event, data) {
+    const log = this._ensure(userId);
+    log.seq++;
+    log.entries[log.seq % this.capacity] = { seq: log.seq, event, data };
+    // Réinsertion : repousse l'expiration du journal d'un utilisateur actif
+    this.logs.set(String(userId), log);
+    return log.seq;
+  }
+
+  /**
+   * Position courante du journal d'un utilisateur
+   * @param {number|string} userId - Identifiant de l'utilisateur
+   * @returns {Object} {epoch, seq}
+   */
+  position(userId) {
+    const log = this._ensure(userId);
+    return { epoch: log.epoch, seq: log.seq };
+  }
+
+  /**
+   * Événements postérieurs à une séquence donnée
+   * @param {number|string} userId - Identifiant de l'utilisateur
+   * @param {string} epoch - Époque connue du client
+   * @param {number} seq - Dernière séquence reçue par le client
+   * @returns {Object[]|null} Entrées {seq, event, data} dans l'ordre, ou null si la reprise
+   *   est impossible (époque différente, séquence inconnue ou écart supérieur à l'anneau)
+   */
+  since(userId, epoch, seq) {
+    const log = this.logs.get(String(userId));
+    if (!log || log.epoch !== epoch || !Number.isInteger(seq) || seq < 0 || seq > log.seq) {
+      return null;
+    }
+    if (log.seq - seq > this.capacity) return null;
+
+    const missed = [];
+    for (let next = seq + 1; next <= log.seq; next++) {
+      missed.push(log.entries[next % this.capacity]);
+    }
+    return missed;
+  }
+
+  /**
+   * Statistiques du journal
+   * @returns {Object} {users, capacity, cache}
+   */
+  getStats() {
+    return { users: this.logs.size, capacity: this.capacity, cache: this.logs.getStats() };
+  }
+}
+
+module.exports = UserEventLog;
@@ -0,0 +1,227 @@
+/**
+ * Contrôle d'admission ESP32 - Protection du serveur sous surcharge
+ *
+ * Surveille le retard de la boucle d'événements, les authentifications en cours
+ * et la file d'attente du pool MySQL. Sous surcharge, les nouvelles sessions
+ * modules sont différées avec un délai de reconnexion (jamais une reprise par
+ * ticket après passation), et les trames de faible
+ * priorité (télémétrie, puis heartbeats) sont délestées avant les commandes.
+ *
+ * @module AdmissionController
+ * @description Contrôle d'admission et délestage des trames pour le serveur /esp32
+ */
+
+const { monitorEventLoopDelay } = require('perf_hooks');
+const Logger = require('../utils/logger');
+
+/**
+ * Niveaux de charge du serveur
+ * @constant {Object}
+ */
+const LOAD_LEVELS = {
+  NORMAL: 0,
+  DEGRADED: 1,
+  OVERLOADED: 2,
+};
+
+const LEVEL_NAMES = ['normal', 'degraded', 'overloaded'];
+
+/**
+ * Seuils par défaut du contrôle d'admission
+ * @constant {Object}
+ */
+const ADMISSION = {
+  sampleIntervalMs: 1000,
+  loopResolutionMs: 20, // Période du minuteur de mesure, déduite des retards mesurés
+  degradedLagMs: 50, // p99 du retard de boucle d'événements
+  overloadedLagMs: 200,
+  degradedPoolQueue: 5, // Requêtes MySQL en attente d'une connexion
+  overloadedPoolQueue: 20,
+  maxPendingAuth: 20, // Authentifications complètes (bcrypt) en cours
+  recoverySamples: 3, // Échantillons calmes consécutifs avant de baisser d'un niveau
+  retryAfterMinMs: 5000,
+  retryAfterMaxMs: 30000,
+};
+
+/**
+ * Niveau de charge à partir duquel chaque type de trame est délesté
+ * Les types absents (commandes, identification, pong) ne sont jamais délestés
+ * @constant {Object}
+ */
+const SHED_FROM_LEVEL = {
+  telemetry: LOAD_LEVELS.DEGRADED,
+  heartbeat: LOAD_LEVELS.OVERLOADED,
+};
+
+/**
+ * Contrôleur d'admission des connexions et trames ESP32
+ * @class AdmissionController
+ */
+class AdmissionController {
+  /**
+   * Crée une instance du contrôleur
+   * @param {Function} getPoolStats - () => {queued} occupation du pool MySQL
+   * @param {Object} [options={}] - Surcharge des seuils ADMISSION
+   */
+  constructor(getPoolStats, options = {}) {
+    this.getPoolStats = getPoolStats;
+    this.config = { ...ADMISSION, ...options };
+
+    this.level = LOAD_LEVELS.NORMAL;
+    this.calmSamples = 0;
+    this.pendingAuth = 0;
+    this.lastSample = { lagMs: 0, poolQueued: 0 };
+
+    /**
+     * Compteurs de décisions
+     * @type {Object}
+     */
+    this.metrics = { admitted: 0, deferred: 0, shed: {} };
+
+    this.histogram = monitorEventLoopDelay({ resolution: this.config.loopResolutionMs });
+    this.sampleTimer = null;
+  }
+
+  /**
+   * Démarre la surveillance de la charge
+   * @returns {AdmissionController} Instance courante
+   */
+  start() {
+    this.histogram.enable();
+    this.sampleTimer = setInterval(() => this.sample(), this.config.sampleIntervalMs);
+    this.sampleTimer.unref?.();
+    return this;
+  }
+
+  /**
+   * Arrête la surveillance de la charge
+   * @returns {void}
+   */
+  stop() {
+    this.histogram.disable();
+    if (this.sampleTimer) {
+      clearInterval(this.sampleTimer);
+      this.sampleTimer = null;
+    }
+  }
+
+  /**
+   * Mesure la charge sur la dernière fenêtre et met à jour le niveau
+   * Montée immédiate, descente d'un niveau après recoverySamples mesures calmes
+   * @returns {number} Niveau de charge courant
+   */
+  sample() {
+    const p99Ms = this.histogram.count > 0 ? this.histogram.percentile(99) / 1e6 : 0;
+    const lagMs = Math.max(0, p99Ms - this.config.loopResolutionMs);
+    this.histogram.reset();
+
+    let poolQueued = 0;
+    try {
+      poolQueued = this.getPoolStats()?.queued || 0;
+    } catch {
+      poolQueued = 0;
+    }
+    this.lastSample = { lagMs: Math.round(lagMs), poolQueued };
+
+    const { config } = this;
+    let measured = LOAD_LEVELS.NORMAL;
+    if (lagMs >= config.overloadedLagMs || poolQueued >= config.overloadedPoolQueue) {
+      measured = LOAD_LEVELS.OVERLOADED;
+    } else if (lagMs >= config.degradedLagMs || poolQueued >= config.degradedPoolQueue) {
+      measured = LOAD_LEVELS.DEGRADED;
+    }
+
+    if (measured > this.level) {
+      this.setLevel(measured);
+    } else if (measured < this.level) {
+      this.calmSamples++;
+      if (this.calmSamples >= config.recoverySamples) {
+        this.setLevel(this.level - 1);
+      }
+    } else {
+      this.calmSamples = 0;
+    }
+
+    return this.level;
+  }
+
+  /**
+   * Change le niveau de charge et journalise la transition
+   * @param {number} level - Nouveau niveau
+   * @private
+   */
+  setLevel(level) {
+    const previous = this.level;
+    this.level = level;
+    this.calmSamples = 0;
+
+    const message = `🚦 ESP32 load ${LEVEL_NAMES[previous]} -> ${LEVEL_NAMES[level]}`;
+    const details = { ...this.lastSample, pendingAuth: this.pendingAuth, shed: this.metrics.shed };
+    if (level > previous) {
+      Logger.esp.warn(message, details);
+    } else {
+      Logger.esp.info(message, details);
+    }
+  }
+
+  /**
+   * Décide de l'admission d'une authentification complète (module_identify sans ticket de reprise)
+   * Une authentification admise compte comme en cours jusqu'à authSettled()
+   * @returns {Object} {admitted: boolean, retryAfterMs?: number}
+   */
+  tryAdmit() {
+    if (this.level >= LOAD_LEVELS.OVERLOADED || this.pendingAuth >= this.config.maxPendingAuth) {
+      this.metrics.deferred++;
+      const { retryAfterMinMs, retryAfterMaxMs } = this.config;
+      // Délai aléatoire pour étaler les reconnexions de la flotte
+      const retryAfterMs = Math.round(
+        retryAfterMinMs + Math.random() * (retryAfterMaxMs - retryAfterMinMs)
+      );
+      return { admitted: false, retryAfterMs };
+    }
+
+    this.pendingAuth++;
+    this.metrics.admitted++;
+    return { admitted: true };
+  }
+
+  /**
+   * Signale la fin d'une authentification en cours (succès, échec ou fermeture)
+   * @returns {void}
+   */
+  authSettled() {
+    this.pendingAuth = Math.max(0, this.pendingAuth - 1);
+  }
+
+  /**
+   * Indique si une trame doit être délestée au niveau de charge courant
+   * @param {string} type - Type de message ESP32
+   * @returns {boolean} True si la trame doit être ignorée
+   */
+  shouldShed(type) {
+    const fromLevel = SHED_FROM_LEVEL[type];
+    if (fromLevel === undefined || this.level < fromLevel) return false;
+
+    this.metrics.shed[type] = (this.metrics.shed[type] || 0) + 1;
+    return true;
+  }
+
+  /**
+   * Récupère l'état du contrôle d'admission
+   * @returns {Object} Niveau, dernière mesure et compteurs
+   */
+  getStats() {
+    return {
+      level: LEVEL_NAMES[this.level],
+      ...this.lastSample,
+      pendingAuth: this.pendingAuth,
+      admitted: this.metrics.admitted,
+      deferred: this.metrics.deferred,
+      shed: { ...this.metrics.shed },
+    };
+  }
+}
+
+AdmissionController.LOAD_LEVELS = LOAD_LEVELS;
+
+module.exports = AdmissionController;
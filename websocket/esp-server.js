@@ -8,9 +8,78 @@
  * @description Serveur WebSocket natif pour la communication avec les modules ESP32
  */
 
+const crypto = require('crypto');
 const WebSocket = require('ws');
 const Logger = require('../utils/logger');
 const databaseManager = require('../bdd/DatabaseManager');
+const { CAPABILITIES, capabilityNames, negotiate, hasCapability } = require('./protocol');
+const { encodeFrame, isEncoded, decodeFrame } = require('./frame-codec');
+const AdmissionController = require('./admission-controller');
+const BoundedCache = require('../utils/BoundedCache');
+
+/**
+ * Trames d'état numérotées par le firmware (capacité STATE_SEQUENCE)
+ * @constant {Set<string>}
+ */
+const STATE_FRAMES = new Set([
+  'telemetry',
+  'heartbeat',
+  'command_response',
+  'timeline_status',
+  'estop_event',
+]);
+
+/**
+ * Suivi des séquences d'état par module
+ * La dernière position survit aux reconnexions ; un trou déclenche au plus une demande
+ * de resynchronisation par resyncMinIntervalMs
+ * @constant {Object}
+ */
+const STATE_SEQUENCE = {
+  maxModules: 10000,
+  ttlMs: 60 * 60 * 1000,
+  resyncMinIntervalMs: 5000,
+};
+
+/**
+ * Regroupement de messages dans une trame (capacité BATCHING)
+ * Une trame envoyée ne dépasse pas le message maximum accepté par le firmware
+ * (RX_PAYLOAD_MAX) ; une trame reçue ne porte pas plus de maxMessages messages
+ * @constant {Object}
+ */
+const BATCHING = {
+  maxFrameBytes: 1024,
+  maxMessages: 64,
+};
+
+/**
+ * Début de l'enveloppe {"type":"batch","messages":[...]} ; la fin est "]}"
+ * @constant {string}
+ */
+const BATCH_PREFIX = '{"type":"batch","messages":[';
+
+/**
+ * Passation des sessions à un nouveau processus serveur (capacité SESSION_RESUME)
+ * Le processus sortant attend au plus drainTimeoutMs la réponse des commandes en vol,
+ * puis remet à chaque module un ticket à usage unique accepté ticketTtlMs par le
+ * processus entrant ; les reconnexions sont étalées sur reconnectSpreadMs
+ * @constant {Object}
+ */
+const HANDOVER = {
+  drainTimeoutMs: 3000,
+  drainPollMs: 20,
+  ticketTtlMs: 30000,
+  ticketBytes: 18,
+  reconnectSpreadMs: 250,
+  maxSessions: 10000,
+};
+
+/**
+ * Commandes encore transmises pendant drainCommands : l'arrêt d'urgence et sa levée
+ * n'attendent pas le processus suivant
+ * @constant {Set<string>}
+ */
+const DRAIN_EXEMPT_COMMANDS = new Set(['estop', 'estop_reset']);
 
 /**
  * Serveur WebSocket natif pour modules ESP32
@@ -29,6 +98,33 @@ class ESP32WebSocketServer {
     this.wss = null;
     this.connectedESPs = new Map(); // moduleId -> ws
     this.modulesBySocket = new Map(); // ws -> moduleInfo
+    this.admission = new AdmissionController(() => databaseManager.getPoolStats());
+    this.stateSequences = new BoundedCache({
+      name: 'stateSequences',
+      maxEntries: STATE_SEQUENCE.maxModules,
+      ttlMs: STATE_SEQUENCE.ttlMs,
+    }); // moduleId -> {epoch, seq}
+    this.sequenceStats = { stale: 0, gaps: 0, resyncs: 0 };
+    this.batchStats = { received: 0, sent: 0, coalesced: 0 };
+    this.compressionStats = {
+      framesIn: 0,
+      rawIn: 0,
+      wireIn: 0,
+      framesOut: 0,
+      rawOut: 0,
+      wireOut: 0,
+    };
+    // Coût mesuré sur les modules, remonté dans leur télémétrie
+    this.moduleCodecStats = { tx: 0, txWire: 0, encodeUs: 0, rx: 0, rxWire: 0, decodeUs: 0 };
+    this.draining = false;
+    this.lastCommandId = 0; // Identifiant des commandes, renvoyé par le module dans sa réponse
+    this.resumableSessions = new BoundedCache({
+      name: 'resumableSessions',
+      maxEntries: HANDOVER.maxSessions,
+      ttlMs: HANDOVER.ticketTtlMs,
+    }); // moduleId -> {ticket, moduleAuth, moduleType, handedOverAt}
+    this.handoverStats = { exported: 0, resumed: 0, rejected: 0, totalGapMs: 0, maxGapMs: 0 };
+    this.stopLatches = new Map(); // moduleId du bouton enfoncé -> {userId, sequence, modules: Set}
   }
 
   /**
@@ -42,6 +138,8 @@ class ESP32WebSocketServer {
       path: '/esp32',
     });
 
+    this.admission.start();
+
     Logger.esp.info('🔌 ESP32 WebSocket Server initialized on path /esp32');
 
     this.wss.on('connection', (ws, req) => {
@@ -63,6 +161,8 @@ class ESP32WebSocketServer {
    */
   handleESPConnection(ws, req) {
     const clientIP = req.socket.remoteAddress;
+
+    // Admission décidée à module_identify : une reprise par ticket ne doit pas être différée
     Logger.esp.info(`🤖 New ESP32 connection from ${clientIP}`);
 
     if (req.socket.setKeepAlive) {
@@ -90,7 +190,7 @@ class ESP32WebSocketServer {
 
     ws.on('message', async data => {
       try {
-        const message = JSON.parse(data.toString());
+        const message = JSON.parse(this.decodeMessage(ws, data));
         await this.handleESPMessage(ws, message);
       } catch (error) {
         Logger.esp.error('❌ Invalid JSON from ESP32:', error);
@@ -100,6 +200,7 @@ class ESP32WebSocketServer {
 
     ws.on('close', (code, reason) => {
       clearTimeout(identTimeout);
+      this.settleAuth(ws);
       this.handleESPDisconnection(ws, code, reason);
     });
 
@@ -127,6 +228,24 @@ class ESP32WebSocketServer {
 
     Logger.esp.debug(`[RX ESP32] ${ws.moduleId || 'unidentified'} -> ${type}`);
 
+    // Enveloppe multi-messages : chaque message suit le chemin d'un message reçu seul
+    if (type === 'batch') {
+      await this.handleBatch(ws, message);
+      return;
+    }
+
+    // Doublons et trames périmées écartés avant le délestage : une trame délestée reste
+    // reçue et ne doit pas passer pour un trou à la suivante
+    if (STATE_FRAMES.has(type) && !this.acceptStateSequence(ws, message)) {
+      return;
+    }
+
+    // Délestage des trames de faible priorité ; les commandes passent toujours
+    if (this.admission.shouldShed(type)) {
+      Logger.esp.debug(`🚦 ${type} from ${ws.moduleId} shed (server overloaded)`);
+      return;
+    }
+
     switch (type) {
       case 'module_identify':
         await this.handleAuthentication(ws, message);
@@ -144,6 +263,14 @@ class ESP32WebSocketServer {
         await this.handleCommandResponse(ws, message);
         break;
 
+      case 'timeline_status':
+        this.handleTimelineStatus(ws, message);
+        break;
+
+      case 'estop_event':
+        this.handleEstopEvent(ws, message);
+        break;
+
       case 'pong':
         if (ws.pingTimeout) {
           clearTimeout(ws.pingTimeout);
@@ -157,6 +284,37 @@ class ESP32WebSocketServer {
     }
   }
 
+  /**
+   * Traite une trame multi-messages d'un ESP32
+   * Les messages sont traités dans l'ordre d'émission ; une enveloppe imbriquée est ignorée
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {Object} message - Enveloppe reçue
+   * @param {Array<Object>} message.messages - Messages regroupés
+   * @returns {Promise<void>}
+   * @private
+   */
+  async handleBatch(ws, message) {
+    const { messages } = message;
+
+    // Le firmware ne regroupe qu'après une authentification ayant retenu la capacité
+    if (!ws.moduleId || !hasCapability(ws, CAPABILITIES.BATCHING)) {
+      Logger.esp.warn(`🚨 Unexpected batch from ${ws.moduleId || 'unidentified'}`);
+      return;
+    }
+
+    if (!Array.isArray(messages) || messages.length > BATCHING.maxMessages) {
+      Logger.esp.warn(`🚨 Invalid batch from ${ws.moduleId}`, { size: messages?.length });
+      return;
+    }
+
+    this.batchStats.received++;
+    for (const entry of messages) {
+      if (entry && typeof entry === 'object' && entry.type !== 'batch') {
+        await this.handleESPMessage(ws, entry);
+      }
+    }
+  }
+
   /**
    * Gère l'authentification d'un module ESP32
    * Vérifie les identifiants et enregistre le module connecté
@@ -164,11 +322,72 @@ class ESP32WebSocketServer {
    * @param {Object} message - Message d'identification
    * @param {string} message.moduleId - ID du module
    * @param {string} message.password - Mot de passe du module
+   * @param {number} [message.protocolVersion] - Version du protocole du firmware
+   * @param {number} [message.capabilities] - Masque des capacités du firmware
    * @returns {Promise<void>}
    * @throws {Error} Si authentification échouée
    * @private
    */
   async handleAuthentication(ws, message) {
+    // Reprise par ticket toujours admise : identité déjà vérifiée, sans bcrypt ni requête MySQL
+    const resumed = this.takeResumableSession(message.moduleId, message.ticket);
+    if (!resumed && !this.admitAuthentication(ws, message.moduleId)) return;
+
+    try {
+      await this.authenticate(ws, message, resumed);
+    } finally {
+      this.settleAuth(ws);
+    }
+  }
+
+  /**
+   * Admet une authentification complète, ou la diffère sous surcharge
+   * Le module reçoit un délai de reconnexion plutôt qu'une session refusée
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {string} [moduleId] - ID annoncé par le module
+   * @returns {boolean} True si l'authentification peut commencer
+   * @private
+   */
+  admitAuthentication(ws, moduleId) {
+    const admission = this.admission.tryAdmit();
+    if (!admission.admitted) {
+      Logger.esp.warn(`🚦 ESP32 session ${moduleId || 'unidentified'} deferred`, {
+        retryAfterMs: admission.retryAfterMs,
+      });
+      this.sendToESP(ws, { type: 'retry_later', retryAfterMs: admission.retryAfterMs });
+      ws.close(1013, 'Try again later');
+      return false;
+    }
+    ws.pendingAuth = true;
+    return true;
+  }
+
+  /**
+   * Libère la place d'authentification en cours réservée à l'admission
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @returns {void}
+   * @private
+   */
+  settleAuth(ws) {
+    if (ws.pendingAuth) {
+      ws.pendingAuth = false;
+      this.admission.authSettled();
+    }
+  }
+
+  /**
+   * Vérifie les identifiants, négocie le protocole et enregistre le module
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {Object} message - Message d'identification
+   * @param {Object|null} [resumed] - Session reprise par ticket (par défaut, ticket du message)
+   * @returns {Promise<void>}
+   * @private
+   */
+  async authenticate(
+    ws,
+    message,
+    resumed = this.takeResumableSession(message.moduleId, message.ticket)
+  ) {
     const { moduleId, password, moduleType, uptime, position } = message;
 
     if (!moduleId || !password) {
@@ -178,8 +397,11 @@ class ESP32WebSocketServer {
     }
 
     try {
-      // Validation sécurisée via DatabaseManager
-      const moduleAuth = await databaseManager.modules.validateModuleAuth(moduleId, password);
+      // Reprise après passation : l'identité a déjà été vérifiée par le processus précédent,
+      // sinon validation sécurisée via DatabaseManager
+      const moduleAuth = resumed
+        ? resumed.moduleAuth
+        : await databaseManager.modules.validateModuleAuth(moduleId, password);
 
       if (!moduleAuth) {
         Logger.esp.warn(`🚨 ESP32 authentication failed: ${moduleId}`);
@@ -197,11 +419,16 @@ class ESP32WebSocketServer {
       ws.moduleId = moduleId;
       ws.moduleAuth = moduleAuth;
       ws.moduleType = moduleType || 'Unknown';
+      ws.inFlightCommands = new Map(); // id de commande -> {command, sentAt}
+      // ws.protocol est le sous-protocole WebSocket (lecture seule) : négociation à part
+      ws.negotiated = negotiate(message);
+      this.resetStateSequence(ws, message);
 
       const moduleInfo = {
         moduleId,
         moduleType: ws.moduleType,
         userId: moduleAuth.userId,
+        protocol: ws.negotiated,
         connectedAt: new Date(),
         authenticated: true,
       };
@@ -224,19 +451,99 @@ class ESP32WebSocketServer {
         type: 'connected',
         status: 'authenticated',
         initialState: { uptime, position },
+        protocol: ws.negotiated,
+        resumed: Boolean(resumed),
       });
 
+      if (resumed) this.recordResume(moduleId, resumed);
       await databaseManager.modules.updateStatus(moduleId, 'online');
 
       this.startCustomPing(ws);
 
-      Logger.esp.info(`✅ ESP32 authenticated: ${moduleId} (${ws.moduleType})`);
+      Logger.esp.info(
+        `✅ ESP32 authenticated: ${moduleId} (${ws.moduleType}, protocol v${ws.negotiated.version})`,
+        { capabilities: capabilityNames(ws.negotiated.capabilities) }
+      );
     } catch (error) {
       Logger.esp.error('❌ ESP32 authentication error:', error);
       ws.close(1011, 'Server error');
     }
   }
 
+  /**
+   * Repart de la position annoncée par le module dans module_identify
+   * Les trames perdues pendant la coupure ne comptent pas comme un trou : le module
+   * renvoie son état complet juste après l'authentification
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {Object} message - Message d'identification ({epoch, seq})
+   * @returns {void}
+   * @private
+   */
+  resetStateSequence(ws, message) {
+    const { epoch, seq } = message;
+    if (!hasCapability(ws, CAPABILITIES.STATE_SEQUENCE)) return;
+
+    if (Number.isInteger(epoch) && Number.isInteger(seq)) {
+      this.stateSequences.set(ws.moduleId, { epoch, seq });
+    } else {
+      this.stateSequences.delete(ws.moduleId);
+    }
+  }
+
+  /**
+   * Vérifie la séquence d'une trame d'état en O(1)
+   * Une trame d'une époque antérieure, ou de séquence déjà vue, est écartée ; un saut de
+   * séquence est accepté (les trames portent un état complet) et déclenche une demande
+   * de resynchronisation
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {Object} message - Trame d'état ({epoch, seq} si numérotée)
+   * @returns {boolean} True si la trame doit être traitée
+   * @private
+   */
+  acceptStateSequence(ws, message) {
+    const { epoch, seq } = message;
+    if (!ws.moduleId || !Number.isInteger(epoch) || !Number.isInteger(seq)) return true;
+
+    const last = this.stateSequences.get(ws.moduleId);
+    if (last && (epoch < last.epoch || (epoch === last.epoch && seq <= last.seq))) {
+      this.sequenceStats.stale++;
+      Logger.esp.debug(`🔢 Stale ${message.type} from ${ws.moduleId} dropped`, {
+        epoch,
+        seq,
+        last,
+      });
+      return false;
+    }
+
+    const gap = last && epoch === last.epoch && seq > last.seq + 1;
+    this.stateSequences.set(ws.moduleId, { epoch, seq });
+
+    if (gap) {
+      this.sequenceStats.gaps++;
+      this.requestResync(ws, seq - last.seq - 1);
+    }
+    return true;
+  }
+
+  /**
+   * Demande au module de renvoyer son état complet après un trou de séquence
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {number} missing - Nombre de trames manquantes
+   * @returns {void}
+   * @private
+   */
+  requestResync(ws, missing) {
+    const now = Date.now();
+    if (now - (ws.lastResyncAt || 0) < STATE_SEQUENCE.resyncMinIntervalMs) return;
+    ws.lastResyncAt = now;
+
+    this.sequenceStats.resyncs++;
+    Logger.esp.warn(
+      `🔁 ${missing} state frame(s) missing from ${ws.moduleId} - resync requested`
+    );
+    this.sendToESP(ws, { type: 'resync', missing });
+  }
+
   /**
    * Traite les données de télémétrie d'un module
    * Met à jour la base de données et diffuse aux clients connectés
@@ -244,6 +551,7 @@ class ESP32WebSocketServer {
    * @param {Object} message - Données de télémétrie
    * @param {number} [message.position] - Position du module
    * @param {Object} [message.sensors] - Données des capteurs
+   * @param {Object} [message.summary] - Résumés statistiques de l'intervalle (RSSI, heap, loop)
    * @returns {Promise<void>}
    * @private
    */
@@ -256,14 +564,22 @@ class ESP32WebSocketServer {
 
     Logger.esp.info(`📊 [TELEMETRY] Received from ${ws.moduleId}`);
 
-    const { uptime, position, status } = message;
+    const { uptime, position, status, summary, estop, codec } = message;
     const telemetryData = {
       uptime,
       position,
       status,
+      estop: typeof estop === 'boolean' ? estop : undefined,
+      stats: hasCapability(ws, CAPABILITIES.TELEMETRY_SUMMARY)
+        ? this.realTimeAPI?.modules?.recordTelemetrySummary(ws.moduleId, summary) || undefined
+        : undefined,
       timestamp: new Date(),
     };
 
+    if (codec && hasCapability(ws, CAPABILITIES.COMPRESSION)) {
+      this.recordModuleCodec(codec);
+    }
+
     Logger.esp.info(`📊 [TELEMETRY] Data: ${JSON.stringify(telemetryData)}`);
 
     if (this.realTimeAPI?.events) {
@@ -309,15 +625,24 @@ class ESP32WebSocketServer {
    * @param {WebSocket} ws - Socket WebSocket ESP32
    * @param {Object} message - Réponse de commande
    * @param {string} message.command - Commande exécutée
-   * @param {string} message.status - Statut d'exécution (success/error)
+   * @param {string} message.status - Statut (success/unknown_command/expired/queue_full/preempted)
    * @param {number} [message.position] - Position après exécution
+   * @param {number} [message.speed] - Vitesse atteinte (%, module de vitesse)
+   * @param {number} [message.targetSpeed] - Consigne de vitesse (%)
+   * @param {Object} [message.tracking] - Écart de suivi de la rampe en ‰ ({n, meanPm, maxPm...})
+   * @param {number} [message.queueDepth] - Commandes encore en file côté module
+   * @param {number} [message.durationMs] - Durée réelle du mouvement
+   * @param {number} [message.requestedMs] - Fenêtre de durée demandée
+   * @param {number} [message.id] - Identifiant de la commande (absent : rapport spontané)
    * @returns {Promise<void>}
    * @private
    */
   async handleCommandResponse(ws, message) {
     if (!ws.moduleId) return;
+    if (message.id !== undefined) ws.inFlightCommands?.delete(message.id);
 
-    const { command, status, position } = message;
+    const { command, status, position, queueDepth, durationMs, requestedMs } = message;
+    const { speed, targetSpeed, tracking } = message;
 
     // Transmettre la réponse aux clients web
     if (this.realTimeAPI?.events) {
@@ -326,11 +651,158 @@ class ESP32WebSocketServer {
         command,
         status,
         position,
+        queueDepth,
+        durationMs,
+        requestedMs,
+        speed,
+        targetSpeed,
+        tracking,
+        timestamp: new Date(),
+      });
+    }
+
+    if (status === 'expired' || status === 'queue_full') {
+      Logger.esp.warn(`⌛ Command ${command} dropped by ${ws.moduleId}: ${status}`, {
+        queueDepth,
+      });
+      return;
+    }
+
+    const timing = Number.isFinite(durationMs) ? ` (${durationMs} ms)` : '';
+    Logger.esp.info(`✅ Command response from ${ws.moduleId}: ${command} -> ${status}${timing}`);
+
+    // Écart de suivi d'une rampe de vitesse, en pour mille de la pleine vitesse
+    if (tracking?.n > 0) {
+      Logger.esp.info(`📈 Ramp tracking on ${ws.moduleId}: ${speed}% / ${targetSpeed}%`, tracking);
+    }
+  }
+
+  /**
+   * Gère les retours du firmware sur les programmes de timeline
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {Object} message - Statut de timeline
+   * @param {string} message.status - loaded/rejected/playing/finished/stopped
+   * @param {string} [message.reason] - Cause d'un rejet (bad_crc, bad_version, wrong_module...)
+   * @param {number} [message.crc] - CRC du programme concerné
+   * @param {number} [message.lateMs] - Retard maximum d'un pas pendant la lecture
+   * @returns {void}
+   * @private
+   */
+  handleTimelineStatus(ws, message) {
+    if (!ws.moduleId) return;
+
+    const { status, reason, crc, steps, lateMs } = message;
+
+    if (this.realTimeAPI?.events) {
+      this.realTimeAPI.events.broadcast('module_timeline_status', {
+        moduleId: ws.moduleId,
+        status,
+        reason,
+        crc,
+        steps,
+        lateMs,
+        timestamp: new Date(),
+      });
+    }
+
+    if (status === 'rejected') {
+      Logger.esp.warn(`🎬 Timeline rejected by ${ws.moduleId}: ${reason}`, { crc });
+      return;
+    }
+
+    Logger.esp.info(`🎬 Timeline ${status} on ${ws.moduleId}`, { crc, steps, lateMs });
+  }
+
+  /**
+   * Gère les événements d'un bouton d'arrêt d'urgence
+   * L'arrêt lui-même passe par les trames LAN signées ; le serveur ne fait que compléter :
+   * les modules du même propriétaire qui n'ont pas acquitté reçoivent la commande estop
+   * (voie lente). Le réarmement du bouton ne lève (estop_reset) que les modules verrouillés
+   * par son propre déclenchement, et aucun de ceux qu'un autre bouton enfoncé tient encore.
+   * @param {WebSocket} ws - Socket WebSocket du bouton
+   * @param {Object} message - Événement d'arrêt
+   * @param {string} message.state - triggered/released
+   * @param {number} message.sequence - Numéro du déclenchement
+   * @param {string} [message.source] - button/command
+   * @param {Array<Object>} [message.acks] - Acquittements reçus ({moduleId, latencyUs, handleUs})
+   * @param {number} [message.worstUs] - Pire latence bouton -> acquittement de ce déclenchement
+   * @returns {void}
+   * @private
+   */
+  handleEstopEvent(ws, message) {
+    const buttonInfo = this.modulesBySocket.get(ws);
+    if (!buttonInfo) return;
+
+    const { state, sequence, source, worstUs, worstEverUs } = message;
+    const acks = Array.isArray(message.acks) ? message.acks : [];
+    const acked = new Set(acks.map(ack => ack.moduleId));
+
+    // Modules connectés du même propriétaire, hors boutons (chacun tient son propre verrou)
+    const targets = [];
+    for (const info of this.modulesBySocket.values()) {
+      if (info.userId === buttonInfo.userId && info.moduleType !== 'estop-button') {
+        targets.push(info.moduleId);
+      }
+    }
+
+    let fallback = [];
+    let released = [];
+    if (state === 'triggered') {
+      fallback = targets.filter(moduleId => !acked.has(moduleId));
+      fallback.forEach(moduleId => this.sendCommandToESP(moduleId, 'estop'));
+
+      // Verrouillés par ce déclenchement : par la trame LAN (acquittés) ou par la commande estop
+      const latch = this.stopLatches.get(ws.moduleId);
+      const modules = new Set(latch?.modules);
+      targets.forEach(moduleId => modules.add(moduleId));
+      this.stopLatches.set(ws.moduleId, { userId: buttonInfo.userId, sequence, modules });
+
+      Logger.esp.warn(`🛑 Emergency stop #${sequence} from ${ws.moduleId} (${source})`, {
+        acks: acks.length,
+        worstUs,
+        worstEverUs,
+        fallback,
+      });
+    } else if (state === 'released') {
+      released = this.releaseStopLatch(ws.moduleId, buttonInfo.userId);
+      released.forEach(moduleId => this.sendCommandToESP(moduleId, 'estop_reset'));
+      Logger.esp.info(`🔓 Emergency stop released by ${ws.moduleId}`, { modules: released.length });
+    }
+
+    if (this.realTimeAPI?.events) {
+      this.realTimeAPI.events.broadcast('module_estop', {
+        moduleId: ws.moduleId,
+        state,
+        sequence,
+        source,
+        acks,
+        worstUs,
+        fallback,
+        released,
         timestamp: new Date(),
       });
     }
+  }
 
-    Logger.esp.info(`✅ Command response from ${ws.moduleId}: ${command} -> ${status}`);
+  /**
+   * Oublie le verrou d'un bouton réarmé et liste les modules à déverrouiller
+   * Un module arrêté aussi par un autre bouton du même propriétaire, encore enfoncé,
+   * reste verrouillé jusqu'au réarmement de ce dernier.
+   * @param {string} buttonId - ID du bouton réarmé
+   * @param {number} userId - Propriétaire du bouton
+   * @returns {Array<string>} Modules verrouillés par ce bouton seul (vide sans déclenchement connu)
+   * @private
+   */
+  releaseStopLatch(buttonId, userId) {
+    const latch = this.stopLatches.get(buttonId);
+    this.stopLatches.delete(buttonId);
+    if (!latch) return [];
+
+    const held = new Set();
+    for (const other of this.stopLatches.values()) {
+      if (other.userId === userId) other.modules.forEach(moduleId => held.add(moduleId));
+    }
+    return [...latch.modules].filter(moduleId => !held.has(moduleId));
   }
 
   /**
@@ -364,6 +836,12 @@ class ESP32WebSocketServer {
       ws.pingTimeout = null;
     }
 
+    // Session passée au processus suivant : le module y reste en ligne
+    if (ws.handedOver) {
+      Logger.esp.info(`🔀 ESP32 handed over: ${moduleId}`);
+      return;
+    }
+
     if (this.realTimeAPI?.modules) {
       const pseudoSocket = { id: `esp32-${moduleId}`, moduleId };
       this.realTimeAPI.modules.unregisterESP(pseudoSocket);
@@ -380,7 +858,9 @@ class ESP32WebSocketServer {
    * @param {string} moduleId - ID du module ESP32 cible
    * @param {string} command - Commande à exécuter
    * @param {Object} [params={}] - Paramètres de la commande
-   * @returns {boolean} True si envoyé avec succès, false sinon
+   * @param {number} [params.speed] - Vitesse de mouvement (1-100)
+   * @param {number} [params.durationMs] - Fenêtre de durée du mouvement (ou params.duration en s)
+   * @returns {boolean} True si envoyé avec succès, false sinon (module absent, passation en cours)
    * @public
    */
   sendCommandToESP(moduleId, command, params = {}) {
@@ -391,33 +871,357 @@ class ESP32WebSocketServer {
       return false;
     }
 
+    // Passation en cours : le processus suivant reprend les commandes, sauf l'arrêt d'urgence
+    if (this.draining && !DRAIN_EXEMPT_COMMANDS.has(command)) {
+      Logger.esp.warn(`🔀 Command ${command} to ${moduleId} refused: server handing over`);
+      return false;
+    }
+
+    this.lastCommandId = (this.lastCommandId % 0xffffffff) + 1;
+    const id = this.lastCommandId;
     const message = {
       type: 'command',
       data: {
         command,
         ...params,
+        id,
       },
       timestamp: new Date().toISOString(),
     };
 
     this.sendToESP(ws, message);
+    ws.inFlightCommands?.set(id, { command, sentAt: Date.now() });
     Logger.esp.info(`📤 Command sent to ${moduleId}: ${command}`);
     return true;
   }
 
+  /**
+   * Charge un programme de timeline compilé dans un ESP32 (trame binaire)
+   * Le module valide le programme et répond par un timeline_status
+   * @param {string} moduleId - ID du module ESP32 cible
+   * @param {Buffer} program - Programme produit par TimelineCompiler
+   * @returns {boolean} True si envoyé, false si module absent ou sans la capacité
+   * @public
+   */
+  loadTimeline(moduleId, program) {
+    const ws = this.connectedESPs.get(moduleId);
+
+    if (!ws || ws.readyState !== WebSocket.OPEN) {
+      Logger.esp.warn(`❌ Cannot load timeline on ${moduleId}: not connected`);
+      return false;
+    }
+
+    if (!hasCapability(ws, CAPABILITIES.TIMELINE_BYTECODE)) {
+      Logger.esp.warn(`❌ Cannot load timeline on ${moduleId}: firmware without bytecode support`);
+      return false;
+    }
+
+    // Messages JSON en attente d'abord : l'ordre d'émission est conservé
+    this.flushOutbox(ws);
+    ws.send(program, { binary: true });
+    Logger.esp.debug(`[TX ESP32] -> ${moduleId}: timeline program (${program.length} bytes)`);
+    return true;
+  }
+
   /**
    * Envoie un message JSON à un ESP32
-   * Vérifie l'état de la connexion avant l'envoi
+   * Vérifie l'état de la connexion avant l'envoi. Si le module accepte les trames
+   * multi-messages, le message est mis en attente jusqu'à la fin du tour de boucle
+   * et regroupé avec les autres messages émis vers ce module entre-temps
    * @param {WebSocket} ws - Socket WebSocket ESP32
    * @param {Object} message - Message JSON à envoyer
    * @returns {void}
    * @private
    */
   sendToESP(ws, message) {
-    if (ws.readyState === WebSocket.OPEN) {
-      ws.send(JSON.stringify(message));
-      Logger.esp.debug(`[TX ESP32] -> ${ws.moduleId || 'unidentified'}: ${message.type}`);
+    if (ws.readyState !== WebSocket.OPEN) return;
+
+    Logger.esp.debug(`[TX ESP32] -> ${ws.moduleId || 'unidentified'}: ${message.type}`);
+
+    if (!hasCapability(ws, CAPABILITIES.BATCHING)) {
+      this.transmit(ws, JSON.stringify(message));
+      return;
+    }
+
+    if (!ws.outbox) {
+      ws.outbox = [];
+      setImmediate(() => this.flushOutbox(ws));
+    }
+    ws.outbox.push(JSON.stringify(message));
+  }
+
+  /**
+   * Envoie les messages en attente d'un ESP32
+   * Un message seul part tel quel ; plusieurs messages partent dans des enveloppes batch
+   * d'au plus BATCHING.maxFrameBytes octets, dans l'ordre d'émission
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @returns {void}
+   * @private
+   */
+  flushOutbox(ws) {
+    const outbox = ws.outbox;
+    if (!outbox) return;
+    ws.outbox = null;
+    if (ws.readyState !== WebSocket.OPEN) return;
+
+    const envelopeBytes = BATCH_PREFIX.length + 2;
+    let frame = [];
+    let frameBytes = envelopeBytes;
+
+    for (const json of outbox) {
+      const bytes = Buffer.byteLength(json);
+      // + 1 : virgule de séparation
+      if (frame.length > 0 && frameBytes + 1 + bytes > BATCHING.maxFrameBytes) {
+        this.sendFrame(ws, frame);
+        frame = [];
+        frameBytes = envelopeBytes;
+      }
+      frameBytes += frame.length > 0 ? bytes + 1 : bytes;
+      frame.push(json);
+    }
+
+    if (frame.length > 0) this.sendFrame(ws, frame);
+  }
+
+  /**
+   * Envoie une trame de messages déjà sérialisés
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {Array<string>} frame - Messages JSON sérialisés
+   * @returns {void}
+   * @private
+   */
+  sendFrame(ws, frame) {
+    if (frame.length === 1) {
+      this.transmit(ws, frame[0]);
+      return;
+    }
+
+    this.transmit(ws, `${BATCH_PREFIX}${frame.join(',')}]}`);
+    this.batchStats.sent++;
+    this.batchStats.coalesced += frame.length;
+    Logger.esp.debug(`[TX ESP32] -> ${ws.moduleId}: batch of ${frame.length} messages`);
+  }
+
+  /**
+   * Écrit une trame JSON sur la socket, compressée si le module a retenu COMPRESSION
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {string} json - Message ou enveloppe sérialisé
+   * @returns {void}
+   * @private
+   */
+  transmit(ws, json) {
+    const frame = hasCapability(ws, CAPABILITIES.COMPRESSION) ? encodeFrame(json) : null;
+    if (!frame) {
+      ws.send(json);
+      return;
     }
+
+    // La trame compressée reste du texte UTF-8 : envoyée en trame texte
+    ws.send(frame, { binary: false });
+    this.compressionStats.framesOut++;
+    this.compressionStats.rawOut += Buffer.byteLength(json);
+    this.compressionStats.wireOut += frame.length;
+  }
+
+  /**
+   * Décode une trame texte reçue d'un ESP32
+   * @param {WebSocket} ws - Socket WebSocket ESP32
+   * @param {Buffer} data - Trame reçue
+   * @returns {string} Message JSON
+   * @throws {Error} Si la trame compressée contient un code inconnu
+   * @private
+   */
+  decodeMessage(ws, data) {
+    if (!isEncoded(data) || !hasCapability(ws, CAPABILITIES.COMPRESSION)) {
+      return data.toString();
+    }
+
+    const json = decodeFrame(data);
+    this.compressionStats.framesIn++;
+    this.compressionStats.rawIn += Buffer.byteLength(json);
+    this.compressionStats.wireIn += data.length;
+    return json;
+  }
+
+  /**
+   * Cumule le coût de compression mesuré par un module sur son intervalle de télémétrie
+   * @param {Object} codec - {tx, txWire, encodeUs, rx, rxWire, decodeUs}
+   * @returns {void}
+   * @private
+   */
+  recordModuleCodec(codec) {
+    for (const key of Object.keys(this.moduleCodecStats)) {
+      const value = Number(codec[key]);
+      if (Number.isFinite(value) && value >= 0) this.moduleCodecStats[key] += value;
+    }
+  }
+
+  /**
+   * Statistiques de compression : taux côté serveur et coût par Ko mesuré sur les modules
+   * @returns {Object} Compteurs, ratios (octets transmis / octets JSON) et µs par Ko
+   * @private
+   */
+  getCompressionStats() {
+    const server = this.compressionStats;
+    const modules = this.moduleCodecStats;
+    const ratio = (wire, raw) => (raw > 0 ? Math.round((wire / raw) * 1000) / 1000 : null);
+    const usPerKB = (us, raw) => (raw > 0 ? Math.round((us * 1024) / raw) : null);
+
+    return {
+      ...server,
+      ratioIn: ratio(server.wireIn, server.rawIn),
+      ratioOut: ratio(server.wireOut, server.rawOut),
+      modules: {
+        ...modules,
+        ratioTx: ratio(modules.txWire, modules.tx),
+        ratioRx: ratio(modules.rxWire, modules.rx),
+        encodeUsPerKB: usPerKB(modules.encodeUs, modules.tx),
+        decodeUsPerKB: usPerKB(modules.decodeUs, modules.rx),
+      },
+    };
+  }
+
+  /**
+   * Attend la réponse des commandes envoyées aux modules (processus sortant)
+   * Les nouvelles commandes sont refusées pendant l'attente, hors DRAIN_EXEMPT_COMMANDS ;
+   * une commande est soldée par la réponse portant son id. L'attente est bornée par timeoutMs
+   * @param {number} [timeoutMs=HANDOVER.drainTimeoutMs] - Attente maximum
+   * @returns {Promise<number>} Commandes toujours sans réponse à l'échéance
+   * @public
+   */
+  async drainCommands(timeoutMs = HANDOVER.drainTimeoutMs) {
+    this.draining = true;
+    const startedAt = Date.now();
+    const inFlight = () => {
+      let count = 0;
+      for (const ws of this.connectedESPs.values()) count += ws.inFlightCommands?.size || 0;
+      return count;
+    };
+
+    while (inFlight() > 0 && Date.now() - startedAt < timeoutMs) {
+      await new Promise(resolve => setTimeout(resolve, HANDOVER.drainPollMs));
+    }
+
+    const remaining = inFlight();
+    Logger.esp.info(`🔀 Commands drained in ${Date.now() - startedAt} ms`, { remaining });
+    return remaining;
+  }
+
+  /**
+   * Prépare la passation des sessions au processus suivant (processus sortant)
+   * Chaque module capable de reprise reçoit un ticket à usage unique, qui lui est remis
+   * par releaseSessions et qu'il présente dans son prochain module_identify
+   * @returns {Array<Object>} Sessions {moduleId, ticket, moduleAuth, moduleType, handedOverAt,
+   *   stopLatch}
+   * @public
+   */
+  exportSessions() {
+    const handedOverAt = Date.now();
+    const sessions = [];
+
+    for (const [ws, info] of this.modulesBySocket) {
+      if (!info.authenticated || !hasCapability(ws, CAPABILITIES.SESSION_RESUME)) continue;
+
+      ws.resumeTicket = crypto.randomBytes(HANDOVER.ticketBytes).toString('base64url');
+      // Bouton encore enfoncé : son réarmement sera reçu par le processus suivant
+      const latch = this.stopLatches.get(info.moduleId);
+      sessions.push({
+        moduleId: info.moduleId,
+        ticket: ws.resumeTicket,
+        moduleAuth: ws.moduleAuth,
+        moduleType: ws.moduleType,
+        handedOverAt,
+        stopLatch: latch && { ...latch, modules: [...latch.modules] },
+      });
+    }
+
+    this.handoverStats.exported += sessions.length;
+    Logger.esp.info(`🔀 ${sessions.length} ESP32 session(s) exported for handover`);
+    return sessions;
+  }
+
+  /**
+   * Reçoit les sessions exportées par le processus précédent (processus entrant)
+   * @param {Array<Object>} sessions - Sessions produites par exportSessions
+   * @returns {void}
+   * @public
+   */
+  importSessions(sessions) {
+    for (const session of sessions) {
+      this.resumableSessions.set(session.moduleId, session);
+      if (session.stopLatch) {
+        const { modules, ...latch } = session.stopLatch;
+        this.stopLatches.set(session.moduleId, { ...latch, modules: new Set(modules) });
+      }
+    }
+    Logger.esp.info(`🔀 ${sessions.length} ESP32 session(s) imported from previous process`);
+  }
+
+  /**
+   * Remet leur ticket aux modules et ferme leurs connexions (processus sortant)
+   * Les modules sans ticket (firmware sans SESSION_RESUME) sont fermés normalement et
+   * se réauthentifient après leur délai de reconnexion habituel
+   * @returns {number} Modules fermés
+   * @public
+   */
+  releaseSessions() {
+    let index = 0;
+    const modules = Array.from(this.connectedESPs.values());
+    const spacing = HANDOVER.reconnectSpreadMs / Math.max(1, modules.length);
+
+    for (const ws of modules) {
+      if (ws.resumeTicket) {
+        this.sendToESP(ws, {
+          type: 'handover',
+          ticket: ws.resumeTicket,
+          retryAfterMs: Math.round(index++ * spacing),
+        });
+        this.flushOutbox(ws);
+        ws.handedOver = true;
+      }
+      ws.close(1012, 'Service restart');
+    }
+
+    return modules.length;
+  }
+
+  /**
+   * Consomme le ticket de reprise présenté par un module
+   * Le ticket est à usage unique : toute présentation l'invalide, qu'elle réussisse ou non
+   * @param {string} moduleId - ID du module
+   * @param {string} [ticket] - Ticket reçu dans module_identify
+   * @returns {Object|null} Session reprise, ou null (pas de ticket, inconnu ou expiré)
+   * @private
+   */
+  takeResumableSession(moduleId, ticket) {
+    if (typeof ticket !== 'string' || !ticket) return null;
+
+    const session = this.resumableSessions.get(moduleId);
+    this.resumableSessions.delete(moduleId);
+
+    const expected = Buffer.from(session?.ticket || '');
+    const presented = Buffer.from(ticket);
+    if (expected.length !== presented.length || !crypto.timingSafeEqual(expected, presented)) {
+      this.handoverStats.rejected++;
+      Logger.esp.warn(`🔀 Resume ticket rejected for ${moduleId} - full authentication`);
+      return null;
+    }
+    return session;
+  }
+
+  /**
+   * Comptabilise une reprise de session et l'indisponibilité mesurée pour le module
+   * @param {string} moduleId - ID du module
+   * @param {Object} session - Session reprise
+   * @returns {void}
+   * @private
+   */
+  recordResume(moduleId, session) {
+    const gapMs = Date.now() - session.handedOverAt;
+    this.handoverStats.resumed++;
+    this.handoverStats.totalGapMs += gapMs;
+    this.handoverStats.maxGapMs = Math.max(this.handoverStats.maxGapMs, gapMs);
+    Logger.esp.info(`🔀 ESP32 session resumed: ${moduleId} (${gapMs} ms after handover)`);
   }
 
   /**
@@ -438,14 +1242,35 @@ class ESP32WebSocketServer {
    * @returns {Object} Statistiques des connexions
    * @returns {number} returns.connectedESPs - Nombre d'ESP32 connectés
    * @returns {number} returns.authenticatedModules - Nombre de modules authentifiés
+   * @returns {Object} returns.protocolVersions - Modules par version de protocole négociée
+   * @returns {Object} returns.admission - État du contrôle d'admission (charge, délestage)
    * @public
    */
   getStats() {
+    const protocolVersions = {};
+    for (const info of this.modulesBySocket.values()) {
+      const version = `v${info.protocol?.version ?? 0}`;
+      protocolVersions[version] = (protocolVersions[version] || 0) + 1;
+    }
+
     return {
       connectedESPs: this.connectedESPs.size,
       authenticatedModules: Array.from(this.modulesBySocket.values()).filter(
         info => info.authenticated
       ).length,
+      protocolVersions,
+      admission: this.admission.getStats(),
+      stateSequences: { ...this.sequenceStats, tracked: this.stateSequences.size },
+      batching: { ...this.batchStats },
+      compression: this.getCompressionStats(),
+      handover: {
+        ...this.handoverStats,
+        avgGapMs: this.handoverStats.resumed
+          ? Math.round(this.handoverStats.totalGapMs / this.handoverStats.resumed)
+          : 0,
+        draining: this.draining,
+        pendingResumes: this.resumableSessions.size,
+      },
     };
   }
 
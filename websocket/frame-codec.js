@@ -0,0 +1,280 @@
+/**
+ * Codec de trames ESP32 - Compression par dictionnaire statique partagé
+ *
+ * Les trames du protocole sont courtes et très répétitives (mêmes clés, mêmes types,
+ * mêmes états) : une compression générique par message n'y gagne presque rien, faute
+ * d'historique. Le dictionnaire ci-dessous, embarqué à l'identique dans les firmwares,
+ * remplace les fragments les plus fréquents par un code d'un ou deux octets pris dans
+ * la plage 0x01-0x1F, qu'un JSON sérialisé ne contient jamais brut (caractères de
+ * contrôle toujours échappés).
+ *
+ * La trame compressée reste une trame texte : elle commence par un code, alors qu'un
+ * message JSON ordinaire commence par "{". Seules les trames commençant par l'entrée 0
+ * ({"type":") sont compressées, ce qui rend la distinction non ambiguë.
+ *
+ * Codes : les 27 premières entrées sur un octet (0x01-0x1E hors \t \n \r), les suivantes
+ * sur deux octets (0x1F puis 0x20 + rang). L'ordre des entrées fait partie du format :
+ * toute modification change DICTIONARY_ID et doit être reportée dans les firmwares.
+ *
+ * @module FrameCodec
+ * @description Compression des trames JSON ESP32 par dictionnaire statique (capacité COMPRESSION)
+ */
+
+/**
+ * Identifiant du dictionnaire, annoncé par le module dans module_identify
+ * @constant {number}
+ */
+const DICTIONARY_ID = 1;
+
+/**
+ * Dictionnaire v1, construit à partir des trames du banc (modules et serveur) :
+ * fragments classés par gain (fréquence × longueur), les plus rentables sur un octet
+ * @constant {Array<string>}
+ */
+const DICTIONARY = [
+  // Codes sur un octet
+  '{"type":"',
+  '","password":"',
+  ',"moduleId":"MC-',
+  ',"seq":',
+  ',"queueDepth":',
+  '","uptime":',
+  ',"position":"',
+  ',"status":"',
+  ',"min":',
+  ',"max":',
+  ',"sum":',
+  ',"sq":',
+  ',"h":[[',
+  '],[',
+  ']]}',
+  'telemetry","epoch":',
+  'heartbeat","epoch":',
+  'command_response","epoch":',
+  ',"summary":{"intervalMs":',
+  ',"rssi":{"n":',
+  ',"heap":{"n":',
+  ',"loopUs":{"n":',
+  ',"neg":1',
+  ',"estop":false',
+  '","command":"',
+  'command","data":{"command":"',
+  '},"timestamp":"20',
+
+  // Codes sur deux octets
+  ',"wifiRSSI":',
+  ',"freeHeap":',
+  ',"minFreeHeap":',
+  ',"durationMs":',
+  ',"requestedMs":',
+  ',"codec":{"tx":',
+  ',"txWire":',
+  ',"encodeUs":',
+  ',"rx":',
+  ',"rxWire":',
+  ',"decodeUs":',
+  'timeline_status","epoch":',
+  'estop_event","epoch":',
+  'batch","messages":[',
+  'ping","timestamp":',
+  'connected","status":"authenticated","initialState":{"uptime":',
+  ',"protocol":{"version":',
+  ',"capabilities":',
+  'resync","missing":',
+  'retry_later","retryAfterMs":',
+  'operational"',
+  'left"',
+  'right"',
+  'success"',
+  'expired"',
+  'queue_full"',
+  'estop_latched"',
+  'no_program"',
+  'preempted"',
+  'latched"',
+  'switch_left"',
+  'switch_right"',
+  'get_position"',
+  'get_state"',
+  'get_speed"',
+  'set_speed"',
+  'gradual_change"',
+  'turn_on"',
+  'turn_off"',
+  'blink"',
+  'timeline_play"',
+  'timeline_stop"',
+  'estop_reset"',
+  ',"speed":',
+  ',"targetSpeed":',
+  ',"deadlineMs":',
+  ',"duration":',
+  ',"brightness":',
+  ',"effect":"',
+  ',"reason":"',
+  ',"steps":',
+  ',"crc":',
+  ',"lateMs":',
+  ',"estop":true',
+  ',"stopUs":{"n":',
+  ',"acks":[{"moduleId":"MC-',
+  '},{"moduleId":"MC-',
+  ',"latencyUs":',
+  ',"handleUs":',
+  ',"sequence":',
+  ',"source":"',
+  ',"state":"',
+  ',"duty":',
+  ',"tracking":',
+  ',"worstUs":',
+  ',"worstStopUs":',
+  ',"worstEverUs":',
+];
+
+/**
+ * Octets de code sur un octet, dans l'ordre des entrées
+ * @constant {Array<number>}
+ */
+const SHORT_CODES = [];
+for (let byte = 0x01; byte <= 0x1e; byte++) {
+  if (byte !== 0x09 && byte !== 0x0a && byte !== 0x0d) SHORT_CODES.push(byte);
+}
+
+/**
+ * Préfixe des codes sur deux octets, suivi de 0x20 + rang
+ * @constant {number}
+ */
+const EXTENDED_CODE = 0x1f;
+const EXTENDED_BASE = 0x20;
+
+if (DICTIONARY.length > SHORT_CODES.length + (0x7f - EXTENDED_BASE)) {
+  throw new Error('Frame dictionary exceeds the code space');
+}
+
+const ENTRIES = DICTIONARY.map((text, index) => ({
+  bytes: Buffer.from(text),
+  code: Buffer.from(
+    index < SHORT_CODES.length
+      ? [SHORT_CODES[index]]
+      : [EXTENDED_CODE, EXTENDED_BASE + index - SHORT_CODES.length]
+  ),
+}));
+
+/**
+ * Entrées candidates par premier octet, de la plus longue à la plus courte
+ * @type {Array<Array<Object>>}
+ */
+const CANDIDATES = Array.from({ length: 128 }, () => []);
+for (const entry of ENTRIES) CANDIDATES[entry.bytes[0]].push(entry);
+for (const list of CANDIDATES) list.sort((a, b) => b.bytes.length - a.bytes.length);
+
+/**
+ * Entrée décodée par octet de code (codes sur un octet)
+ * @type {Array<Buffer|undefined>}
+ */
+const SHORT_LOOKUP = new Array(EXTENDED_CODE);
+SHORT_CODES.forEach((byte, index) => {
+  SHORT_LOOKUP[byte] = ENTRIES[index].bytes;
+});
+
+const FIRST_ENTRY = ENTRIES[0].bytes;
+
+/**
+ * Plus longue entrée du dictionnaire présente à une position
+ * @param {Buffer} input - Trame JSON
+ * @param {number} offset - Position examinée
+ * @returns {Object|null} Entrée {bytes, code} ou null
+ * @private
+ */
+function longestMatch(input, offset) {
+  const byte = input[offset];
+  if (byte >= 128) return null;
+
+  for (const entry of CANDIDATES[byte]) {
+    const { bytes } = entry;
+    if (offset + bytes.length > input.length) continue;
+
+    let matched = 1;
+    while (matched < bytes.length && input[offset + matched] === bytes[matched]) matched++;
+    if (matched === bytes.length) return entry;
+  }
+  return null;
+}
+
+/**
+ * Compresse une trame JSON
+ * @param {string} json - Message JSON sérialisé
+ * @returns {Buffer|null} Trame compressée (texte UTF-8), ou null si la trame doit partir
+ *   telle quelle (elle ne commence pas par l'entrée 0 ou contient un octet de contrôle)
+ */
+function encodeFrame(json) {
+  const input = Buffer.from(json);
+  if (!FIRST_ENTRY.equals(input.subarray(0, FIRST_ENTRY.length))) return null;
+
+  // Chaque code est plus court que son entrée : la sortie ne dépasse jamais l'entrée
+  const output = Buffer.allocUnsafe(input.length);
+  let length = 0;
+
+  for (let offset = 0; offset < input.length; ) {
+    const entry = longestMatch(input, offset);
+    if (entry) {
+      length += entry.code.copy(output, length);
+      offset += entry.bytes.length;
+    } else if (input[offset] < 0x20) {
+      return null;
+    } else {
+      output[length++] = input[offset++];
+    }
+  }
+
+  return output.subarray(0, length);
+}
+
+/**
+ * Vérifie si une trame reçue est compressée
+ * @param {Buffer} frame - Trame texte reçue
+ * @returns {boolean} True si la trame commence par un code du dictionnaire
+ */
+function isEncoded(frame) {
+  return frame.length > 0 && frame[0] < 0x20;
+}
+
+/**
+ * Décompresse une trame
+ * @param {Buffer} frame - Trame compressée
+ * @returns {string} Message JSON
+ * @throws {Error} Si la trame contient un code inconnu
+ */
+function decodeFrame(frame) {
+  const chunks = [];
+  let literalStart = 0;
+
+  for (let offset = 0; offset < frame.length; offset++) {
+    const byte = frame[offset];
+    if (byte >= 0x20) continue;
+
+    if (offset > literalStart) chunks.push(frame.subarray(literalStart, offset));
+
+    let entry;
+    if (byte === EXTENDED_CODE) {
+      entry = ENTRIES[SHORT_CODES.length + frame[++offset] - EXTENDED_BASE]?.bytes;
+    } else {
+      entry = SHORT_LOOKUP[byte];
+    }
+    if (!entry) throw new Error(`Unknown frame code 0x${byte.toString(16)} at ${offset}`);
+
+    chunks.push(entry);
+    literalStart = offset + 1;
+  }
+
+  if (literalStart < frame.length) chunks.push(frame.subarray(literalStart));
+  return Buffer.concat(chunks).toString();
+}
+
+module.exports = {
+  DICTIONARY_ID,
+  DICTIONARY,
+  encodeFrame,
+  isEncoded,
+  decodeFrame,
+};
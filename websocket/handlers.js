@@ -10,6 +10,8 @@
 
 const databaseManager = require('../bdd/DatabaseManager');
 const Logger = require('../utils/logger');
+const BoundedCache = require('../utils/BoundedCache');
+const { resolveModuleKind } = require('../utils/TimelineCompiler');
 
 /**
  * Récupère l'instance RealTimeAPI depuis le socket
@@ -26,10 +28,14 @@ function getRealTimeAPI(socket) {
 }
 
 /**
- * Map des modules revendiqués par code utilisateur
- * @type {Map<string, string>} moduleId -> userCode
+ * Modules revendiqués par code utilisateur (cache borné, rafraîchi à chaque connexion web)
+ * @type {BoundedCache} moduleId -> userCode
  */
-const codeByModuleId = new Map();
+const codeByModuleId = new BoundedCache({
+  name: 'codeByModuleId',
+  maxEntries: 10000,
+  ttlMs: 24 * 60 * 60 * 1000,
+}).startPruning(10 * 60 * 1000);
 
 /**
  * Masque les données sensibles pour les logs
@@ -137,10 +143,11 @@ function logTx(socket, event, data, session = null) {
 function broadcastToWebByCode(realTimeAPI, userCode, event, data) {
   if (!realTimeAPI?.events) return;
 
-  const clients = Array.from(realTimeAPI.events.connectedClients.values()).filter(client => {
-    const clientCode = `USER-${client.userId}`;
-    return clientCode === userCode;
-  });
+  // Les codes web sont de la forme USER-<userId> : résolution directe via l'index utilisateur
+  const match = /^USER-(.+)$/.exec(userCode);
+  if (!match) return;
+
+  const clients = realTimeAPI.events.getUserClients(match[1]);
 
   clients.forEach(client => {
     logTx(client.socket, event, data);
@@ -163,9 +170,7 @@ function broadcastToWebByCode(realTimeAPI, userCode, event, data) {
 function getUserSockets(realTimeAPI, userId) {
   if (!realTimeAPI?.events) return [];
 
-  return Array.from(realTimeAPI.events.connectedClients.values()).filter(
-    client => client.userId === userId
-  );
+  return realTimeAPI.events.getUserClients(userId);
 }
 
 /**
@@ -192,7 +197,7 @@ module.exports = function (io, socketWSBridge) {
     });
 
     if (session && session.user_id) {
-      handleClientConnection(socket, session);
+      handleClientConnection(socket, session, true);
     } else {
       Logger.esp.debug(`🔄 Connection without session - waiting for manual auth: ${socket.id}`);
 
@@ -216,7 +221,7 @@ module.exports = function (io, socketWSBridge) {
           `✅ Traitement authentification manuelle pour utilisateur ${data.userId} (${data.userType})`
         );
 
-        handleClientConnection(socket, fakeSession);
+        handleClientConnection(socket, fakeSession, false);
       });
 
       const clientTimeout = setTimeout(() => {
@@ -239,9 +244,11 @@ module.exports = function (io, socketWSBridge) {
    * Enregistre le client, configure les écouteurs et synchronise l'état initial
    * @param {Socket} socket - Socket client Socket.IO
    * @param {Object} session - Session utilisateur
+   * @param {boolean} sessionVerified - True pour une session express, false pour un userId
+   *   déclaré par le client (client:authenticate), exclu des actions sur les modules
    * @returns {Promise<void>}
    */
-  async function handleClientConnection(socket, session) {
+  async function handleClientConnection(socket, session, sessionVerified) {
     const userId = session.user_id;
     const userName = session.nickname || 'User';
     const userCode = session.code || `USER-${userId}`;
@@ -251,7 +258,7 @@ module.exports = function (io, socketWSBridge) {
     const realTimeAPI = getRealTimeAPI(socket);
     const userType = session.is_admin ? 'admin' : 'user';
 
-    socket.userData = { userId, userType, userName };
+    socket.userData = { userId, userType, userName, sessionVerified };
 
     if (realTimeAPI) {
       realTimeAPI.handleClientEvents(socket);
@@ -263,19 +270,12 @@ module.exports = function (io, socketWSBridge) {
 
     socket.on('request_stats', () => {
       const realTimeAPI = getRealTimeAPI(socket);
-      if (realTimeAPI?.events && realTimeAPI?.modules) {
-        const clientStats = realTimeAPI.events.getStats();
-        const moduleStats = realTimeAPI.modules.getConnectionStats();
-
-        const simpleStats = {
-          users: { online: clientStats.uniqueUsers },
-          modules: { online: moduleStats.connectedModules },
-          timestamp: new Date(),
-        };
+      if (realTimeAPI?.events) {
+        const simpleStats = realTimeAPI.events.getSimpleStats();
 
         socket.emit('simple_stats_update', simpleStats);
         Logger.system.debug(
-          `Stats sent to ${socket.id}: ${clientStats.uniqueUsers} users, ${moduleStats.connectedModules} modules`
+          `Stats sent to ${socket.id}: ${simpleStats.users.online} users, ${simpleStats.modules.online} modules`
         );
       }
     });
@@ -298,10 +298,7 @@ module.exports = function (io, socketWSBridge) {
       Logger.activity.debug('Client updating page', { page, socketId: socket.id });
 
       if (realTimeAPI && socket.isRegisteredWithEventsManager) {
-        const client = realTimeAPI.events.connectedClients.get(socket.id);
-        if (client) {
-          client.page = page;
-        }
+        realTimeAPI.events.setClientPage(socket.id, page);
       }
     });
 
@@ -368,6 +365,70 @@ module.exports = function (io, socketWSBridge) {
       }
     });
 
+    socket.on('timeline_play', async sequence => {
+      if (!sessionVerified) {
+        Logger.activity.warn(`🚫 timeline_play refused without session: ${socket.id}`);
+        socket.emit('timeline_play_result', {
+          started: [],
+          skipped: [],
+          error: 'Session requise',
+          timestamp: new Date(),
+        });
+        return;
+      }
+
+      const bridge = io.app?.locals?.socketWSBridge;
+      if (!bridge) {
+        socket.emit('error', { message: 'Service WebSocket indisponible' });
+        return;
+      }
+
+      try {
+        // Seuls les modules de l'utilisateur sont programmés
+        const userModules = await databaseManager.modules.findByUserId(userId);
+        const owned = new Map(userModules.map(m => [m.module_id, m]));
+        const modules = Object.fromEntries(
+          Object.entries(sequence?.modules || {}).filter(([moduleId]) => owned.has(moduleId))
+        );
+
+        const result = bridge.handleWebTimeline(socket, { modules }, moduleId =>
+          resolveModuleKind(owned.get(moduleId).type, moduleId)
+        );
+
+        Logger.activity.info(
+          `🎬 Timeline played by ${userName}: ${result.started.length} module(s) started`
+        );
+        socket.emit('timeline_play_result', { ...result, timestamp: new Date() });
+      } catch (error) {
+        Logger.activity.error('Error playing timeline:', error);
+        socket.emit('timeline_play_result', {
+          started: [],
+          skipped: [],
+          error: error.message,
+          timestamp: new Date(),
+        });
+      }
+    });
+
+    socket.on('timeline_stop', async data => {
+      if (!sessionVerified) {
+        Logger.activity.warn(`🚫 timeline_stop refused without session: ${socket.id}`);
+        return;
+      }
+
+      const bridge = io.app?.locals?.socketWSBridge;
+      if (!bridge) return;
+
+      try {
+        const userModules = await databaseManager.modules.findByUserId(userId);
+        const owned = new Set(userModules.map(m => m.module_id));
+        const requested = Array.isArray(data?.moduleIds) ? data.moduleIds : [...owned];
+        bridge.stopTimeline(requested.filter(moduleId => owned.has(moduleId)));
+      } catch (error) {
+        Logger.activity.error('Error stopping timeline:', error);
+      }
+    });
+
     socket.on('module_claim', data => {
       logRx(socket, 'module_claim', data, session);
       const mid = String(data.moduleId || '').trim();
@@ -388,27 +449,8 @@ module.exports = function (io, socketWSBridge) {
 
   setInterval(() => {
     const realTimeAPI = io.sockets?.server?.app?.locals?.realTimeAPI;
-    if (realTimeAPI?.events && realTimeAPI?.modules) {
-      const clientStats = realTimeAPI.events.getStats();
-      const moduleStats = realTimeAPI.modules.getConnectionStats();
-
-      const currentStats = {
-        users: clientStats.uniqueUsers,
-        modules: moduleStats.connectedModules,
-        clients: clientStats.total,
-        esp: moduleStats.onlineModules,
-      };
-
-      Logger.system.statsIfChanged(
-        `📊 Connected - ${clientStats.uniqueUsers} user(s), ${moduleStats.connectedModules} ESP module(s)`,
-        currentStats
-      );
-
-      Logger.system.debug(
-        `📊 Detailed stats - Users: ${clientStats.uniqueUsers}, Clients: ${clientStats.total}, ESP: ${moduleStats.connectedModules}, Modules DB: ${moduleStats.onlineModules}`
-      );
-    } else {
-      Logger.system.info(`📊 Connected - (APIs unavailable)`);
-    }
+    Logger.system.debug('📊 Cache stats', {
+      caches: [realTimeAPI?.modules?.moduleStates.getStats(), codeByModuleId.getStats()],
+    });
   }, 30000);
 };
@@ -0,0 +1,103 @@
+/**
+ * Protocole ESP32 - Version et capacités négociées
+ *
+ * Registre des capacités optionnelles du protocole modules. Chaque module annonce
+ * sa version et un masque de capacités dans module_identify ; le serveur répond
+ * dans connected avec l'intersection, que les deux côtés utilisent ensuite.
+ * Un firmware ancien (sans ces champs) retombe sur la version 0 sans capacité.
+ *
+ * @module protocol
+ * @description Version du protocole ESP32 et négociation des capacités par module
+ */
+
+const { DICTIONARY_ID } = require('./frame-codec');
+
+/**
+ * Version du protocole implémentée par le serveur
+ * @constant {number}
+ */
+const PROTOCOL_VERSION = 1;
+
+/**
+ * Capacités optionnelles (un bit chacune, valeurs partagées avec le firmware)
+ * @constant {Object}
+ */
+const CAPABILITIES = {
+  COMMAND_QUEUE: 1 << 0, // File de commandes, deadlineMs, statuts expired/queue_full
+  TELEMETRY_SUMMARY: 1 << 1, // Résumés statistiques dans la télémétrie
+  SCHEDULED_COMMANDS: 1 << 2, // Réservé : commandes planifiées
+  BATCHING: 1 << 3, // Plusieurs messages par trame (enveloppe batch)
+  BINARY_FRAMES: 1 << 4, // Réservé : encodage binaire
+  COMPRESSION: 1 << 5, // Trames compressées par dictionnaire statique partagé (frame-codec)
+  MOTION_PARAMS: 1 << 6, // Paramètres speed / durationMs respectés, durée réelle rapportée
+  TIMELINE_BYTECODE: 1 << 7, // Programmes de timeline compilés (trame binaire + timeline_play)
+  ESTOP_FRAMES: 1 << 8, // Trames d'arrêt d'urgence LAN signées (ESP-NOW), événements estop_event
+  STATE_SEQUENCE: 1 << 9, // Trames d'état numérotées (epoch + seq), resync sur trou
+  SESSION_RESUME: 1 << 10, // Reprise de session par ticket après un redémarrage du serveur
+};
+
+/**
+ * Capacités effectivement prises en charge par ce serveur
+ * @constant {number}
+ */
+const SERVER_CAPABILITIES =
+  CAPABILITIES.COMMAND_QUEUE |
+  CAPABILITIES.TELEMETRY_SUMMARY |
+  CAPABILITIES.BATCHING |
+  CAPABILITIES.COMPRESSION |
+  CAPABILITIES.MOTION_PARAMS |
+  CAPABILITIES.TIMELINE_BYTECODE |
+  CAPABILITIES.ESTOP_FRAMES |
+  CAPABILITIES.STATE_SEQUENCE |
+  CAPABILITIES.SESSION_RESUME;
+
+/**
+ * Liste les noms des capacités d'un masque
+ * @param {number} mask - Masque de capacités
+ * @returns {Array<string>} Noms des capacités actives
+ */
+function capabilityNames(mask) {
+  return Object.keys(CAPABILITIES).filter(name => (mask & CAPABILITIES[name]) !== 0);
+}
+
+/**
+ * Négocie le protocole avec un module à partir de son message d'identification
+ * @param {Object} message - Message module_identify
+ * @param {number} [message.protocolVersion] - Version annoncée par le module (0 si absente)
+ * @param {number} [message.capabilities] - Masque des capacités du module (0 si absent)
+ * @param {number} [message.dictionary] - Dictionnaire de compression embarqué par le module
+ * @returns {Object} {version, capabilities} retenus pour la session
+ */
+function negotiate(message) {
+  const moduleVersion = Number.isInteger(message.protocolVersion) ? message.protocolVersion : 0;
+  let moduleCapabilities = Number.isInteger(message.capabilities) ? message.capabilities : 0;
+
+  // Compression retenue seulement si les deux côtés partagent le même dictionnaire
+  if (message.dictionary !== DICTIONARY_ID) {
+    moduleCapabilities &= ~CAPABILITIES.COMPRESSION;
+  }
+
+  return {
+    version: Math.max(0, Math.min(moduleVersion, PROTOCOL_VERSION)),
+    capabilities: (moduleCapabilities & SERVER_CAPABILITIES) >>> 0,
+  };
+}
+
+/**
+ * Vérifie qu'une capacité a été négociée pour une connexion module
+ * @param {WebSocket} ws - Socket WebSocket ESP32
+ * @param {number} capability - Bit de capacité (CAPABILITIES.*)
+ * @returns {boolean} True si les deux côtés la prennent en charge
+ */
+function hasCapability(ws, capability) {
+  return ((ws.negotiated?.capabilities || 0) & capability) !== 0;
+}
+
+module.exports = {
+  PROTOCOL_VERSION,
+  CAPABILITIES,
+  SERVER_CAPABILITIES,
+  capabilityNames,
+  negotiate,
+  hasCapability,
+};
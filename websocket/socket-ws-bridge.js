@@ -9,6 +9,14 @@
  */
 
 const Logger = require('../utils/logger');
+const { compileSequence } = require('../utils/TimelineCompiler');
+
+/**
+ * Délai entre l'envoi de timeline_play et le départ commun des modules
+ * Laisse le temps aux trames d'atteindre chaque module avant le premier pas
+ * @constant {number}
+ */
+const TIMELINE_START_DELAY_MS = 500;
 
 /**
  * Bridge adaptateur entre Socket.IO et WebSocket natif
@@ -85,6 +93,69 @@ class SocketWSBridge {
     }
   }
 
+  /**
+   * Compile une séquence de timeline et la lance sur les modules concernés
+   * Chaque module reçoit son programme puis un timeline_play au départ commun ;
+   * le firmware ne joue le programme que si son CRC correspond.
+   * @param {Socket} socketIOClient - Client Socket.IO émetteur
+   * @param {Object} sequence - Séquence de l'éditeur {modules: {moduleId: [actions]}}
+   * @param {Function} kindOf - (moduleId) => type de timeline du module
+   * @returns {Object} {started: [{moduleId, crc, steps, totalMs}], skipped: [{moduleId, error}]}
+   * @public
+   */
+  handleWebTimeline(socketIOClient, sequence, kindOf) {
+    const { programs, errors } = compileSequence(sequence, kindOf);
+    const started = [];
+    const skipped = [...errors];
+
+    for (const [moduleId, compiled] of programs) {
+      if (!this.esp32Server.loadTimeline(moduleId, compiled.program)) {
+        skipped.push({ moduleId, error: 'Module not connected or without timeline support' });
+        continue;
+      }
+
+      const playing = this.esp32Server.sendCommandToESP(moduleId, 'timeline_play', {
+        crc: compiled.crc,
+        startInMs: TIMELINE_START_DELAY_MS,
+      });
+      if (!playing) {
+        // Refus pendant une passation de serveur, ou module déconnecté depuis le chargement
+        const error = this.esp32Server.draining
+          ? 'Server restarting, try again shortly'
+          : 'Module disconnected before timeline start';
+        skipped.push({ moduleId, error });
+        continue;
+      }
+      started.push({
+        moduleId,
+        crc: compiled.crc,
+        steps: compiled.steps,
+        totalMs: compiled.totalMs,
+      });
+    }
+
+    const userId = socketIOClient.userData?.userId ?? 'unknown';
+    Logger.esp.info(`🎬 Bridge: Timeline from user ${userId} started`, {
+      started: started.length,
+      skipped: skipped.length,
+    });
+
+    return { started, skipped };
+  }
+
+  /**
+   * Arrête la timeline en cours sur une liste de modules
+   * @param {Array<string>} moduleIds - Modules à arrêter
+   * @returns {number} Nombre de modules ayant reçu l'arrêt
+   * @public
+   */
+  stopTimeline(moduleIds) {
+    return moduleIds.filter(moduleId => {
+      if (!this.esp32Server.isESPConnected(moduleId)) return false;
+      return this.esp32Server.sendCommandToESP(moduleId, 'timeline_stop');
+    }).length;
+  }
+
   /**
    * Retransmet un événement ESP32 vers les clients Socket.IO
    * Permet aux événements des modules d'être diffusés aux clients web